@@ -0,0 +1,104 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "util.h"
+
+#include <benchmark/benchmark.h>
+
+#include <windows.h>
+#include <winsock2.h>
+
+#include <exception>
+
+using namespace ClipSock;
+
+namespace {
+
+// Failures are simulated by a call that fails as a reset connection would;
+// this measures the cost of reporting the failure rather than the call:
+BOOL FailCall()
+{
+    SetLastError(WSAECONNRESET);
+    return FALSE;
+}
+
+void VerifyFailure()
+{
+    VERIFY_WIN32(FailCall());
+}
+
+Win32Result<> TryFailure()
+{
+    TRY_WIN32(FailCall());
+    return {};
+}
+
+void BM_VerifyFailure(benchmark::State& State)
+{
+    for (auto _ : State) {
+        try {
+            VerifyFailure();
+        }
+        catch (const std::exception& e) {
+            benchmark::DoNotOptimize(e.what());
+        }
+    }
+}
+
+void BM_TryFailure(benchmark::State& State)
+{
+    for (auto _ : State) {
+        auto Result = TryFailure();
+        benchmark::DoNotOptimize(Result.Error());
+    }
+}
+
+// Failures returned as results are still formatted once reported:
+void BM_TryFailureReported(benchmark::State& State)
+{
+    for (auto _ : State) {
+        if (auto Result = TryFailure(); !Result) {
+            auto upError = GetErrorMessageA(Result.Error());
+            benchmark::DoNotOptimize(upError.get());
+        }
+    }
+}
+
+// Repeated codes are formatted once and looked up thereafter:
+void BM_TryFailureCached(benchmark::State& State)
+{
+    for (auto _ : State) {
+        if (auto Result = TryFailure(); !Result) {
+            benchmark::DoNotOptimize(GetCachedErrorMessageA(Result.Error()));
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_VerifyFailure);
+BENCHMARK(BM_TryFailure);
+BENCHMARK(BM_TryFailureReported);
+BENCHMARK(BM_TryFailureCached);
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "transform.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+using namespace ClipSock;
+
+namespace {
+
+constexpr auto BENCHMARK_SIZE = 65535;
+
+std::string MakeRepeated(std::string_view svPattern)
+{
+    std::string sData;
+    while (sData.size() + svPattern.size() <= BENCHMARK_SIZE) {
+        sData += svPattern;
+    }
+    return sData;
+}
+
+void BM_StripEscapes(benchmark::State& State, std::string sInput)
+{
+    std::string sData;
+    for (auto _ : State) {
+        sData = sInput;
+        benchmark::DoNotOptimize(Transform::StripEscapes(sData.data(), sData.size()));
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations() * sInput.size()));
+}
+
+void BM_StripTrailingWhitespace(benchmark::State& State, std::string sInput)
+{
+    std::string sData;
+    for (auto _ : State) {
+        sData = sInput;
+        benchmark::DoNotOptimize(Transform::StripTrailingWhitespace(sData.data(), sData.size()));
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations() * sInput.size()));
+}
+
+void BM_FindEscape(benchmark::State& State, SIZE_T (*pfnFind)(const CHAR*, SIZE_T))
+{
+    auto sInput = MakeRepeated("clean text without escapes\n");
+    for (auto _ : State) {
+        benchmark::DoNotOptimize(pfnFind(sInput.data(), sInput.size()));
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations() * sInput.size()));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_FindEscape, Scalar, Transform::FindEscapeScalar);
+BENCHMARK_CAPTURE(BM_FindEscape, SSE2, Transform::FindEscapeSSE2);
+
+// Pathological inputs maximize the number of sequences and moves:
+BENCHMARK_CAPTURE(BM_StripEscapes, Clean, MakeRepeated("clean text without escapes\n"));
+BENCHMARK_CAPTURE(BM_StripEscapes, ColorPerChar, MakeRepeated("\x1B[38;5;196mX"));
+BENCHMARK_CAPTURE(BM_StripEscapes, LoneEscapes, MakeRepeated("\x1B\n"));
+BENCHMARK_CAPTURE(BM_StripEscapes, Unterminated, "\x1B]0;" + MakeRepeated("title"));
+BENCHMARK_CAPTURE(BM_StripTrailingWhitespace, Padded, MakeRepeated("x                              \n"));
+BENCHMARK_CAPTURE(BM_StripTrailingWhitespace, Interior, MakeRepeated("x x x x x x x x\n"));
@@ -31,6 +31,10 @@ add_compile_definitions(
   WIN32_LEAN_AND_MEAN
 )
 
+if(ENABLE_TRACING)
+  add_compile_definitions(TRACING)
+endif()
+
 if(CMAKE_CXX_COMPILER_ID STREQUAL "Clang")
   add_compile_options(
     -Wall
@@ -26,3 +26,5 @@ include(CMakeDependentOption)
 option(BUILD_SHARED_LIBS "Build shared libraries." ON)
 cmake_dependent_option(BUILD_TESTING "Build tests." ON "BUILD_SHARED_LIBS" OFF)
 option(BUILD_PACKAGING "Build packages." ON)
+option(BUILD_BENCHMARKS "Build benchmarks." OFF)
+option(ENABLE_TRACING "Enable tracing zones." OFF)
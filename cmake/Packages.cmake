@@ -30,6 +30,13 @@ FetchContent_Declare(
   GIT_SHALLOW TRUE
 )
 
+FetchContent_Declare(
+  GoogleBenchmark
+  GIT_REPOSITORY https://github.com/google/benchmark.git
+  GIT_TAG v1.8.3
+  GIT_SHALLOW TRUE
+)
+
 FetchContent_Declare(
   GoogleTest
   GIT_REPOSITORY https://github.com/google/googletest.git
@@ -32,8 +32,13 @@
 #define IDC_LAUNCH_AT_STARTUP           202
 #define IDC_LISTEN_ADDRESS              203
 #define IDC_CONTEXTMENU                 204
+#define IDC_STRIP_ESCAPES               205
+#define IDC_STRIP_TRAILING_WHITESPACE   206
+#define IDC_ACCESS_LIST                 207
+#define IDC_MEMORY_BUDGET               208
 
 #define IDD_SETTINGS                    300
 
 #define IDM_SETTINGS                    400
 #define IDM_QUIT                        401
+#define IDM_SAVE_TRACE                  402
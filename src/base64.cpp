@@ -0,0 +1,160 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "base64.h"
+
+#include "simd.h"
+
+#include <windows.h>
+
+#ifdef SIMD_X86
+#include <tmmintrin.h>
+#endif // SIMD_X86
+
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace ClipSock::Base64 {
+
+namespace {
+
+constexpr auto DecodeTable = [] {
+    std::array<INT, 256> Table{};
+    Table.fill(-1);
+
+    constexpr auto szAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (auto i = 0; i < 64; i++) {
+        Table[static_cast<UINT8>(szAlphabet[i])] = i;
+    }
+    return Table;
+}();
+
+} // namespace
+
+INT DecodeChar(CHAR ch)
+{
+    return DecodeTable[static_cast<UINT8>(ch)];
+}
+
+SIZE_T DecodeQuartets(const CHAR* pIn, SIZE_T cbIn, CHAR* pOut)
+{
+    SIZE_T cbConsumed = 0;
+    if (Simd::HasSSSE3()) {
+        cbConsumed = DecodeQuartetsSSSE3(pIn, cbIn, pOut);
+    }
+
+    // Decode the remainder (or everything, if SSSE3 is unavailable) one
+    // quartet at a time:
+    return cbConsumed + DecodeQuartetsScalar(pIn + cbConsumed, cbIn - cbConsumed,
+                                             pOut + cbConsumed / 4 * 3);
+}
+
+SIZE_T DecodeQuartetsScalar(const CHAR* pIn, SIZE_T cbIn, CHAR* pOut)
+{
+    SIZE_T cbConsumed = 0;
+    while (cbConsumed + 4 <= cbIn) {
+        auto nA = DecodeChar(pIn[cbConsumed + 0]);
+        auto nB = DecodeChar(pIn[cbConsumed + 1]);
+        auto nC = DecodeChar(pIn[cbConsumed + 2]);
+        auto nD = DecodeChar(pIn[cbConsumed + 3]);
+        if ((nA | nB | nC | nD) < 0) {
+            break;
+        }
+
+        auto uValue = static_cast<UINT32>(nA << 18 | nB << 12 | nC << 6 | nD);
+        *pOut++ = static_cast<CHAR>(uValue >> 16);
+        *pOut++ = static_cast<CHAR>(uValue >> 8);
+        *pOut++ = static_cast<CHAR>(uValue);
+        cbConsumed += 4;
+    }
+    return cbConsumed;
+}
+
+#ifdef SIMD_X86
+// Vectorized decoding translates 16 characters at a time using nibble lookup
+// tables, then packs the resulting sextets into 12 bytes. Since each block
+// is loaded before it is stored and 16 input bytes yield at most 16 output
+// bytes, decoding in place is safe. A block is stored 16 bytes at a time
+// only while another complete block of input follows it; the 4 bytes past
+// its decoded data then fall within the cbIn / 4 * 3 bytes of output that
+// the input may produce, and are either overwritten by the next block or
+// left past the returned length if decoding stops there. The final block
+// is stored as exactly 12 bytes. See http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html.
+SIMD_TARGET("ssse3")
+SIZE_T DecodeQuartetsSSSE3(const CHAR* pIn, SIZE_T cbIn, CHAR* pOut)
+{
+    const auto LookupLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const auto LookupHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const auto LookupRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                          0, 0, 0, 0, 0, 0, 0, 0);
+    const auto Mask2F = _mm_set1_epi8(0x2F);
+    const auto Pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    SIZE_T cbConsumed = 0;
+    while (cbConsumed + 16 <= cbIn) {
+        auto Input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + cbConsumed));
+
+        // Characters outside the alphabet have overlapping bits in both
+        // lookups; stop and let the caller handle the remainder:
+        auto HiNibbles = _mm_and_si128(_mm_srli_epi32(Input, 4), Mask2F);
+        auto LoNibbles = _mm_and_si128(Input, Mask2F);
+        auto Hi = _mm_shuffle_epi8(LookupHi, HiNibbles);
+        auto Lo = _mm_shuffle_epi8(LookupLo, LoNibbles);
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(Lo, Hi), _mm_setzero_si128()))) {
+            break;
+        }
+
+        auto Eq2F = _mm_cmpeq_epi8(Input, Mask2F);
+        auto Roll = _mm_shuffle_epi8(LookupRoll, _mm_add_epi8(Eq2F, HiNibbles));
+        auto Sextets = _mm_add_epi8(Input, Roll);
+
+        auto Merged = _mm_maddubs_epi16(Sextets, _mm_set1_epi32(0x01400140));
+        auto Output = _mm_madd_epi16(Merged, _mm_set1_epi32(0x00011000));
+        Output = _mm_shuffle_epi8(Output, Pack);
+
+        auto pBlock = pOut + cbConsumed / 4 * 3;
+        if (cbConsumed + 32 <= cbIn) {
+            assert(pBlock + 16 <= pOut + cbIn / 4 * 3);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pBlock), Output);
+        } else {
+            auto uTail = _mm_cvtsi128_si32(_mm_srli_si128(Output, 8));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pBlock), Output);
+            std::memcpy(pBlock + 8, &uTail, sizeof(uTail));
+        }
+        cbConsumed += 16;
+    }
+    return cbConsumed;
+}
+#else
+SIZE_T DecodeQuartetsSSSE3(const CHAR* /*pIn*/, SIZE_T /*cbIn*/, CHAR* /*pOut*/)
+{
+    return 0;
+}
+#endif // SIMD_X86
+
+} // namespace ClipSock::Base64
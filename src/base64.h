@@ -0,0 +1,43 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+namespace ClipSock::Base64 {
+
+INT DecodeChar(CHAR ch);
+
+// DecodeQuartets decodes as many complete quartets as possible, stopping at
+// the first quartet containing padding or a character outside the alphabet.
+// Output may overlap input provided pOut <= pIn. Returns the number of input
+// characters consumed, which is always a multiple of four.
+SIZE_T DecodeQuartets(const CHAR* pIn, SIZE_T cbIn, CHAR* pOut);
+
+SIZE_T DecodeQuartetsScalar(const CHAR* pIn, SIZE_T cbIn, CHAR* pOut);
+SIZE_T DecodeQuartetsSSSE3(const CHAR* pIn, SIZE_T cbIn, CHAR* pOut);
+
+} // namespace ClipSock::Base64
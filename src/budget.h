@@ -0,0 +1,84 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <algorithm>
+
+namespace ClipSock {
+
+// MemoryBudget accounts for memory reserved against a fixed limit. Callers
+// reserve before allocating and release once memory has been freed; a
+// reservation may be resized in place by supplying the amount currently
+// held. The high-water mark records the largest amount reserved at any one
+// time since the budget was last reset.
+class MemoryBudget {
+public:
+    explicit MemoryBudget(SIZE_T cbLimit) : m_cbLimit{cbLimit} {}
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    SIZE_T Limit() const { return m_cbLimit; }
+    SIZE_T Reserved() const { return m_cbReserved; }
+    SIZE_T HighWater() const { return m_cbHighWater; }
+
+    void SetLimit(SIZE_T cbLimit) { m_cbLimit = cbLimit; }
+
+    bool CanReserve(SIZE_T cbHeld, SIZE_T cbWanted) const
+    {
+        return cbWanted <= cbHeld || m_cbReserved - cbHeld + cbWanted <= m_cbLimit;
+    }
+
+    bool TryReserve(SIZE_T cbHeld, SIZE_T cbWanted)
+    {
+        if (!CanReserve(cbHeld, cbWanted)) {
+            return false;
+        }
+        m_cbReserved = m_cbReserved - cbHeld + cbWanted;
+        m_cbHighWater = std::max(m_cbHighWater, m_cbReserved);
+        return true;
+    }
+
+    void Release(SIZE_T cbHeld)
+    {
+        m_cbReserved -= std::min(cbHeld, m_cbReserved);
+    }
+
+    void Reset()
+    {
+        m_cbReserved = 0;
+        m_cbHighWater = 0;
+    }
+
+private:
+    SIZE_T m_cbLimit;
+    SIZE_T m_cbReserved{0};
+    SIZE_T m_cbHighWater{0};
+};
+
+} // namespace ClipSock
@@ -31,26 +31,62 @@
 
 #include <windows.h>
 
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
 namespace ClipSock {
 
-template<typename T, typename C, auto Count, auto Padding = 1>
+// Allocators provide zero-initialized storage for buffers. Each allocates
+// an object identified by a handle, which is locked to obtain a pointer to
+// its data; objects are freed with the size they were allocated with.
+
+// GlobalAllocator allocates moveable global memory, which may be passed to
+// the clipboard without copying:
+struct GlobalAllocator {
+    using Handle = HGLOBAL;
+
+    static Handle Allocate(SIZE_T cbData)
+    {
+        auto hMem = GlobalAlloc(GMEM_MOVEABLE | GMEM_ZEROINIT, cbData);
+        VERIFY_WIN32(hMem);
+        return hMem;
+    }
+
+    static PVOID Lock(Handle hMem)
+    {
+        auto pData = GlobalLock(hMem);
+        VERIFY_WIN32(pData);
+        return pData;
+    }
+
+    static void Free(Handle hMem, SIZE_T /*cbData*/)
+    {
+        GlobalFree(hMem);
+    }
+};
+
+template<typename T, typename C, auto Count, auto Padding = 1, typename Allocator = GlobalAllocator>
 class GlobalBuffer {
 public:
     using ValueType = T;
     using CountType = C;
+    using AllocatorType = Allocator;
+
+    GlobalBuffer() : GlobalBuffer(Count) {}
 
-    GlobalBuffer()
+    // Buffers may also be sized at runtime for transfers whose length is
+    // known in advance:
+    explicit GlobalBuffer(C cCount) : m_cCount{cCount}, m_cData{cCount}
     {
-        constexpr auto dwBytes = (Count + Padding) * sizeof(T);
-        m_hMem = GlobalAlloc(GMEM_MOVEABLE | GMEM_ZEROINIT, dwBytes);
-        VERIFY_WIN32(m_hMem);
+        m_hMem = Allocator::Allocate(GetBytes());
 
         try {
-            m_pData = reinterpret_cast<T*>(GlobalLock(m_hMem));
-            VERIFY_WIN32(m_pData);
+            m_pData = reinterpret_cast<T*>(Allocator::Lock(m_hMem));
         }
         catch (...) {
-            GlobalFree(m_hMem);
+            Allocator::Free(m_hMem, GetBytes());
             throw;
         }
     }
@@ -58,20 +94,47 @@ public:
     ~GlobalBuffer()
     {
         if (m_hMem) {
-            GlobalFree(m_hMem);
+            Allocator::Free(m_hMem, GetBytes());
         }
     }
 
     GlobalBuffer(const GlobalBuffer&) = delete;
     GlobalBuffer& operator=(const GlobalBuffer&) = delete;
 
+    GlobalBuffer(GlobalBuffer&& Other) noexcept
+        : m_hMem{std::exchange(Other.m_hMem, nullptr)},
+          m_pData{std::exchange(Other.m_pData, nullptr)},
+          m_cCount{std::exchange(Other.m_cCount, 0)},
+          m_cData{std::exchange(Other.m_cData, 0)}
+    {
+    }
+
+    GlobalBuffer& operator=(GlobalBuffer&& Other) noexcept
+    {
+        if (this != std::addressof(Other)) {
+            if (m_hMem) {
+                Allocator::Free(m_hMem, GetBytes());
+            }
+            m_hMem = std::exchange(Other.m_hMem, nullptr);
+            m_pData = std::exchange(Other.m_pData, nullptr);
+            m_cCount = std::exchange(Other.m_cCount, 0);
+            m_cData = std::exchange(Other.m_cData, 0);
+        }
+        return *this;
+    }
+
+    C Capacity() const { return m_cCount; }
     C Length() const { return m_cData; }
+    C Size() const { return m_cCount - m_cData; }
 
-    bool IsEmpty() const { return m_cData == Count; }
+    bool IsEmpty() const { return m_cData == m_cCount; }
     bool IsFull() const { return m_cData == 0; }
 
+    // Release transfers ownership of the data as moveable global memory,
+    // which is only available to buffers allocated from global memory:
     HGLOBAL Release()
     {
+        static_assert(std::is_same_v<Allocator, GlobalAllocator>, "Release requires GlobalAllocator");
         VERIFY(m_hMem, "GlobalBuffer already released");
         auto FinalAction = gsl::finally([&] {
             m_hMem = nullptr;
@@ -91,12 +154,29 @@ public:
         m_cData -= Offset;
     }
 
+    // Rewound elements are cleared to preserve zero-initialized padding when
+    // data is rewritten in place:
+    void operator-=(C Offset)
+    {
+        m_pData -= Offset;
+        m_cData += Offset;
+        std::memset(m_pData, 0, static_cast<SIZE_T>(Offset) * sizeof(T));
+    }
+
+    T* Data() const { return m_pData - Size(); }
+
     T* operator&() const { return m_pData; }
 
 private:
-    HGLOBAL m_hMem;
+    SIZE_T GetBytes() const
+    {
+        return (static_cast<SIZE_T>(m_cCount) + Padding) * sizeof(T);
+    }
+
+    typename Allocator::Handle m_hMem;
     T* m_pData;
-    C m_cData{Count};
+    C m_cCount;
+    C m_cData;
 };
 
 } // namespace ClipSock
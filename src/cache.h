@@ -0,0 +1,167 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace ClipSock {
+
+// ExpiringCache retains values for a limited time, bounded by both the number
+// of entries and the total number of bytes they account for. Once a limit is
+// reached, the least recently inserted entries are evicted first. Time is
+// supplied by the caller to simplify testing.
+template<typename K, typename V>
+class ExpiringCache {
+public:
+    using KeyType = K;
+    using ValueType = V;
+
+    ExpiringCache(SIZE_T cbMaximum, SIZE_T cMaximum, ULONGLONG ullTimeout)
+        : m_cbMaximum{cbMaximum}, m_cMaximum{cMaximum}, m_ullTimeout{ullTimeout}
+    {
+    }
+
+    ExpiringCache(const ExpiringCache&) = delete;
+    ExpiringCache& operator=(const ExpiringCache&) = delete;
+
+    SIZE_T Count() const { return m_Entries.size(); }
+    SIZE_T Bytes() const { return m_cbEntries; }
+
+    bool Contains(const K& Key) const { return m_Index.contains(Key); }
+
+    bool Insert(const K& Key, V&& Value, SIZE_T cbValue, ULONGLONG ullNow)
+    {
+        Erase(Key);
+        Expire(ullNow);
+
+        if (cbValue > m_cbMaximum || m_cMaximum == 0) {
+            return false;
+        }
+
+        while (m_Entries.size() >= m_cMaximum || m_cbEntries + cbValue > m_cbMaximum) {
+            Remove(std::prev(m_Entries.end()));
+        }
+
+        m_Entries.push_front({Key, std::move(Value), cbValue, ullNow + m_ullTimeout});
+        m_Index[Key] = m_Entries.begin();
+        m_cbEntries += cbValue;
+        return true;
+    }
+
+    V* Find(const K& Key)
+    {
+        auto it = m_Index.find(Key);
+        return it != m_Index.end() ? &it->second->Value : nullptr;
+    }
+
+    std::optional<V> Extract(const K& Key, ULONGLONG ullNow)
+    {
+        Expire(ullNow);
+
+        auto it = m_Index.find(Key);
+        if (it == m_Index.end()) {
+            return std::nullopt;
+        }
+
+        std::optional<V> Value{std::move(it->second->Value)};
+        Remove(it->second);
+        return Value;
+    }
+
+    void Erase(const K& Key)
+    {
+        if (auto it = m_Index.find(Key); it != m_Index.end()) {
+            Remove(it->second);
+        }
+    }
+
+    void Expire(ULONGLONG ullNow)
+    {
+        // Entries share a common timeout, so the oldest entry always expires
+        // first:
+        while (!m_Entries.empty() && m_Entries.back().ullExpires <= ullNow) {
+            Remove(std::prev(m_Entries.end()));
+        }
+    }
+
+    // Limits may be changed at any time; the least recently inserted entries
+    // are evicted until the new limits are met:
+    void SetMaximum(SIZE_T cbMaximum, SIZE_T cMaximum)
+    {
+        m_cbMaximum = cbMaximum;
+        m_cMaximum = cMaximum;
+        while (!m_Entries.empty() && (m_Entries.size() > m_cMaximum || m_cbEntries > m_cbMaximum)) {
+            Remove(std::prev(m_Entries.end()));
+        }
+    }
+
+    // Entries are evicted without changing limits until no more than the
+    // given number of bytes remain:
+    void Trim(SIZE_T cbRemaining)
+    {
+        while (!m_Entries.empty() && m_cbEntries > cbRemaining) {
+            Remove(std::prev(m_Entries.end()));
+        }
+    }
+
+    void Clear()
+    {
+        m_Index.clear();
+        m_Entries.clear();
+        m_cbEntries = 0;
+    }
+
+private:
+    struct Entry {
+        K Key;
+        V Value;
+        SIZE_T cbValue;
+        ULONGLONG ullExpires;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    void Remove(typename EntryList::iterator it)
+    {
+        m_cbEntries -= it->cbValue;
+        m_Index.erase(it->Key);
+        m_Entries.erase(it);
+    }
+
+    SIZE_T m_cbMaximum;
+    SIZE_T m_cMaximum;
+    ULONGLONG m_ullTimeout;
+    SIZE_T m_cbEntries{0};
+    EntryList m_Entries;
+    std::unordered_map<K, typename EntryList::iterator> m_Index;
+};
+
+} // namespace ClipSock
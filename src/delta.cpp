@@ -0,0 +1,221 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "delta.h"
+
+#include "protocol.h"
+#include "util.h"
+
+#include <windows.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ClipSock::Delta {
+
+namespace {
+
+// RollingHash implements the weak checksum used by rsync, which can be
+// updated in constant time as the window slides one byte at a time:
+class RollingHash {
+public:
+    RollingHash(std::string_view svWindow)
+    {
+        for (auto i = 0u; i < svWindow.size(); i++) {
+            auto uValue = static_cast<UINT8>(svWindow[i]);
+            m_uA += uValue;
+            m_uB += static_cast<UINT32>(svWindow.size() - i) * uValue;
+        }
+    }
+
+    void Roll(CHAR chOut, CHAR chIn)
+    {
+        m_uA += static_cast<UINT8>(chIn) - static_cast<UINT32>(static_cast<UINT8>(chOut));
+        m_uB += m_uA - BLOCK_SIZE * static_cast<UINT32>(static_cast<UINT8>(chOut));
+    }
+
+    UINT32 Value() const { return (m_uA & 0xFFFF) | (m_uB << 16); }
+
+private:
+    UINT32 m_uA{0};
+    UINT32 m_uB{0};
+};
+
+void PutCopy(std::string& sFrame, SIZE_T uOffset, SIZE_T cbLength)
+{
+    sFrame.push_back(OP_COPY);
+    Protocol::PutUInt32(sFrame, static_cast<UINT32>(uOffset));
+    Protocol::PutUInt32(sFrame, static_cast<UINT32>(cbLength));
+}
+
+void PutLiteral(std::string& sFrame, std::string_view svLiteral)
+{
+    if (svLiteral.empty()) {
+        return;
+    }
+    sFrame.push_back(OP_LITERAL);
+    Protocol::PutUInt32(sFrame, static_cast<UINT32>(svLiteral.size()));
+    sFrame.append(svLiteral);
+}
+
+} // namespace
+
+UINT64 Hash(std::string_view svData)
+{
+    // FNV-1a identifies the base and checks the reconstructed target; it
+    // detects a stale base or corrupted operations, but is not resistant to
+    // deliberate collisions:
+    UINT64 ullHash = 0xCBF29CE484222325;
+    for (auto ch : svData) {
+        ullHash ^= static_cast<UINT8>(ch);
+        ullHash *= 0x100000001B3;
+    }
+    return ullHash;
+}
+
+Header GetHeader(std::string_view svFrame)
+{
+    return {
+        .ullBaseHash = Protocol::GetUInt64(svFrame, Protocol::FRAME_PREFIX_SIZE),
+        .ullTargetHash = Protocol::GetUInt64(svFrame, Protocol::FRAME_PREFIX_SIZE + sizeof(UINT64)),
+        .cbLength = Protocol::GetUInt32(svFrame, Protocol::FRAME_PREFIX_SIZE + 2 * sizeof(UINT64))
+    };
+}
+
+std::string Encode(std::string_view svBase, std::string_view svTarget)
+{
+    std::string sFrame{Protocol::FRAME_MAGIC, ARRAYSIZE(Protocol::FRAME_MAGIC)};
+    sFrame.push_back(Protocol::FRAME_DELTA);
+    Protocol::PutUInt64(sFrame, Hash(svBase));
+    Protocol::PutUInt64(sFrame, Hash(svTarget));
+    Protocol::PutUInt32(sFrame, static_cast<UINT32>(svTarget.size()));
+
+    // Index each complete block of the base by its weak checksum:
+    std::unordered_map<UINT32, std::vector<SIZE_T>> Blocks;
+    for (SIZE_T uOffset = 0; uOffset + BLOCK_SIZE <= svBase.size(); uOffset += BLOCK_SIZE) {
+        RollingHash Rolling{svBase.substr(uOffset, BLOCK_SIZE)};
+        Blocks[Rolling.Value()].push_back(uOffset);
+    }
+
+    SIZE_T uLiteral = 0;
+    SIZE_T uOffset = 0;
+    while (uOffset + BLOCK_SIZE <= svTarget.size()) {
+        RollingHash Rolling{svTarget.substr(uOffset, BLOCK_SIZE)};
+        for (;;) {
+            SIZE_T cbMatch = 0;
+            SIZE_T uMatch = 0;
+            if (auto it = Blocks.find(Rolling.Value()); it != Blocks.end()) {
+                for (auto uBase : it->second) {
+                    if (std::memcmp(svBase.data() + uBase, svTarget.data() + uOffset, BLOCK_SIZE) == 0) {
+                        cbMatch = BLOCK_SIZE;
+                        uMatch = uBase;
+                        break;
+                    }
+                }
+            }
+
+            if (cbMatch) {
+                // Extend the match beyond the block boundary as far as the
+                // base and target agree to minimize the number of operations:
+                while (uMatch + cbMatch < svBase.size() &&
+                       uOffset + cbMatch < svTarget.size() &&
+                       svBase[uMatch + cbMatch] == svTarget[uOffset + cbMatch]) {
+                    cbMatch++;
+                }
+                PutLiteral(sFrame, svTarget.substr(uLiteral, uOffset - uLiteral));
+                PutCopy(sFrame, uMatch, cbMatch);
+                uOffset += cbMatch;
+                uLiteral = uOffset;
+                break;
+            }
+
+            if (uOffset + BLOCK_SIZE >= svTarget.size()) {
+                uOffset = svTarget.size();
+                break;
+            }
+            Rolling.Roll(svTarget[uOffset], svTarget[uOffset + BLOCK_SIZE]);
+            uOffset++;
+        }
+    }
+    PutLiteral(sFrame, svTarget.substr(uLiteral));
+
+    return sFrame;
+}
+
+// Offsets and lengths are supplied by the client; ranges are checked by
+// subtraction so that they cannot wrap where SIZE_T is 32 bits. The result
+// is checked against the target hash, as a matching base hash does not
+// guarantee the operations reproduce the client's text:
+void Apply(std::string_view svBase, std::string_view svOps, CHAR* pOut, SIZE_T cbOut, UINT64 ullTargetHash)
+{
+    SIZE_T cbWritten = 0;
+    SIZE_T uOffset = 0;
+    while (uOffset < svOps.size()) {
+        auto chOp = svOps[uOffset++];
+        switch (chOp) {
+        case OP_COPY: {
+            SIZE_T uBase = Protocol::GetUInt32(svOps, uOffset);
+            SIZE_T cbCopy = Protocol::GetUInt32(svOps, uOffset + sizeof(UINT32));
+            uOffset += 2 * sizeof(UINT32);
+
+            VERIFY(uBase <= svBase.size() && cbCopy <= svBase.size() - uBase,
+                   "Delta copy out of range: {}+{} > {}", uBase, cbCopy, svBase.size());
+            VERIFY(cbCopy <= cbOut - cbWritten,
+                   "Delta exceeds length: {}+{} > {}", cbWritten, cbCopy, cbOut);
+            std::memcpy(pOut + cbWritten, svBase.data() + uBase, cbCopy);
+            cbWritten += cbCopy;
+            break;
+        }
+
+        case OP_LITERAL: {
+            SIZE_T cbLiteral = Protocol::GetUInt32(svOps, uOffset);
+            uOffset += sizeof(UINT32);
+
+            VERIFY(uOffset <= svOps.size() && cbLiteral <= svOps.size() - uOffset,
+                   "Delta literal truncated: {}+{} > {}", uOffset, cbLiteral, svOps.size());
+            VERIFY(cbLiteral <= cbOut - cbWritten,
+                   "Delta exceeds length: {}+{} > {}", cbWritten, cbLiteral, cbOut);
+            std::memcpy(pOut + cbWritten, svOps.data() + uOffset, cbLiteral);
+            cbWritten += cbLiteral;
+            uOffset += cbLiteral;
+            break;
+        }
+
+        default:
+            THROW("Unsupported delta operation: {:#04x}", int{chOp});
+        }
+    }
+
+    VERIFY(cbWritten == cbOut, "Delta length mismatch: {} != {}", cbWritten, cbOut);
+
+    auto ullHash = Hash({pOut, cbOut});
+    VERIFY(ullHash == ullTargetHash, "Delta target hash mismatch: {:#018x} != {:#018x}",
+           ullHash, ullTargetHash);
+}
+
+} // namespace ClipSock::Delta
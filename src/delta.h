@@ -0,0 +1,63 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "protocol.h"
+
+#include <windows.h>
+
+#include <string>
+#include <string_view>
+
+namespace ClipSock::Delta {
+
+// A delta frame consists of the frame prefix, a content hash of the base the
+// client encoded against, a content hash and the length of the reconstructed
+// text, and a series of operations that either copy a range of the base or
+// insert literal text. Once the frame has been applied, the server replies
+// '+' if the result matches the target hash or '-' otherwise:
+inline constexpr auto HEADER_SIZE = Protocol::FRAME_PREFIX_SIZE + 2 * sizeof(UINT64) + sizeof(UINT32);
+
+inline constexpr auto BLOCK_SIZE = 64;
+
+inline constexpr CHAR OP_COPY = 'C';
+inline constexpr CHAR OP_LITERAL = 'L';
+
+struct Header {
+    UINT64 ullBaseHash;
+    UINT64 ullTargetHash;
+    UINT32 cbLength;
+};
+
+UINT64 Hash(std::string_view svData);
+
+Header GetHeader(std::string_view svFrame);
+
+std::string Encode(std::string_view svBase, std::string_view svTarget);
+
+void Apply(std::string_view svBase, std::string_view svOps, CHAR* pOut, SIZE_T cbOut, UINT64 ullTargetHash);
+
+} // namespace ClipSock::Delta
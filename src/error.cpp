@@ -0,0 +1,75 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "error.h"
+
+#include <windows.h>
+
+#include <format>
+
+namespace ClipSock {
+
+DefaultErrorCache ErrorMessages;
+
+SIZE_T FormatErrorMessage(DWORD dwError, PSTR szBuffer, SIZE_T cchBuffer)
+{
+    SIZE_T cchMessage = FormatMessageA(
+        FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+        nullptr,
+        dwError,
+        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+        szBuffer,
+        static_cast<DWORD>(cchBuffer),
+        nullptr
+    );
+    if (cchMessage == 0) {
+        auto Result = std::format_to_n(szBuffer, static_cast<std::ptrdiff_t>(cchBuffer - 1),
+                                       "Unknown error {}", dwError);
+        cchMessage = static_cast<SIZE_T>(Result.out - szBuffer);
+    }
+
+    // System messages end with a line break, which is not wanted in
+    // exceptions or the event log:
+    while (cchMessage > 0 && (szBuffer[cchMessage - 1] == '\r' ||
+                              szBuffer[cchMessage - 1] == '\n' ||
+                              szBuffer[cchMessage - 1] == ' ')) {
+        cchMessage--;
+    }
+    szBuffer[cchMessage] = '\0';
+    return cchMessage;
+}
+
+PCSTR GetCachedErrorMessageA(DWORD dwError)
+{
+    if (auto szMessage = ErrorMessages.Find(dwError)) {
+        return szMessage;
+    }
+
+    thread_local CHAR szBuffer[ERROR_MESSAGE_LENGTH];
+    FormatErrorMessage(dwError, szBuffer, ARRAYSIZE(szBuffer));
+    return szBuffer;
+}
+
+} // namespace ClipSock
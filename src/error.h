@@ -0,0 +1,96 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+
+namespace ClipSock {
+
+// Messages are formatted once per error code and retained; codes beyond the
+// capacity of the cache are formatted on each use:
+inline constexpr auto ERROR_CACHE_CAPACITY = 64;
+inline constexpr auto ERROR_MESSAGE_LENGTH = 512; // characters, including terminator
+
+SIZE_T FormatErrorMessage(DWORD dwError, PSTR szBuffer, SIZE_T cchBuffer);
+
+// ErrorCache interns messages in fixed storage using open addressing. An
+// entry is claimed by storing its error code and published once formatted,
+// so lookups never lock or allocate.
+template<SIZE_T Capacity>
+class ErrorCache {
+public:
+    ErrorCache() = default;
+
+    ErrorCache(const ErrorCache&) = delete;
+    ErrorCache& operator=(const ErrorCache&) = delete;
+
+    // Returns nullptr if the cache is full or the message is still being
+    // formatted by another thread:
+    PCSTR Find(DWORD dwError)
+    {
+        // ERROR_SUCCESS marks unused entries and is never cached:
+        if (dwError == ERROR_SUCCESS) {
+            return nullptr;
+        }
+
+        auto nFirst = static_cast<SIZE_T>(dwError) % Capacity;
+        for (SIZE_T i = 0; i < Capacity; i++) {
+            auto& Entry = m_Entries[(nFirst + i) % Capacity];
+            auto dwEntry = Entry.dwError.load(std::memory_order_acquire);
+            if (dwEntry == ERROR_SUCCESS &&
+                Entry.dwError.compare_exchange_strong(dwEntry, dwError, std::memory_order_acq_rel)) {
+                FormatErrorMessage(dwError, Entry.szMessage, ERROR_MESSAGE_LENGTH);
+                Entry.bReady.store(TRUE, std::memory_order_release);
+                return Entry.szMessage;
+            }
+            if (dwEntry == dwError) {
+                return Entry.bReady.load(std::memory_order_acquire) ? Entry.szMessage : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    struct Entry {
+        std::atomic<DWORD> dwError{ERROR_SUCCESS};
+        std::atomic<BOOL> bReady{FALSE};
+        CHAR szMessage[ERROR_MESSAGE_LENGTH];
+    };
+
+    Entry m_Entries[Capacity];
+};
+
+using DefaultErrorCache = ErrorCache<ERROR_CACHE_CAPACITY>;
+
+extern DefaultErrorCache ErrorMessages;
+
+// Messages not held in the cache are formatted into a per-thread buffer,
+// which remains valid until the next call on the same thread:
+PCSTR GetCachedErrorMessageA(DWORD dwError);
+
+} // namespace ClipSock
@@ -25,13 +25,196 @@
 
 #include "eventlog.h"
 
+#include "messages.h"
 #include "util.h"
 
 #include <windows.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <string_view>
+
 namespace ClipSock::EventLog {
 
+namespace {
+
+// TruncatingIterator writes formatted text into a fixed buffer, discarding
+// anything that does not fit:
+class TruncatingIterator {
+public:
+    using difference_type = std::ptrdiff_t;
+
+    TruncatingIterator(PSTR pNext, PSTR pEnd) : m_pNext{pNext}, m_pEnd{pEnd} {}
+
+    TruncatingIterator& operator=(CHAR ch)
+    {
+        if (m_pNext != m_pEnd) {
+            *m_pNext++ = ch;
+        }
+        return *this;
+    }
+
+    TruncatingIterator& operator*() { return *this; }
+    TruncatingIterator& operator++() { return *this; }
+    TruncatingIterator operator++(int) { return *this; }
+
+    PSTR Get() const { return m_pNext; }
+
+private:
+    PSTR m_pNext;
+    PSTR m_pEnd;
+};
+
+} // namespace
+
 HANDLE hEventLog;
+Writer AsyncWriter;
+
+BOOL IsRepeat(const Record& Entry, const Record& Previous)
+{
+    return Entry.wType == Previous.wType &&
+           Entry.wCategory == Previous.wCategory &&
+           Entry.dwEventId == Previous.dwEventId &&
+           Entry.bText == Previous.bText &&
+           std::string_view{Entry.szText} == std::string_view{Previous.szText};
+}
+
+void Format(Record& Entry, std::string_view svFormat, std::format_args FormatArgs)
+{
+    auto pEnd = Entry.szText + RECORD_LENGTH - 1;
+    auto It = std::vformat_to(TruncatingIterator{Entry.szText, pEnd}, svFormat, FormatArgs);
+    *It.Get() = '\0';
+}
+
+BOOL Writer::Push(const Record& Entry)
+{
+    // Callers may still push after observing the writer running; pushes in
+    // progress are counted so that Stop waits for them before its final
+    // drain, and records pushed once stopping are written synchronously:
+    m_cPushing.fetch_add(1);
+    if (m_bStopRequested.load()) {
+        m_cPushing.fetch_sub(1, std::memory_order_release);
+        Write(Entry, 0);
+        return TRUE;
+    }
+
+    BOOL bPushed = m_Queue.TryPush(Entry);
+    if (bPushed) {
+        SetEvent(m_hEvent);
+    } else {
+        m_cDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_cPushing.fetch_sub(1, std::memory_order_release);
+    return bPushed;
+}
+
+void Writer::Drain(ULONGLONG ullNow)
+{
+    Record Entry;
+    while (m_Queue.TryPop(Entry)) {
+        if (m_bLast && IsRepeat(Entry, m_Last) && ullNow - m_ullLast < REPEAT_WINDOW) {
+            m_cRepeats++;
+            continue;
+        }
+        Flush();
+        Write(Entry, 0);
+        m_Last = Entry;
+        m_bLast = TRUE;
+        m_ullLast = ullNow;
+    }
+
+    // Repeats are reported once the window closes, even if no further
+    // records arrive:
+    if (m_bLast && ullNow - m_ullLast >= REPEAT_WINDOW) {
+        Flush();
+        m_bLast = FALSE;
+    }
+
+    auto cDropped = m_cDropped.exchange(0, std::memory_order_relaxed);
+    if (cDropped > 0) {
+        auto sArg = std::format("{} records dropped; queue full", cDropped);
+        PCSTR pStrings[]{sArg.c_str()};
+        ReportEventA(hEventLog, EVENTLOG_WARNING_TYPE, CATEGORY_NONE, MSG_EVENTS_DROPPED, nullptr,
+                     ARRAYSIZE(pStrings), 0, pStrings, nullptr);
+    }
+}
+
+void Writer::Flush()
+{
+    if (m_cRepeats > 0) {
+        Write(m_Last, m_cRepeats);
+        m_cRepeats = 0;
+    }
+}
+
+void Writer::Write(const Record& Entry, ULONGLONG cRepeats)
+{
+    if (cRepeats > 0) {
+        CHAR szText[RECORD_LENGTH + 32];
+        auto Result = std::format_to_n(szText, ARRAYSIZE(szText) - 1, "{} (repeated {} times)",
+                                       Entry.szText, cRepeats);
+        *Result.out = '\0';
+        PCSTR pStrings[]{szText};
+        ReportEventA(hEventLog, Entry.wType, Entry.wCategory, Entry.dwEventId, nullptr,
+                     ARRAYSIZE(pStrings), 0, pStrings, nullptr);
+    } else if (Entry.bText) {
+        PCSTR pStrings[]{Entry.szText};
+        ReportEventA(hEventLog, Entry.wType, Entry.wCategory, Entry.dwEventId, nullptr,
+                     ARRAYSIZE(pStrings), 0, pStrings, nullptr);
+    } else {
+        ReportEvent(hEventLog, Entry.wType, Entry.wCategory, Entry.dwEventId, nullptr,
+                    0, 0, nullptr, nullptr);
+    }
+}
+
+DWORD WINAPI Writer::ThreadProc(PVOID pParam)
+{
+    auto pWriter = static_cast<Writer*>(pParam);
+    while (!pWriter->m_bStopRequested.load(std::memory_order_acquire)) {
+        WaitForSingleObject(pWriter->m_hEvent, REPEAT_WINDOW);
+        pWriter->Drain(GetTickCount64());
+    }
+    return 0;
+}
+
+void Writer::Start()
+{
+    m_hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    VERIFY_WIN32(m_hEvent);
+
+    m_bStopRequested = FALSE;
+    m_hThread = CreateThread(nullptr, 0, ThreadProc, this, 0, nullptr);
+    VERIFY_WIN32(m_hThread);
+    m_bRunning = TRUE;
+}
+
+void Writer::Stop()
+{
+    if (!m_bRunning) {
+        return;
+    }
+
+    // Records reported after this point are written synchronously; once
+    // pushes in progress complete, anything still queued is drained and
+    // outstanding repeats are reported:
+    m_bRunning = FALSE;
+    m_bStopRequested = TRUE;
+    SetEvent(m_hEvent);
+    WaitForSingleObject(m_hThread, INFINITE);
+    CloseHandle(m_hThread);
+    m_hThread = nullptr;
+
+    while (m_cPushing.load() != 0) {
+        YieldProcessor();
+    }
+    Drain(GetTickCount64());
+    Flush();
+    m_bLast = FALSE;
+
+    CloseHandle(m_hEvent);
+    m_hEvent = nullptr;
+}
 
 void Init()
 {
@@ -25,8 +25,11 @@
 
 #pragma once
 
+#include "queue.h"
+
 #include <windows.h>
 
+#include <atomic>
 #include <format>
 #include <string_view>
 #include <utility>
@@ -35,8 +38,75 @@ namespace ClipSock::EventLog {
 
 inline constexpr auto CATEGORY_NONE = 0;
 
+// Records are formatted into fixed buffers and queued for a background
+// thread; text longer than a record is truncated:
+inline constexpr auto RECORD_LENGTH = 512; // characters, including terminator
+inline constexpr auto QUEUE_CAPACITY = 256;
+
+// Identical records reported within the window are collapsed into a single
+// record noting the number of repeats:
+inline constexpr auto REPEAT_WINDOW = 5 * 1000; // milliseconds
+
 extern HANDLE hEventLog;
 
+struct Record {
+    WORD wType;
+    WORD wCategory;
+    DWORD dwEventId;
+    BOOL bText;
+    CHAR szText[RECORD_LENGTH];
+};
+
+BOOL IsRepeat(const Record& Entry, const Record& Previous);
+void Format(Record& Entry, std::string_view svFormat, std::format_args FormatArgs);
+
+template<SIZE_T Capacity>
+using Queue = BoundedQueue<Record, Capacity>;
+
+// Writer reports queued records to the event log from a background thread
+// so that callers never block on the event log. Records are only queued
+// while the writer is running; otherwise, including once it is stopping,
+// they are reported synchronously.
+class Writer {
+public:
+    Writer() = default;
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    BOOL IsRunning() const
+    {
+        return m_bRunning.load(std::memory_order_acquire);
+    }
+
+    BOOL Push(const Record& Entry);
+    void Drain(ULONGLONG ullNow);
+    void Flush();
+    void Start();
+    void Stop();
+
+private:
+    static DWORD WINAPI ThreadProc(PVOID pParam);
+
+    void Write(const Record& Entry, ULONGLONG cRepeats);
+
+    Queue<QUEUE_CAPACITY> m_Queue;
+    std::atomic<BOOL> m_bRunning{FALSE};
+    std::atomic<BOOL> m_bStopRequested{FALSE};
+    std::atomic<ULONGLONG> m_cDropped{0};
+    std::atomic<LONG> m_cPushing{0};
+    HANDLE m_hEvent{nullptr};
+    HANDLE m_hThread{nullptr};
+
+    // Most recently written record and the number of repeats since:
+    Record m_Last{};
+    BOOL m_bLast{FALSE};
+    ULONGLONG m_ullLast{0};
+    ULONGLONG m_cRepeats{0};
+};
+
+extern Writer AsyncWriter;
+
 template<auto wCategory>
 class EventLogger {
 public:
@@ -79,6 +149,10 @@ public:
 protected:
     BOOL ReportType(WORD wType, DWORD dwEventId)
     {
+        if (AsyncWriter.IsRunning()) {
+            Record Entry{.wType = wType, .wCategory = wCategory, .dwEventId = dwEventId, .bText = FALSE};
+            return AsyncWriter.Push(Entry);
+        }
         return ReportEvent(hEventLog, wType, wCategory, dwEventId, nullptr,
                            0, 0, nullptr, nullptr);
     }
@@ -86,12 +160,18 @@ protected:
     template<typename... Args>
     BOOL ReportType(WORD wType, DWORD dwEventId, std::string_view svFormat, Args&&... vaArguments)
     {
+        if (AsyncWriter.IsRunning()) {
+            Record Entry{.wType = wType, .wCategory = wCategory, .dwEventId = dwEventId, .bText = TRUE};
+            Format(Entry, svFormat, std::make_format_args(vaArguments...));
+            return AsyncWriter.Push(Entry);
+        }
         auto sArg = std::vformat(svFormat, std::make_format_args(vaArguments...));
         PCSTR pStrings[]{sArg.data()};
         return ReportEventA(hEventLog, wType, wCategory, dwEventId, nullptr,
                             ARRAYSIZE(pStrings), 0, pStrings, nullptr);
     }
 
+    // Wide records are always reported synchronously:
     template<typename... Args>
     BOOL ReportType(WORD wType, DWORD dwEventId, std::wstring_view svFormat, Args&&... vaArguments)
     {
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <numeric>
+
+namespace ClipSock {
+
+// SizeHistogram counts sizes in power-of-two classes, where class N holds
+// sizes below 2^N; larger sizes are counted in the last class. Counts are
+// halved each time the window is reached so that recent sizes dominate.
+class SizeHistogram {
+public:
+    static constexpr auto CLASSES = 17;
+
+    using CountArray = std::array<DWORD, CLASSES>;
+
+    explicit SizeHistogram(DWORD cWindow) : m_cWindow{cWindow} {}
+
+    SizeHistogram(const SizeHistogram&) = delete;
+    SizeHistogram& operator=(const SizeHistogram&) = delete;
+
+    DWORD Count() const { return m_cTotal; }
+    const CountArray& Counts() const { return m_Counts; }
+
+    void Add(SIZE_T cbSize)
+    {
+        auto nClass = std::min<SIZE_T>(std::bit_width(cbSize), CLASSES - 1);
+        m_Counts[nClass]++;
+        if (++m_cTotal >= m_cWindow) {
+            for (auto& cCount : m_Counts) {
+                cCount /= 2;
+            }
+            Total();
+        }
+    }
+
+    // Returns the upper bound of the smallest class covering the given
+    // percentage of sizes, or zero if no sizes have been counted:
+    SIZE_T GetPercentile(UINT uPercent) const
+    {
+        if (m_cTotal == 0) {
+            return 0;
+        }
+
+        auto cThreshold = (static_cast<ULONGLONG>(m_cTotal) * uPercent + 99) / 100;
+        ULONGLONG cCumulative = 0;
+        for (SIZE_T nClass = 0; nClass < CLASSES; nClass++) {
+            cCumulative += m_Counts[nClass];
+            if (cCumulative >= cThreshold) {
+                return SIZE_T{1} << nClass;
+            }
+        }
+        return SIZE_T{1} << (CLASSES - 1);
+    }
+
+    void Load(const CountArray& Counts)
+    {
+        m_Counts = Counts;
+        Total();
+    }
+
+    void Clear()
+    {
+        m_Counts.fill(0);
+        m_cTotal = 0;
+    }
+
+private:
+    void Total()
+    {
+        m_cTotal = std::accumulate(m_Counts.begin(), m_Counts.end(), DWORD{0});
+    }
+
+    DWORD m_cWindow;
+    DWORD m_cTotal{0};
+    CountArray m_Counts{};
+};
+
+} // namespace ClipSock
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace ClipSock {
+
+// Timestamps are taken from the performance counter, which is monotonic and
+// has a resolution of one microsecond or better:
+inline LONGLONG GetTimestamp()
+{
+    LARGE_INTEGER Counter;
+    QueryPerformanceCounter(&Counter);
+    return Counter.QuadPart;
+}
+
+inline ULONGLONG GetElapsedMicroseconds(LONGLONG llStart, LONGLONG llEnd)
+{
+    static const auto llFrequency = [] {
+        LARGE_INTEGER Frequency;
+        QueryPerformanceFrequency(&Frequency);
+        return Frequency.QuadPart;
+    }();
+
+    // Whole seconds are converted separately to avoid overflow:
+    auto ullTicks = static_cast<ULONGLONG>(std::max(llEnd - llStart, 0LL));
+    auto ullFrequency = static_cast<ULONGLONG>(llFrequency);
+    return ullTicks / ullFrequency * 1000000 + ullTicks % ullFrequency * 1000000 / ullFrequency;
+}
+
+// LatencyHistogram records values in a fixed number of log-linear buckets,
+// similar to an HDR histogram. Each power of two is divided into equal
+// sub-buckets, which bounds the relative error of a reported percentile to
+// 1/2^(SUB_BUCKET_BITS-1) regardless of magnitude. Values beyond the range
+// are counted in the last bucket.
+class LatencyHistogram {
+public:
+    static constexpr auto SUB_BUCKET_BITS = 5;
+    static constexpr auto MAXIMUM_BITS = 40;
+
+    static constexpr auto SUB_BUCKETS = SIZE_T{1} << SUB_BUCKET_BITS;
+    static constexpr auto BUCKETS = (MAXIMUM_BITS - SUB_BUCKET_BITS) * (SUB_BUCKETS / 2) + SUB_BUCKETS;
+
+    ULONGLONG Count() const { return m_cTotal; }
+
+    void Record(ULONGLONG ullValue)
+    {
+        m_Counts[GetIndex(ullValue)]++;
+        m_cTotal++;
+    }
+
+    // Returns the upper bound of the bucket containing the given percentile,
+    // or zero if no values have been recorded:
+    ULONGLONG GetPercentile(UINT uPercent) const
+    {
+        if (m_cTotal == 0) {
+            return 0;
+        }
+
+        auto cThreshold = std::max<ULONGLONG>((m_cTotal * uPercent + 99) / 100, 1);
+        ULONGLONG cCumulative = 0;
+        for (SIZE_T nIndex = 0; nIndex < BUCKETS; nIndex++) {
+            cCumulative += m_Counts[nIndex];
+            if (cCumulative >= cThreshold) {
+                return GetUpperBound(nIndex);
+            }
+        }
+        return GetUpperBound(BUCKETS - 1);
+    }
+
+    void Clear()
+    {
+        m_Counts.fill(0);
+        m_cTotal = 0;
+    }
+
+    static SIZE_T GetIndex(ULONGLONG ullValue)
+    {
+        auto nBits = static_cast<int>(std::bit_width(ullValue));
+        auto cShift = static_cast<SIZE_T>(std::max(nBits - SUB_BUCKET_BITS, 0));
+        if (cShift > MAXIMUM_BITS - SUB_BUCKET_BITS) {
+            return BUCKETS - 1;
+        }
+        return cShift * (SUB_BUCKETS / 2) + static_cast<SIZE_T>(ullValue >> cShift);
+    }
+
+    static ULONGLONG GetUpperBound(SIZE_T nIndex)
+    {
+        if (nIndex < SUB_BUCKETS) {
+            return nIndex;
+        }
+        auto cShift = (nIndex - SUB_BUCKETS) / (SUB_BUCKETS / 2) + 1;
+        auto ullSubBucket = (nIndex - SUB_BUCKETS) % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2;
+        return ((ullSubBucket + 1) << cShift) - 1;
+    }
+
+private:
+    std::array<ULONGLONG, BUCKETS> m_Counts{};
+    ULONGLONG m_cTotal{0};
+};
+
+} // namespace ClipSock
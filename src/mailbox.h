@@ -0,0 +1,92 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace ClipSock {
+
+// Mailbox holds the most recent value written by any number of threads.
+// Writers exclude one another by holding an odd sequence number while
+// updating; readers copy the value without locking and retry if a write
+// was in progress, so neither side waits longer than it takes to copy.
+template<typename T>
+class Mailbox {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    Mailbox() = default;
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    // Update applies fnUpdate to the value in place; fnUpdate returns
+    // whether the value changed, which is returned to the caller:
+    template<typename Function>
+    BOOL Update(Function&& fnUpdate)
+    {
+        auto ullSequence = m_ullSequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((ullSequence & 1) == 0 &&
+                m_ullSequence.compare_exchange_weak(ullSequence, ullSequence + 1,
+                                                    std::memory_order_acquire)) {
+                break;
+            }
+            YieldProcessor();
+            ullSequence = m_ullSequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        BOOL bChanged = fnUpdate(m_Value);
+        m_ullSequence.store(ullSequence + 2, std::memory_order_release);
+        return bChanged;
+    }
+
+    T Read() const
+    {
+        T Value;
+        for (;;) {
+            auto ullSequence = m_ullSequence.load(std::memory_order_acquire);
+            if ((ullSequence & 1) == 0) {
+                std::memcpy(&Value, &m_Value, sizeof(Value));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_ullSequence.load(std::memory_order_relaxed) == ullSequence) {
+                    return Value;
+                }
+            }
+            YieldProcessor();
+        }
+    }
+
+private:
+    std::atomic<ULONGLONG> m_ullSequence{0};
+    T m_Value{};
+};
+
+} // namespace ClipSock
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "memory.h"
+
+#include "util.h"
+
+#include <windows.h>
+
+namespace ClipSock {
+
+MemoryMonitor::~MemoryMonitor()
+{
+    Close();
+}
+
+void MemoryMonitor::Open()
+{
+    Close();
+
+    m_hLowMemory = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+    VERIFY_WIN32(m_hLowMemory);
+
+    m_hHighMemory = CreateMemoryResourceNotification(HighMemoryResourceNotification);
+    if (!m_hHighMemory) {
+        auto upError = GetLastErrorMessageA();
+        Close();
+        THROW(upError.get());
+    }
+}
+
+void MemoryMonitor::Close()
+{
+    if (m_hLowMemory) {
+        CloseHandle(m_hLowMemory);
+        m_hLowMemory = nullptr;
+    }
+    if (m_hHighMemory) {
+        CloseHandle(m_hHighMemory);
+        m_hHighMemory = nullptr;
+    }
+    m_Condition = Condition::Normal;
+}
+
+bool MemoryMonitor::Update()
+{
+    BOOL bState = FALSE;
+    VERIFY_WIN32(QueryMemoryResourceNotification(GetHandle(), &bState));
+    if (!bState) {
+        return false;
+    }
+
+    m_Condition = m_Condition == Condition::Low ? Condition::Normal : Condition::Low;
+    return true;
+}
+
+} // namespace ClipSock
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+namespace ClipSock {
+
+// MemoryMonitor tracks the system memory condition using resource
+// notifications. Notification handles remain signaled for as long as their
+// condition holds, so only the handle for the next transition is waited on:
+// low memory while the condition is normal, and high memory while it is low.
+class MemoryMonitor {
+public:
+    enum class Condition {
+        Normal,
+        Low
+    };
+
+    MemoryMonitor() = default;
+    ~MemoryMonitor();
+
+    MemoryMonitor(const MemoryMonitor&) = delete;
+    MemoryMonitor& operator=(const MemoryMonitor&) = delete;
+
+    void Open();
+    void Close();
+
+    bool IsOpen() const { return m_hLowMemory != nullptr; }
+
+    Condition GetCondition() const { return m_Condition; }
+
+    HANDLE GetHandle() const
+    {
+        return m_Condition == Condition::Low ? m_hHighMemory : m_hLowMemory;
+    }
+
+    // Update returns true if the condition changed:
+    bool Update();
+
+private:
+    HANDLE m_hLowMemory{nullptr};
+    HANDLE m_hHighMemory{nullptr};
+    Condition m_Condition{Condition::Normal};
+};
+
+} // namespace ClipSock
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "metrics.h"
+
+#include "util.h"
+
+#include <windows.h>
+
+#include <new>
+
+namespace ClipSock::Metrics {
+
+namespace {
+
+Layout LocalLayout;
+HANDLE hMapping;
+
+} // namespace
+
+Layout* pLayout{&LocalLayout};
+
+void Open()
+{
+    Close();
+
+    hMapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                 0, sizeof(Layout), MAPPING_NAME);
+    VERIFY_WIN32(hMapping);
+
+    auto pView = MapViewOfFile(hMapping, FILE_MAP_WRITE, 0, 0, sizeof(Layout));
+    if (!pView) {
+        auto upError = GetLastErrorMessageA();
+        Close();
+        THROW(upError.get());
+    }
+
+    // Values recorded before the mapping was opened are carried over:
+    auto pShared = new (pView) Layout{};
+    pShared->cMetrics = METRIC_COUNT;
+    pShared->dwProcessId = GetCurrentProcessId();
+    for (SIZE_T i = 0; i < METRIC_COUNT; i++) {
+        pShared->Slots[i].llValue.store(LocalLayout.Slots[i].llValue.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+    }
+    pShared->dwVersion.store(LAYOUT_VERSION, std::memory_order_release);
+    pLayout = pShared;
+}
+
+void Close()
+{
+    // Values are copied back to process-local storage so that metrics
+    // remain monotonic should the mapping be opened again:
+    if (pLayout != &LocalLayout) {
+        for (SIZE_T i = 0; i < METRIC_COUNT; i++) {
+            LocalLayout.Slots[i].llValue.store(pLayout->Slots[i].llValue.load(std::memory_order_relaxed),
+                                               std::memory_order_relaxed);
+        }
+        UnmapViewOfFile(pLayout);
+        pLayout = &LocalLayout;
+    }
+    if (hMapping) {
+        CloseHandle(hMapping);
+        hMapping = nullptr;
+    }
+}
+
+BOOL IsOpen()
+{
+    return pLayout != &LocalLayout;
+}
+
+} // namespace ClipSock::Metrics
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+
+namespace ClipSock::Metrics {
+
+// Metrics are published in a named mapping so that readers in other
+// processes may observe them without involving the server thread. Fields may
+// only be appended to the layout; the version changes if existing fields do:
+inline constexpr auto MAPPING_NAME = L"Local\\ClipSock.Metrics";
+inline constexpr DWORD LAYOUT_VERSION = 1;
+
+// Each metric occupies its own cache line to avoid false sharing between
+// the server and readers:
+inline constexpr auto CACHE_LINE_SIZE = 64;
+
+enum class Metric : UINT {
+    ConnectionsAccepted,
+    ConnectionsRejected,
+    ConnectionsRefused,
+    ConnectionsTimedOut,
+    BytesReceived,
+    Publications,
+    ParkedHits,
+    ParkedMisses,
+    BufferGrowths,
+    ConnectionsActive,
+    ConnectionsWaiting,
+    MemoryReserved,
+    ParkedBytes,
+    LatencyFirstByteP50,
+    LatencyFirstByteP99,
+    LatencyTransferP50,
+    LatencyTransferP99,
+    LatencyOpenP50,
+    LatencyOpenP99,
+    LatencyCommitP50,
+    LatencyCommitP99,
+    LatencyTotalP50,
+    LatencyTotalP99,
+    StartupSettingsLoaded,
+    StartupListening,
+    StartupTrayCreated,
+    StartupFirstAccept,
+    Count
+};
+
+enum class Kind {
+    Counter,
+    Gauge
+};
+
+struct Descriptor {
+    PCSTR szName;
+    Kind MetricKind;
+};
+
+inline constexpr Descriptor DESCRIPTORS[]{
+    {"connections_accepted", Kind::Counter},
+    {"connections_rejected", Kind::Counter},
+    {"connections_refused", Kind::Counter},
+    {"connections_timed_out", Kind::Counter},
+    {"bytes_received", Kind::Counter},
+    {"publications", Kind::Counter},
+    {"parked_hits", Kind::Counter},
+    {"parked_misses", Kind::Counter},
+    {"buffer_growths", Kind::Counter},
+    {"connections_active", Kind::Gauge},
+    {"connections_waiting", Kind::Gauge},
+    {"memory_reserved", Kind::Gauge},
+    {"parked_bytes", Kind::Gauge},
+    {"latency_first_byte_p50_us", Kind::Gauge},
+    {"latency_first_byte_p99_us", Kind::Gauge},
+    {"latency_transfer_p50_us", Kind::Gauge},
+    {"latency_transfer_p99_us", Kind::Gauge},
+    {"latency_open_p50_us", Kind::Gauge},
+    {"latency_open_p99_us", Kind::Gauge},
+    {"latency_commit_p50_us", Kind::Gauge},
+    {"latency_commit_p99_us", Kind::Gauge},
+    {"latency_total_p50_us", Kind::Gauge},
+    {"latency_total_p99_us", Kind::Gauge},
+    {"startup_settings_loaded_us", Kind::Gauge},
+    {"startup_listening_us", Kind::Gauge},
+    {"startup_tray_created_us", Kind::Gauge},
+    {"startup_first_accept_us", Kind::Gauge},
+};
+
+inline constexpr auto METRIC_COUNT = static_cast<SIZE_T>(Metric::Count);
+
+static_assert(ARRAYSIZE(DESCRIPTORS) == METRIC_COUNT);
+static_assert(std::atomic<LONGLONG>::is_always_lock_free);
+
+struct alignas(CACHE_LINE_SIZE) Slot {
+    std::atomic<LONGLONG> llValue;
+};
+
+// Readers must check the version before any other field; it is written last
+// once the layout has been initialized:
+struct alignas(CACHE_LINE_SIZE) Layout {
+    std::atomic<DWORD> dwVersion;
+    DWORD cMetrics;
+    DWORD dwProcessId;
+    Slot Slots[METRIC_COUNT];
+};
+
+// Metrics are recorded in process-local storage until the mapping is
+// opened, so updates never need to check whether it exists:
+extern Layout* pLayout;
+
+inline void Add(Metric Id, LONGLONG llDelta = 1)
+{
+    pLayout->Slots[static_cast<SIZE_T>(Id)].llValue.fetch_add(llDelta, std::memory_order_relaxed);
+}
+
+inline void Set(Metric Id, LONGLONG llValue)
+{
+    pLayout->Slots[static_cast<SIZE_T>(Id)].llValue.store(llValue, std::memory_order_relaxed);
+}
+
+inline LONGLONG Get(Metric Id)
+{
+    return pLayout->Slots[static_cast<SIZE_T>(Id)].llValue.load(std::memory_order_relaxed);
+}
+
+void Open();
+void Close();
+BOOL IsOpen();
+
+} // namespace ClipSock::Metrics
@@ -25,22 +25,32 @@
 
 #include "notify.h"
 
+#include "metrics.h"
 #include "resource.h"
 #include "server.h"
 #include "settings.h"
+#include "startup.h"
+#include "trace.h"
 #include "util.h"
 
 #include <windows.h>
 #include <windowsx.h>
 #include <shellapi.h>
 
+#include <exception>
 #include <format>
+#include <string>
+#include <string_view>
 
 namespace ClipSock::Notify {
 
 HICON hIcon;
 HMENU hContextMenu;
 PWSTR szVersion;
+std::atomic<HWND> hWindow;
+Mailbox<Status> StatusMailbox;
+std::atomic<BOOL> bUpdatePosted;
+ULONGLONG ullLastUpdate;
 
 void SetTip(NOTIFYICONDATA& nid, PCWSTR szText)
 {
@@ -49,6 +59,25 @@ void SetTip(NOTIFYICONDATA& nid, PCWSTR szText)
     *out = '\0';
 }
 
+std::wstring FormatStatus()
+{
+    // Latency is read from published metrics, which change too often to be
+    // sent as updates:
+    auto CurrentStatus = StatusMailbox.Read();
+    auto sStatus = std::wstring{CurrentStatus.szText[0] ? CurrentStatus.szText : L"Stopped"};
+    if (CurrentStatus.cConnections > 0) {
+        sStatus += std::format(L"\n{} active connections", CurrentStatus.cConnections);
+    }
+    if (Metrics::Get(Metrics::Metric::Publications) == 0) {
+        return sStatus;
+    }
+
+    auto llP50 = Metrics::Get(Metrics::Metric::LatencyTotalP50);
+    auto llP99 = Metrics::Get(Metrics::Metric::LatencyTotalP99);
+    return std::format(L"{}\nLatency p50 {:.1f} ms, p99 {:.1f} ms",
+                       sStatus, static_cast<double>(llP50) / 1000, static_cast<double>(llP99) / 1000);
+}
+
 void AddIcon(HWND hWnd)
 {
     NOTIFYICONDATA nid{
@@ -60,7 +89,7 @@ void AddIcon(HWND hWnd)
         .uVersion = NOTIFYICON_VERSION_4,
         .guidItem = __uuidof(Icon)
     };
-    SetTip(nid, L"Stopped");
+    SetTip(nid, FormatStatus().c_str());
     ASSERT_WIN32(Shell_NotifyIcon(NIM_ADD, &nid));
     ASSERT_WIN32(Shell_NotifyIcon(NIM_SETVERSION, &nid));
 }
@@ -77,6 +106,20 @@ void UpdateIcon(HWND hWnd, PCWSTR szText)
     ASSERT_WIN32(Shell_NotifyIcon(NIM_MODIFY, &nid));
 }
 
+void RefreshIcon(HWND hWnd)
+{
+    // Updates arriving within the interval are deferred to a single refresh
+    // once it elapses:
+    auto ullNow = GetTickCount64();
+    if (ullNow - ullLastUpdate < UPDATE_INTERVAL) {
+        SetTimer(hWnd, IDT_UPDATE, static_cast<UINT>(UPDATE_INTERVAL - (ullNow - ullLastUpdate)), nullptr);
+        return;
+    }
+
+    ullLastUpdate = ullNow;
+    UpdateIcon(hWnd, FormatStatus().c_str());
+}
+
 void DeleteIcon(HWND hWnd)
 {
     NOTIFYICONDATA nid{
@@ -100,12 +143,33 @@ void ShowContextMenu(HWND hWnd, POINT& pt)
     TrackPopupMenuEx(hMenu, uFlags, pt.x, pt.y, hWnd, nullptr);
 }
 
+void SaveTrace(HWND hWnd)
+{
+    WCHAR szFileName[MAX_PATH];
+    auto cchPath = GetTempPath(ARRAYSIZE(szFileName), szFileName);
+    ASSERT_WIN32(cchPath);
+
+    auto [out, _] = std::format_to_n(szFileName + cchPath, ARRAYSIZE(szFileName) - cchPath - 1,
+                                     L"ClipSock.trace.json");
+    *out = '\0';
+
+    try {
+        Trace::Save(szFileName);
+        MessageBox(hWnd, szFileName, L"ClipSock Trace Saved", MB_ICONINFORMATION);
+    }
+    catch (const std::exception& e) {
+        ShowError("Unable to save trace: {}", e.what());
+    }
+}
+
 LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
     switch (message) {
     case WM_CREATE:
+        hWindow = hWnd;
         AddIcon(hWnd);
-        Server::Start();
+        ASSERT_WIN32(SetTimer(hWnd, IDT_REFRESH, REFRESH_INTERVAL, nullptr));
+        Startup::Mark(Startup::Phase::TrayCreated);
         break;
 
     case WM_COMMAND:
@@ -114,6 +178,10 @@ LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lPara
             Settings::ShowDialog();
             break;
 
+        case IDM_SAVE_TRACE:
+            SaveTrace(hWnd);
+            break;
+
         case IDM_QUIT:
             DestroyWindow(hWnd);
             break;
@@ -134,15 +202,32 @@ LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lPara
         }
         break;
 
-    case WM_APP_UPDATE: {
-        auto szText = reinterpret_cast<PCWSTR>(wParam);
-        UpdateIcon(hWnd, szText);
+    case WM_APP_UPDATE:
+        // Updates written after this point post another message:
+        bUpdatePosted = FALSE;
+        RefreshIcon(hWnd);
+        break;
+
+    case WM_APP_RELOAD:
+        Settings::Reload();
+        break;
+
+    case WM_TIMER:
+        if (wParam == IDT_REFRESH) {
+            ullLastUpdate = GetTickCount64();
+            UpdateIcon(hWnd, FormatStatus().c_str());
+        } else if (wParam == IDT_UPDATE) {
+            KillTimer(hWnd, IDT_UPDATE);
+            RefreshIcon(hWnd);
+        }
         break;
-    }
 
     case WM_DESTROY:
+        KillTimer(hWnd, IDT_REFRESH);
+        KillTimer(hWnd, IDT_UPDATE);
         Server::Stop();
         DeleteIcon(hWnd);
+        hWindow = nullptr;
         PostQuitMessage(0);
         break;
 
@@ -153,12 +238,54 @@ LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lPara
     return 0;
 }
 
+void PostUpdate()
+{
+    // At most one update is posted until the window's thread handles it;
+    // the window reads the latest status rather than one carried by the
+    // message:
+    auto hWnd = hWindow.load();
+    if (hWnd && !bUpdatePosted.exchange(TRUE)) {
+        PostMessage(hWnd, WM_APP_UPDATE, 0, 0);
+    }
+}
+
 void SendUpdate(PCWSTR szText)
 {
-    auto hWnd = FindWindow(CLASSNAME, nullptr);
-    ASSERT_WIN32(hWnd);
+    auto bChanged = StatusMailbox.Update([szText](Status& CurrentStatus) {
+        if (std::wstring_view{CurrentStatus.szText} == szText) {
+            return FALSE;
+        }
+        auto [out, _] = std::format_to_n(CurrentStatus.szText, ARRAYSIZE(CurrentStatus.szText) - 1,
+                                         L"{}", szText);
+        *out = L'\0';
+        return TRUE;
+    });
+    if (bChanged) {
+        PostUpdate();
+    }
+}
+
+void SendConnections(LONGLONG cConnections)
+{
+    auto bChanged = StatusMailbox.Update([cConnections](Status& CurrentStatus) {
+        if (CurrentStatus.cConnections == cConnections) {
+            return FALSE;
+        }
+        CurrentStatus.cConnections = cConnections;
+        return TRUE;
+    });
+    if (bChanged) {
+        PostUpdate();
+    }
+}
 
-    SendMessage(hWnd, WM_APP_UPDATE, reinterpret_cast<WPARAM>(szText), 0);
+void PostReload()
+{
+    // Settings are reloaded by the window's thread, which owns them; the
+    // caller does not wait for the reload to complete:
+    if (auto hWnd = hWindow.load()) {
+        PostMessage(hWnd, WM_APP_RELOAD, 0, 0);
+    }
 }
 
 void LoadVersion(HINSTANCE hInstance, PCWSTR szName, PWSTR* pszVersion)
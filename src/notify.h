@@ -25,33 +25,67 @@
 
 #pragma once
 
+#include "mailbox.h"
+
 #include <windows.h>
 #include <shellapi.h>
 
+#include <atomic>
+#include <string>
+
 namespace ClipSock::Notify {
 
 inline constexpr auto CLASSNAME = L"Notify Window Class";
 
 inline constexpr auto WM_APP_NOTIFY = WM_APP + 0;
 inline constexpr auto WM_APP_UPDATE = WM_APP + 1;
+inline constexpr auto WM_APP_RELOAD = WM_APP + 2;
+
+inline constexpr auto IDT_REFRESH = 1;
+inline constexpr auto IDT_UPDATE = 2;
+inline constexpr auto REFRESH_INTERVAL = 5 * 1000; // milliseconds
+
+// Status updates are coalesced so that the tooltip is refreshed at most
+// once per interval regardless of how often the server reports:
+inline constexpr auto UPDATE_INTERVAL = 250; // milliseconds
+inline constexpr auto STATUS_LENGTH = 128; // characters, including terminator
+
+// Status is written by any thread and read by the window's thread when
+// refreshing the tooltip:
+struct Status {
+    WCHAR szText[STATUS_LENGTH];
+    LONGLONG cConnections;
+};
 
 class __declspec(uuid("7E8EDDD8-0A70-46FC-963F-F513CF8D7561")) Icon;
 
 extern HICON hIcon;
 extern HMENU hContextMenu;
 extern PWSTR szVersion;
+// The window is read by the server thread when posting updates:
+extern std::atomic<HWND> hWindow;
+extern Mailbox<Status> StatusMailbox;
+extern std::atomic<BOOL> bUpdatePosted;
+extern ULONGLONG ullLastUpdate;
 
 void SetTip(NOTIFYICONDATA& nid, PCWSTR szText);
 
+std::wstring FormatStatus();
+
 void AddIcon(HWND hWnd);
 void UpdateIcon(HWND hWnd, PCWSTR szText);
+void RefreshIcon(HWND hWnd);
 void DeleteIcon(HWND hWnd);
 
 void ShowContextMenu(HWND hWnd, POINT& pt);
+void SaveTrace(HWND hWnd);
 
 LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
+void PostUpdate();
 void SendUpdate(PCWSTR szText);
+void SendConnections(LONGLONG cConnections);
+void PostReload();
 
 void LoadVersion(HINSTANCE hInstance, PCWSTR szName, PWSTR* pszVersion);
 
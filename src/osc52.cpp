@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "osc52.h"
+
+#include "base64.h"
+#include "protocol.h"
+#include "util.h"
+
+#include <windows.h>
+
+namespace ClipSock::Osc52 {
+
+SIZE_T Decoder::Decode(CHAR* pData, SIZE_T cbData)
+{
+    SIZE_T cbIn = 0;
+    SIZE_T cbOut = 0;
+    while (cbIn < cbData && m_State != State::Complete) {
+        switch (m_State) {
+        case State::Prefix:
+            VERIFY(pData[cbIn++] == Protocol::OSC52_PREFIX[m_cbPrefix], "Invalid OSC 52 prefix");
+            if (++m_cbPrefix == ARRAYSIZE(Protocol::OSC52_PREFIX)) {
+                m_State = State::Selection;
+            }
+            break;
+
+        case State::Selection:
+            if (pData[cbIn++] == ';') {
+                m_State = State::Payload;
+            }
+            break;
+
+        case State::Payload: {
+            // Whole quartets are decoded in bulk whenever the decoder is
+            // aligned on a quartet boundary:
+            if (m_cBits == 0) {
+                auto cbDecoded = Base64::DecodeQuartets(pData + cbIn, cbData - cbIn, pData + cbOut);
+                cbIn += cbDecoded;
+                cbOut += cbDecoded / 4 * 3;
+                if (cbIn == cbData) {
+                    break;
+                }
+            }
+
+            auto ch = pData[cbIn++];
+            if (ch == BEL || ch == ESC) {
+                m_State = State::Complete;
+                break;
+            }
+
+            // Padding discards any remaining bits in the current quartet:
+            if (ch == '=') {
+                m_uBits = 0;
+                m_cBits = 0;
+                break;
+            }
+
+            auto nValue = Base64::DecodeChar(ch);
+            VERIFY(nValue >= 0, "Invalid base64 character: {:#04x}", int{ch});
+
+            // Bytes are emitted as soon as they are complete, so fewer than
+            // eight bits remain pending between chunks:
+            m_uBits = m_uBits << 6 | static_cast<UINT32>(nValue);
+            m_cBits += 6;
+            if (m_cBits >= 8) {
+                m_cBits -= 8;
+                pData[cbOut++] = static_cast<CHAR>(m_uBits >> m_cBits);
+                m_uBits &= (1u << m_cBits) - 1;
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+    return cbOut;
+}
+
+} // namespace ClipSock::Osc52
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+namespace ClipSock::Osc52 {
+
+inline constexpr CHAR BEL = '\x07';
+inline constexpr CHAR ESC = '\x1B';
+
+// Decoder incrementally decodes an OSC 52 sequence of the form:
+//
+//   ESC ] 52 ; <selection> ; <base64> (BEL | ESC \)
+//
+// Data is decoded in place; decoded bytes never overtake unread input, which
+// allows a receive buffer to be rewritten as each chunk arrives. Anything
+// following the terminator is ignored.
+class Decoder {
+public:
+    // Decode consumes cbData bytes at pData, writes decoded bytes to the
+    // start of pData, and returns the number of bytes written:
+    SIZE_T Decode(CHAR* pData, SIZE_T cbData);
+
+    bool IsComplete() const { return m_State == State::Complete; }
+
+private:
+    enum class State {
+        Prefix,
+        Selection,
+        Payload,
+        Complete
+    };
+
+    State m_State{State::Prefix};
+    SIZE_T m_cbPrefix{0};
+    UINT32 m_uBits{0};
+    UINT m_cBits{0};
+};
+
+} // namespace ClipSock::Osc52
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "peer.h"
+
+#include "util.h"
+
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <cwctype>
+
+namespace ClipSock::Peer {
+
+namespace {
+
+constexpr BYTE MAPPED_PREFIX[]{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF};
+constexpr BYTE MAPPED_BITS = ARRAYSIZE(MAPPED_PREFIX) * 8;
+
+// Prefixes are reported in error messages, which are narrow; anything
+// outside of ASCII cannot be part of a valid prefix:
+std::string ToAscii(std::wstring_view svText)
+{
+    std::string sText;
+    for (auto ch : svText) {
+        sText.push_back(ch < 0x80 ? static_cast<CHAR>(ch) : '?');
+    }
+    return sText;
+}
+
+} // namespace
+
+SIZE_T AddressHash::operator()(const Address& PeerAddress) const
+{
+    return std::hash<std::string_view>{}({reinterpret_cast<const CHAR*>(PeerAddress.data()),
+                                          PeerAddress.size()});
+}
+
+Address GetAddress(const SOCKADDR_STORAGE& Storage)
+{
+    Address PeerAddress{};
+    if (Storage.ss_family == AF_INET) {
+        auto& Addr = reinterpret_cast<const SOCKADDR_IN&>(Storage).sin_addr;
+        std::copy(std::begin(MAPPED_PREFIX), std::end(MAPPED_PREFIX), PeerAddress.begin());
+        std::copy_n(reinterpret_cast<const BYTE*>(&Addr), sizeof(Addr),
+                    PeerAddress.begin() + ARRAYSIZE(MAPPED_PREFIX));
+    } else if (Storage.ss_family == AF_INET6) {
+        auto& Addr = reinterpret_cast<const SOCKADDR_IN6&>(Storage).sin6_addr;
+        std::copy_n(reinterpret_cast<const BYTE*>(&Addr), sizeof(Addr), PeerAddress.begin());
+    }
+    return PeerAddress;
+}
+
+std::string FormatAddress(const Address& PeerAddress)
+{
+    CHAR szAddress[INET6_ADDRSTRLEN]{};
+    if (std::equal(std::begin(MAPPED_PREFIX), std::end(MAPPED_PREFIX), PeerAddress.begin())) {
+        inet_ntop(AF_INET, PeerAddress.data() + ARRAYSIZE(MAPPED_PREFIX), szAddress, ARRAYSIZE(szAddress));
+    } else {
+        inet_ntop(AF_INET6, PeerAddress.data(), szAddress, ARRAYSIZE(szAddress));
+    }
+    return szAddress;
+}
+
+BOOL IsLoopback(const Address& PeerAddress)
+{
+    // IPv4 reserves 127.0.0.0/8 for loopback, whereas IPv6 only has ::1:
+    constexpr Address LOOPBACK_IPV6{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+    if (std::equal(std::begin(MAPPED_PREFIX), std::end(MAPPED_PREFIX), PeerAddress.begin())) {
+        return PeerAddress[ARRAYSIZE(MAPPED_PREFIX)] == 127;
+    }
+    return PeerAddress == LOOPBACK_IPV6;
+}
+
+Prefix ParsePrefix(std::wstring_view svPrefix)
+{
+    auto nSlash = svPrefix.find(L'/');
+    std::wstring sAddress{svPrefix.substr(0, nSlash)};
+
+    // Addresses without a prefix length match a single host:
+    Prefix PeerPrefix{};
+    BYTE cMaximumBits;
+    if (InetPtonW(AF_INET, sAddress.c_str(), PeerPrefix.PrefixAddress.data() + ARRAYSIZE(MAPPED_PREFIX)) == 1) {
+        std::copy(std::begin(MAPPED_PREFIX), std::end(MAPPED_PREFIX), PeerPrefix.PrefixAddress.begin());
+        cMaximumBits = 32;
+    } else if (InetPtonW(AF_INET6, sAddress.c_str(), PeerPrefix.PrefixAddress.data()) == 1) {
+        cMaximumBits = 128;
+    } else {
+        THROW("Invalid address: {}", ToAscii(sAddress));
+    }
+
+    auto cBits = static_cast<UINT>(cMaximumBits);
+    if (nSlash != std::wstring_view::npos) {
+        auto svBits = svPrefix.substr(nSlash + 1);
+        VERIFY(!svBits.empty() && svBits.size() <= 3 &&
+               std::all_of(svBits.begin(), svBits.end(), [](auto ch) { return std::iswdigit(ch); }),
+               "Invalid prefix length: {}", ToAscii(svPrefix));
+        cBits = 0;
+        for (auto ch : svBits) {
+            cBits = cBits * 10 + static_cast<UINT>(ch - L'0');
+        }
+        VERIFY(cBits <= cMaximumBits, "Invalid prefix length: {}", ToAscii(svPrefix));
+    }
+
+    PeerPrefix.cBits = static_cast<BYTE>(cMaximumBits == 32 ? cBits + MAPPED_BITS : cBits);
+    return PeerPrefix;
+}
+
+} // namespace ClipSock::Peer
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <winsock2.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace ClipSock::Peer {
+
+// Addresses are normalized to IPv6, with IPv4 addresses mapped, so that
+// peers of either family share a single key type:
+using Address = std::array<BYTE, 16>;
+
+// Prefixes are expressed in bits of the normalized address; IPv4 prefix
+// lengths are offset by the length of the mapped prefix:
+struct Prefix {
+    Address PrefixAddress;
+    BYTE cBits;
+};
+
+struct AddressHash {
+    SIZE_T operator()(const Address& PeerAddress) const;
+};
+
+Address GetAddress(const SOCKADDR_STORAGE& Storage);
+
+std::string FormatAddress(const Address& PeerAddress);
+
+BOOL IsLoopback(const Address& PeerAddress);
+
+Prefix ParsePrefix(std::wstring_view svPrefix);
+
+} // namespace ClipSock::Peer
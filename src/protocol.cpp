@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "protocol.h"
+
+#include "util.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+namespace ClipSock::Protocol {
+
+namespace {
+
+template<typename T>
+T GetValue(std::string_view svData, SIZE_T uOffset)
+{
+    VERIFY(uOffset + sizeof(T) <= svData.size(),
+           "Truncated frame: {} < {}", svData.size(), uOffset + sizeof(T));
+
+    T Value{0};
+    for (auto i = 0u; i < sizeof(T); i++) {
+        Value |= T{static_cast<UINT8>(svData[uOffset + i])} << (8 * i);
+    }
+    return Value;
+}
+
+template<typename T>
+void PutValue(std::string& sData, T Value)
+{
+    for (auto i = 0u; i < sizeof(T); i++) {
+        sData.push_back(static_cast<CHAR>((Value >> (8 * i)) & 0xFF));
+    }
+}
+
+} // namespace
+
+Mode Classify(std::string_view svData)
+{
+    if (svData.empty()) {
+        return Mode::Unknown;
+    }
+
+    // Compare as much of the OSC 52 prefix as has been received so far:
+    auto svPrefix = std::string_view{OSC52_PREFIX, ARRAYSIZE(OSC52_PREFIX)};
+    if (svData.front() == svPrefix.front()) {
+        auto cbCompare = std::min(svData.size(), svPrefix.size());
+        if (svData.substr(0, cbCompare) != svPrefix.substr(0, cbCompare)) {
+            return Mode::Raw;
+        }
+        return svData.size() < svPrefix.size() ? Mode::Unknown : Mode::Osc52;
+    }
+
+    // Likewise for the frame magic; any mismatch is treated as plain text to
+    // remain compatible with netcat:
+    auto svMagic = std::string_view{FRAME_MAGIC, ARRAYSIZE(FRAME_MAGIC)};
+    auto cbCompare = std::min(svData.size(), svMagic.size());
+    if (svData.substr(0, cbCompare) != svMagic.substr(0, cbCompare)) {
+        return Mode::Raw;
+    }
+
+    if (svData.size() < FRAME_PREFIX_SIZE) {
+        return Mode::Unknown;
+    }
+
+    auto chType = svData[ARRAYSIZE(FRAME_MAGIC)];
+    switch (chType) {
+    case FRAME_DELTA:
+        return Mode::Delta;
+
+    case FRAME_RESUME:
+        return Mode::Resume;
+
+    default:
+        THROW("Unsupported frame type: {:#04x}", int{chType});
+    }
+}
+
+ResumeHeader GetResumeHeader(std::string_view svFrame)
+{
+    return {
+        .ullTransferId = GetUInt64(svFrame, FRAME_PREFIX_SIZE),
+        .cbLength = GetUInt32(svFrame, FRAME_PREFIX_SIZE + sizeof(UINT64))
+    };
+}
+
+UINT32 GetUInt32(std::string_view svData, SIZE_T uOffset)
+{
+    return GetValue<UINT32>(svData, uOffset);
+}
+
+UINT64 GetUInt64(std::string_view svData, SIZE_T uOffset)
+{
+    return GetValue<UINT64>(svData, uOffset);
+}
+
+void PutUInt32(std::string& sData, UINT32 uValue)
+{
+    PutValue(sData, uValue);
+}
+
+void PutUInt64(std::string& sData, UINT64 uValue)
+{
+    PutValue(sData, uValue);
+}
+
+} // namespace ClipSock::Protocol
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <string>
+#include <string_view>
+
+namespace ClipSock::Protocol {
+
+// Framed connections are distinguished from plain text by a leading NUL,
+// which never appears in CF_TEXT clipboard data:
+inline constexpr CHAR FRAME_MAGIC[]{'\0', 'C', 'S'};
+inline constexpr auto FRAME_PREFIX_SIZE = ARRAYSIZE(FRAME_MAGIC) + 1;
+
+inline constexpr CHAR FRAME_DELTA = 'D';
+inline constexpr CHAR FRAME_RESUME = 'R';
+
+inline constexpr CHAR STATUS_ACCEPTED = '+';
+inline constexpr CHAR STATUS_REJECTED = '-';
+
+// Terminal multiplexers forward clipboard writes as OSC 52 escape sequences,
+// which are decoded rather than stored verbatim:
+inline constexpr CHAR OSC52_PREFIX[]{'\x1B', ']', '5', '2', ';'};
+
+enum class Mode {
+    Unknown,
+    Raw,
+    Delta,
+    Resume,
+    Osc52
+};
+
+// A resume frame identifies a transfer chosen by the client and its total
+// length. The server replies with the number of bytes it already holds for
+// the transfer, after which the client sends the remainder:
+inline constexpr auto RESUME_HEADER_SIZE = FRAME_PREFIX_SIZE + sizeof(UINT64) + sizeof(UINT32);
+
+struct ResumeHeader {
+    UINT64 ullTransferId;
+    UINT32 cbLength;
+};
+
+ResumeHeader GetResumeHeader(std::string_view svFrame);
+
+Mode Classify(std::string_view svData);
+
+UINT32 GetUInt32(std::string_view svData, SIZE_T uOffset);
+UINT64 GetUInt64(std::string_view svData, SIZE_T uOffset);
+
+void PutUInt32(std::string& sData, UINT32 uValue);
+void PutUInt64(std::string& sData, UINT64 uValue);
+
+} // namespace ClipSock::Protocol
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+
+namespace ClipSock {
+
+// BoundedQueue is a bounded multiple-producer, single-consumer queue.
+// Producers claim a cell without locking; each cell is guarded by a sequence
+// number so that the consumer only sees completely written entries.
+template<typename T, SIZE_T Capacity>
+class BoundedQueue {
+public:
+    BoundedQueue()
+    {
+        for (SIZE_T i = 0; i < Capacity; i++) {
+            m_Cells[i].ullSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    BOOL TryPush(const T& Entry)
+    {
+        auto ullTail = m_ullTail.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& Cell = m_Cells[ullTail % Capacity];
+            auto ullSequence = Cell.ullSequence.load(std::memory_order_acquire);
+            if (ullSequence == ullTail) {
+                if (m_ullTail.compare_exchange_weak(ullTail, ullTail + 1, std::memory_order_relaxed)) {
+                    Cell.Entry = Entry;
+                    Cell.ullSequence.store(ullTail + 1, std::memory_order_release);
+                    return TRUE;
+                }
+            } else if (ullSequence < ullTail) {
+                return FALSE; // full
+            } else {
+                ullTail = m_ullTail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // TryPop may only be called from a single consumer:
+    BOOL TryPop(T& Entry)
+    {
+        auto& Cell = m_Cells[m_ullHead % Capacity];
+        if (Cell.ullSequence.load(std::memory_order_acquire) != m_ullHead + 1) {
+            return FALSE; // empty
+        }
+        Entry = Cell.Entry;
+        Cell.ullSequence.store(m_ullHead + Capacity, std::memory_order_release);
+        m_ullHead++;
+        return TRUE;
+    }
+
+private:
+    struct Cell {
+        std::atomic<ULONGLONG> ullSequence;
+        T Entry;
+    };
+
+    std::atomic<ULONGLONG> m_ullTail{0};
+    ULONGLONG m_ullHead{0};
+    Cell m_Cells[Capacity];
+};
+
+} // namespace ClipSock
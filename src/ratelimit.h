@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <algorithm>
+
+namespace ClipSock {
+
+// TokenBucket permits an average number of tokens per second with bursts of
+// up to its capacity. Consume may overdraw the bucket, after which no tokens
+// are available until the debt has been repaid. Tokens are tracked in
+// thousandths to avoid accumulating rounding error at millisecond
+// resolution. Time is supplied by the caller to simplify testing.
+class TokenBucket {
+public:
+    TokenBucket(ULONGLONG ullRate, ULONGLONG ullCapacity)
+        : m_llRate{static_cast<LONGLONG>(ullRate)},
+          m_llCapacity{static_cast<LONGLONG>(ullCapacity) * SCALE},
+          m_llTokens{m_llCapacity}
+    {
+    }
+
+    bool TryConsume(ULONGLONG cTokens, ULONGLONG ullNow)
+    {
+        Refill(ullNow);
+        auto llCost = static_cast<LONGLONG>(cTokens) * SCALE;
+        if (m_llTokens < llCost) {
+            return false;
+        }
+        m_llTokens -= llCost;
+        return true;
+    }
+
+    void Consume(ULONGLONG cTokens, ULONGLONG ullNow)
+    {
+        Refill(ullNow);
+        m_llTokens -= static_cast<LONGLONG>(cTokens) * SCALE;
+    }
+
+    // GetDelay returns the number of milliseconds until the bucket is no
+    // longer overdrawn:
+    ULONGLONG GetDelay(ULONGLONG ullNow)
+    {
+        Refill(ullNow);
+        if (m_llTokens >= 0) {
+            return 0;
+        }
+        return static_cast<ULONGLONG>((-m_llTokens + m_llRate - 1) / m_llRate);
+    }
+
+    bool IsFull(ULONGLONG ullNow)
+    {
+        Refill(ullNow);
+        return m_llTokens == m_llCapacity;
+    }
+
+private:
+    static constexpr LONGLONG SCALE = 1000;
+
+    void Refill(ULONGLONG ullNow)
+    {
+        if (ullNow <= m_ullUpdated) {
+            return;
+        }
+
+        // A rate in tokens per second is equivalent to thousandths of a
+        // token per millisecond; elapsed time is capped to avoid overflow:
+        auto llMaximum = (m_llCapacity - m_llTokens) / m_llRate + 1;
+        auto llElapsed = static_cast<LONGLONG>(std::min<ULONGLONG>(ullNow - m_ullUpdated, llMaximum));
+        m_llTokens = std::min(m_llCapacity, m_llTokens + llElapsed * m_llRate);
+        m_ullUpdated = ullNow;
+    }
+
+    LONGLONG m_llRate;
+    LONGLONG m_llCapacity;
+    LONGLONG m_llTokens;
+    ULONGLONG m_ullUpdated{0};
+};
+
+} // namespace ClipSock
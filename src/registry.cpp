@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "registry.h"
+
+#include "util.h"
+
+#include <windows.h>
+
+namespace ClipSock {
+
+RegistryMonitor::~RegistryMonitor()
+{
+    Close();
+}
+
+bool RegistryMonitor::Open(HKEY hRootKey, PCWSTR szSubKey)
+{
+    Close();
+
+    auto dwResult = RegOpenKeyEx(hRootKey, szSubKey, 0, KEY_NOTIFY, &m_hKey);
+    if (dwResult == ERROR_FILE_NOT_FOUND) {
+        m_hKey = nullptr;
+        return false;
+    }
+    VERIFY_WIN32_RESULT(dwResult);
+
+    m_hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!m_hEvent) {
+        auto dwError = GetLastError();
+        Close();
+        VERIFY_WIN32_RESULT(dwError);
+    }
+
+    try {
+        Update();
+    }
+    catch (...) {
+        Close();
+        throw;
+    }
+    return true;
+}
+
+void RegistryMonitor::Close()
+{
+    if (m_hKey) {
+        RegCloseKey(m_hKey);
+        m_hKey = nullptr;
+    }
+    if (m_hEvent) {
+        CloseHandle(m_hEvent);
+        m_hEvent = nullptr;
+    }
+}
+
+void RegistryMonitor::Update()
+{
+    // Changes made before the notification is rearmed are not reported
+    // again; callers should read the key after calling Update so that none
+    // are missed:
+    ResetEvent(m_hEvent);
+    VERIFY_WIN32_RESULT(RegNotifyChangeKeyValue(m_hKey, FALSE,
+                                                REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC,
+                                                m_hEvent, TRUE));
+}
+
+} // namespace ClipSock
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#pragma once
+
+#include <windows.h>
+
+namespace ClipSock {
+
+// RegistryMonitor signals its handle when values of a registry key change.
+// Notifications are thread agnostic so that the key may be opened by one
+// thread and waited on by another; each notification must be rearmed by
+// calling Update once the handle is signaled.
+class RegistryMonitor {
+public:
+    RegistryMonitor() = default;
+    ~RegistryMonitor();
+
+    RegistryMonitor(const RegistryMonitor&) = delete;
+    RegistryMonitor& operator=(const RegistryMonitor&) = delete;
+
+    // Open returns false if the key does not exist:
+    bool Open(HKEY hRootKey, PCWSTR szSubKey);
+    void Close();
+
+    bool IsOpen() const { return m_hKey != nullptr; }
+
+    HANDLE GetHandle() const { return m_hEvent; }
+
+    void Update();
+
+private:
+    HKEY m_hKey{nullptr};
+    HANDLE m_hEvent{nullptr};
+};
+
+} // namespace ClipSock
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "resolver.h"
+
+#include "util.h"
+
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windns.h>
+#include <iphlpapi.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace ClipSock {
+
+namespace {
+
+void AddAddress(AddressList& Addresses, const SOCKADDR* pAddress, SIZE_T cbAddress)
+{
+    SOCKADDR_STORAGE Address{};
+    std::memcpy(&Address, pAddress, std::min(cbAddress, sizeof(Address)));
+
+    // Names commonly resolve to the same address once per socket type;
+    // storage is zeroed beyond each address so entries compare bytewise:
+    auto IsSame = [&Address](const SOCKADDR_STORAGE& Entry) {
+        return std::memcmp(&Entry, &Address, sizeof(Address)) == 0;
+    };
+    if (std::ranges::none_of(Addresses, IsSame)) {
+        Addresses.push_back(Address);
+    }
+}
+
+} // namespace
+
+int GetAddressLength(const SOCKADDR_STORAGE& Address)
+{
+    return Address.ss_family == AF_INET6 ? sizeof(SOCKADDR_IN6) : sizeof(SOCKADDR_IN);
+}
+
+BOOL IsSameAddress(const SOCKADDR_STORAGE& Left, const SOCKADDR_STORAGE& Right)
+{
+    return std::memcmp(&Left, &Right, sizeof(Left)) == 0;
+}
+
+BOOL IsSameAddresses(const AddressList& Left, const AddressList& Right)
+{
+    return std::ranges::equal(Left, Right, IsSameAddress);
+}
+
+BOOL IsValidAddress(PCWSTR szAddress)
+{
+    NET_ADDRESS_INFO AddressInfo;
+    if (ParseNetworkString(szAddress, NET_STRING_ANY_SERVICE,
+                           &AddressInfo, nullptr, nullptr) != ERROR_SUCCESS) {
+        return FALSE;
+    }
+    return AddressInfo.Format == NET_ADDRESS_DNS_NAME ||
+           AddressInfo.Format == NET_ADDRESS_IPV4 ||
+           AddressInfo.Format == NET_ADDRESS_IPV6;
+}
+
+Resolver::~Resolver()
+{
+    Cancel();
+}
+
+AddressList Resolver::Begin(PCWSTR szAddress, DWORD dwTimeout)
+{
+    Cancel();
+
+    m_sAddress = szAddress;
+    VERIFY_WIN32_RESULT(ParseNetworkString(szAddress, NET_STRING_ANY_SERVICE,
+                                           &m_AddressInfo, nullptr, nullptr));
+
+    AddressList Addresses;
+    switch (m_AddressInfo.Format) {
+    case NET_ADDRESS_DNS_NAME:
+        break;
+
+    case NET_ADDRESS_IPV4:
+        AddAddress(Addresses, &m_AddressInfo.IpAddress, sizeof(SOCKADDR_IN));
+        return Addresses;
+
+    case NET_ADDRESS_IPV6:
+        AddAddress(Addresses, &m_AddressInfo.IpAddress, sizeof(SOCKADDR_IN6));
+        return Addresses;
+
+    default:
+        THROW("Unsupported address format: {}", int{m_AddressInfo.Format});
+    }
+
+    m_hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    VERIFY_WIN32(m_hEvent);
+
+    const ADDRINFOEXW Hints{
+        .ai_flags = AI_PASSIVE,
+        .ai_family = AF_UNSPEC,
+        .ai_socktype = SOCK_STREAM,
+        .ai_protocol = IPPROTO_TCP
+    };
+    m_Timeout = {
+        .tv_sec = static_cast<long>(dwTimeout / 1000),
+        .tv_usec = static_cast<long>(dwTimeout % 1000 * 1000)
+    };
+    m_Overlapped = {.hEvent = m_hEvent};
+    m_bPending = TRUE;
+
+    // Resolution completing before the call returns does not signal the
+    // event; the result is retained and the event signaled here so that
+    // callers complete resolution the same way in either case:
+    auto dwResult = static_cast<DWORD>(GetAddrInfoExW(m_AddressInfo.NamedAddress.Address,
+                                                      m_AddressInfo.NamedAddress.Port,
+                                                      NS_DNS, nullptr, &Hints, &m_pResult,
+                                                      &m_Timeout, &m_Overlapped, nullptr,
+                                                      &m_hCancel));
+    if (dwResult != WSA_IO_PENDING) {
+        m_dwResult = dwResult == NO_ERROR ? ERROR_SUCCESS : dwResult;
+        m_hCancel = nullptr;
+        SetEvent(m_hEvent);
+    }
+    return Addresses;
+}
+
+void Resolver::Cancel()
+{
+    if (!m_bPending) {
+        return;
+    }
+
+    // Results are written until the completion event is signaled, so
+    // cancellation must wait for it before releasing them:
+    if (m_hCancel) {
+        GetAddrInfoExCancel(&m_hCancel);
+    }
+    WaitForSingleObject(m_hEvent, INFINITE);
+    Reset();
+}
+
+Win32Result<AddressList> Resolver::Complete()
+{
+    if (m_hCancel) {
+        m_dwResult = static_cast<DWORD>(GetAddrInfoExOverlappedResult(&m_Overlapped));
+    }
+
+    auto dwResult = m_dwResult;
+    AddressList Addresses;
+    if (dwResult == ERROR_SUCCESS) {
+        for (auto pEntry = m_pResult; pEntry; pEntry = pEntry->ai_next) {
+            if (pEntry->ai_family == AF_INET || pEntry->ai_family == AF_INET6) {
+                AddAddress(Addresses, pEntry->ai_addr, pEntry->ai_addrlen);
+            }
+        }
+        if (Addresses.empty()) {
+            dwResult = WSAHOST_NOT_FOUND;
+        }
+    }
+    Reset();
+
+    if (dwResult != ERROR_SUCCESS) {
+        return Win32Error{dwResult};
+    }
+    return Addresses;
+}
+
+void Resolver::Reset()
+{
+    if (m_pResult) {
+        FreeAddrInfoExW(m_pResult);
+        m_pResult = nullptr;
+    }
+    if (m_hEvent) {
+        CloseHandle(m_hEvent);
+        m_hEvent = nullptr;
+    }
+    m_hCancel = nullptr;
+    m_dwResult = ERROR_SUCCESS;
+    m_bPending = FALSE;
+}
+
+} // namespace ClipSock
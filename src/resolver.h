@@ -0,0 +1,88 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#pragma once
+
+#include "util.h"
+
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+
+#include <string>
+#include <vector>
+
+namespace ClipSock {
+
+using AddressList = std::vector<SOCKADDR_STORAGE>;
+
+int GetAddressLength(const SOCKADDR_STORAGE& Address);
+
+BOOL IsSameAddress(const SOCKADDR_STORAGE& Left, const SOCKADDR_STORAGE& Right);
+BOOL IsSameAddresses(const AddressList& Left, const AddressList& Right);
+
+BOOL IsValidAddress(PCWSTR szAddress);
+
+// Resolver resolves listen addresses without blocking the caller. Numeric
+// addresses are returned by Begin; host names are resolved by GetAddrInfoExW,
+// which signals the completion event once results are available or the
+// timeout elapses. Results are returned in order with duplicates removed:
+class Resolver {
+public:
+    Resolver() = default;
+    ~Resolver();
+
+    Resolver(const Resolver&) = delete;
+    Resolver& operator=(const Resolver&) = delete;
+
+    // Begin returns an empty list if resolution is pending:
+    AddressList Begin(PCWSTR szAddress, DWORD dwTimeout);
+    void Cancel();
+
+    BOOL IsPending() const { return m_bPending; }
+
+    HANDLE GetHandle() const { return m_hEvent; }
+
+    const std::wstring& GetAddress() const { return m_sAddress; }
+
+    // Complete returns the result of a pending resolution once the
+    // completion event is signaled:
+    Win32Result<AddressList> Complete();
+
+private:
+    void Reset();
+
+    std::wstring m_sAddress;
+    NET_ADDRESS_INFO m_AddressInfo{};
+    timeval m_Timeout{};
+    OVERLAPPED m_Overlapped{};
+    HANDLE m_hEvent{nullptr};
+    HANDLE m_hCancel{nullptr};
+    PADDRINFOEXW m_pResult{nullptr};
+    DWORD m_dwResult{ERROR_SUCCESS};
+    BOOL m_bPending{FALSE};
+};
+
+} // namespace ClipSock
@@ -26,44 +26,406 @@
 #include "server.h"
 
 #include "buffer.h"
+#include "delta.h"
 #include "eventlog.h"
 #include "messages.h"
+#include "metrics.h"
 #include "notify.h"
+#include "osc52.h"
+#include "peer.h"
+#include "protocol.h"
 #include "settings.h"
+#include "startup.h"
+#include "transform.h"
 #include "util.h"
 
 #include <windows.h>
 #include <winsock2.h>
 #include <ws2tcpip.h>
-#include <windns.h>
-#include <iphlpapi.h>
 
 #include <algorithm>
+#include <cstring>
 #include <cstdlib>
 #include <exception>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace ClipSock::Server {
 
 EventLogger Logger;
 HANDLE hThread;
 BOOL bStopRequested;
+CommandQueue Commands;
+HANDLE hCommandEvent;
 EventVector Events;
+EventVector Listeners;
+AddressList ListenAddresses;
+EventAddressMap ListenerAddresses;
 EventSocketMap Sockets;
 EventBufferMap Buffers;
+EventStateMap States;
+SnapshotPtr spSnapshot;
+SRWLOCK SnapshotLock = SRWLOCK_INIT;
+TransferCache Transfers{MAXIMUM_PARKED_BYTES, MAXIMUM_PARKED_TRANSFERS, PARKED_TRANSFER_TIMEOUT};
+SIZE_T cbParked;
+EventTimerWheel Timers{CONNECTION_TIMER_RESOLUTION};
+PeerMap Peers;
+MemoryBudget Budget{static_cast<SIZE_T>(Settings::DEFAULT_MEMORY_BUDGET) * 1024 * 1024};
+SIZE_T cbBudgetLimit{static_cast<SIZE_T>(Settings::DEFAULT_MEMORY_BUDGET) * 1024 * 1024};
+DWORD dwTransformFlags;
+SizeHistogram BufferSizes{BUFFER_SIZE_WINDOW};
+LatencyArray Latencies;
+PublicationPool Workers{Prepare};
+PublicationSequencer Publications{Commit};
+EventQueue Waiters;
+MemoryMonitor Monitor;
+Resolver ListenResolver;
+RegistryMonitor SettingsMonitor;
+ULONGLONG ullReloadDeadline;
+ResolvedAddress LastResolved;
+AccessTrie AccessList;
+BOOL bAllowUnlisted{TRUE};
+ServerCounters Counters;
+ULONGLONG ullNextRejectionReport;
+ULONGLONG cRejectionsSuppressed;
+
+void ParseAccessList(std::wstring_view svList, AccessTrie& Rules, BOOL& bUnlisted)
+{
+    Rules.Clear();
+    bUnlisted = TRUE;
+
+    // Entries are separated by whitespace, commas, or semicolons; a leading
+    // '!' denies the prefix. The longest matching prefix wins, and unlisted
+    // peers are only allowed if no prefix is explicitly allowed:
+    constexpr std::wstring_view svSeparators{L" \t,;"};
+    for (SIZE_T nStart = 0; nStart < svList.size();) {
+        auto nEnd = std::min(svList.find_first_of(svSeparators, nStart), svList.size());
+        auto svEntry = svList.substr(nStart, nEnd - nStart);
+        nStart = nEnd + 1;
+        if (svEntry.empty()) {
+            continue;
+        }
+
+        auto bAllow = svEntry.front() != L'!';
+        if (!bAllow) {
+            svEntry.remove_prefix(1);
+        } else {
+            bUnlisted = FALSE;
+        }
+
+        auto Prefix = Peer::ParsePrefix(svEntry);
+        Rules.Insert(Prefix.PrefixAddress, Prefix.cBits, bAllow);
+    }
+}
+
+void LoadAccessList(std::wstring_view svList)
+{
+    // The list is parsed in full before replacing the current list, which
+    // remains in effect should the new list be invalid:
+    AccessTrie NewList;
+    BOOL bNewAllowUnlisted;
+    ParseAccessList(svList, NewList, bNewAllowUnlisted);
+    AccessList = std::move(NewList);
+    bAllowUnlisted = bNewAllowUnlisted;
+}
+
+BOOL IsValidAccessList(std::wstring_view svList)
+{
+    try {
+        AccessTrie Rules;
+        BOOL bUnlisted;
+        ParseAccessList(svList, Rules, bUnlisted);
+        return TRUE;
+    }
+    catch (const std::exception&) {
+        return FALSE;
+    }
+}
+
+BOOL IsAllowed(const Peer::Address& PeerAddress)
+{
+    auto pAllow = AccessList.Find(PeerAddress);
+    return pAllow ? *pAllow : bAllowUnlisted;
+}
+
+int CALLBACK AcceptCondition(LPWSABUF lpCallerId, LPWSABUF /*lpCallerData*/,
+                             LPQOS /*lpSQOS*/, LPQOS /*lpGQOS*/,
+                             LPWSABUF /*lpCalleeId*/, LPWSABUF /*lpCalleeData*/,
+                             GROUP* /*g*/, DWORD_PTR dwCallbackData)
+{
+    SOCKADDR_STORAGE Storage{};
+    if (lpCallerId && lpCallerId->buf) {
+        std::memcpy(&Storage, lpCallerId->buf, std::min<SIZE_T>(lpCallerId->len, sizeof(Storage)));
+    }
+    if (Storage.ss_family != AF_INET && Storage.ss_family != AF_INET6) {
+        return CF_ACCEPT;
+    }
+
+    auto PeerAddress = Peer::GetAddress(Storage);
+    if (IsAllowed(PeerAddress)) {
+        return CF_ACCEPT;
+    }
+
+    Counters.cRefused++;
+    Metrics::Add(Metrics::Metric::ConnectionsRefused);
+    *reinterpret_cast<PBOOL>(dwCallbackData) = TRUE;
+    ReportRejection(std::format("address not allowed: {}",
+                                Peer::FormatAddress(PeerAddress)), GetTickCount64());
+    return CF_REJECT;
+}
+
+PeerState* GetPeer(const EventState& State)
+{
+    if (!State.PeerAddress) {
+        return nullptr;
+    }
+
+    auto it = Peers.find(*State.PeerAddress);
+    return it != Peers.end() ? &it->second : nullptr;
+}
+
+BOOL Charge(WSAEVENT hEvent, SIZE_T cbCharged)
+{
+    // Buffer memory is charged before it is allocated; the new charge
+    // replaces any previous charge held by the connection. Peers exceeding
+    // their quota fail, whereas connections exceeding the server's budget
+    // wait until memory is released:
+    auto& State = States[hEvent];
+    auto pPeer = GetPeer(State);
+    auto cbBuffered = pPeer ? pPeer->cbBuffered - State.cbCharged + cbCharged : 0;
+    if (cbBuffered > MAXIMUM_PEER_BUFFER_SIZE) {
+        Counters.cQuotaExceeded++;
+        THROW("Peer buffer quota exceeded for {}: {} bytes",
+              Peer::FormatAddress(*State.PeerAddress), cbBuffered);
+    }
+
+    VERIFY(cbCharged <= Budget.Limit(), "Memory budget exceeded: {} bytes", cbCharged);
+    if (!Budget.CanReserve(State.cbCharged, cbCharged)) {
+        TrimParked(Budget.Reserved() - State.cbCharged + cbCharged - Budget.Limit());
+    }
+    if (!Budget.TryReserve(State.cbCharged, cbCharged)) {
+        Wait(hEvent, cbCharged);
+        return FALSE;
+    }
+
+    if (pPeer) {
+        pPeer->cbBuffered = cbBuffered;
+    }
+    State.cbCharged = cbCharged;
+    return TRUE;
+}
+
+void Release(EventState& State)
+{
+    Budget.Release(State.cbCharged);
+    if (auto pPeer = GetPeer(State)) {
+        pPeer->cbBuffered -= State.cbCharged;
+        pPeer->cConnections--;
+    }
+    State.PeerAddress.reset();
+    State.cbCharged = 0;
+}
+
+void ChargeParked()
+{
+    // Parked transfers are charged to the budget like any other buffer. The
+    // cache may evict entries whenever it is changed, so the charge is
+    // reconciled afterward; transfers that no longer fit are evicted:
+    if (!Budget.CanReserve(cbParked, Transfers.Bytes())) {
+        auto cbOther = Budget.Reserved() - cbParked;
+        Transfers.Trim(Budget.Limit() > cbOther ? Budget.Limit() - cbOther : 0);
+    }
+    Budget.TryReserve(cbParked, Transfers.Bytes());
+    cbParked = Transfers.Bytes();
+}
+
+void TrimParked(SIZE_T cbWanted)
+{
+    // Parked transfers are only an optimization; they are evicted before a
+    // connection is made to wait for memory:
+    Transfers.Trim(Transfers.Bytes() - std::min(cbWanted, Transfers.Bytes()));
+    ChargeParked();
+}
+
+void Wait(WSAEVENT hEvent, SIZE_T cbWanted)
+{
+    // Network events are disabled while waiting, leaving data in the receive
+    // buffer until the budget permits it to be read. Waiting connections are
+    // paused rather than idle, so only the duration deadline applies unless
+    // the connection is also throttled:
+    auto& State = States[hEvent];
+    VERIFY_WIN32(WSAEventSelect(Sockets[hEvent], hEvent, 0) != SOCKET_ERROR);
+    if (State.cbWanted == 0) {
+        Counters.cBudgetWaits++;
+        Waiters.push_back(hEvent);
+    }
+    State.cbWanted = cbWanted;
+    if (State.ullResumeRead == 0 && Timers.Contains(hEvent)) {
+        Timers.Schedule(hEvent, State.ullAccepted + CONNECTION_DURATION_TIMEOUT, GetTickCount64());
+    }
+}
+
+void Unpause(WSAEVENT hEvent)
+{
+    // Network events are only enabled once a connection is neither
+    // throttled nor waiting for memory:
+    auto& State = States[hEvent];
+    if (State.ullResumeRead == 0 && State.cbWanted == 0) {
+        VERIFY_WIN32(WSAEventSelect(Sockets[hEvent], hEvent, FD_READ | FD_CLOSE) != SOCKET_ERROR);
+    }
+}
+
+void ResumeWaiters()
+{
+    // Waiters are resumed in order so that large reservations are not
+    // starved by smaller ones:
+    while (!Waiters.empty()) {
+        auto hEvent = Waiters.front();
+        auto& State = States[hEvent];
+        if (!Budget.CanReserve(State.cbCharged, State.cbWanted)) {
+            break;
+        }
+
+        Waiters.pop_front();
+        State.cbWanted = 0;
+        try {
+            Unpause(hEvent);
+            if (State.ullResumeRead == 0 && Timers.Contains(hEvent)) {
+                ScheduleTimeout(hEvent, GetTickCount64());
+            }
+
+            // Waiting during negotiation leaves the header in the buffer;
+            // process it again now that memory is available:
+            if (Buffers.contains(hEvent)) {
+                Process(Sockets[hEvent], hEvent);
+            }
+        }
+        catch (const std::exception& e) {
+            Logger.ReportWarn(MSG_CONNECTION_FAILED, e.what());
+            CleanupEvent(hEvent);
+        }
+    }
+}
+
+void PrunePeers(ULONGLONG ullNow)
+{
+    // Idle peers whose buckets have refilled carry no state worth keeping;
+    // if that is not enough, forget every peer without a connection:
+    for (auto it = Peers.begin(); it != Peers.end();) {
+        auto& State = it->second;
+        if (State.cConnections == 0 && State.Connections.IsFull(ullNow) && State.Bytes.IsFull(ullNow)) {
+            it = Peers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (Peers.size() >= MAXIMUM_PEERS) {
+        std::erase_if(Peers, [](const auto& Entry) {
+            return Entry.second.cConnections == 0;
+        });
+    }
+}
+
+BOOL Admit(WSAEVENT hEvent, const Peer::Address& PeerAddress, ULONGLONG ullNow)
+{
+    // Loopback peers have no limits; without peer state, their connections
+    // are neither throttled nor charged against a quota:
+    if (Peer::IsLoopback(PeerAddress)) {
+        States[hEvent].PeerAddress = PeerAddress;
+        return TRUE;
+    }
+
+    if (Peers.size() >= MAXIMUM_PEERS && !Peers.contains(PeerAddress)) {
+        PrunePeers(ullNow);
+    }
+
+    auto& PeerLimits = Peers[PeerAddress];
+    if (!PeerLimits.Connections.TryConsume(1, ullNow)) {
+        Counters.cThrottledConnections++;
+        Metrics::Add(Metrics::Metric::ConnectionsRejected);
+        Reset(Sockets[hEvent]);
+        ReportRejection(std::format("connection rate exceeded for {}",
+                                    Peer::FormatAddress(PeerAddress)), ullNow);
+        return FALSE;
+    }
+
+    PeerLimits.cConnections++;
+    States[hEvent].PeerAddress = PeerAddress;
+    return TRUE;
+}
+
+void UpdateMemoryCondition()
+{
+    if (!Monitor.Update()) {
+        return;
+    }
+
+    // Parked transfers and the delta snapshot are only optimizations; both
+    // are released while memory is low, and admission is tightened until
+    // the condition clears:
+    if (Monitor.GetCondition() == MemoryMonitor::Condition::Low) {
+        auto spReleased = GetSnapshot();
+        auto cbReleased = Transfers.Bytes() + (spReleased ? spReleased->sText.size() : 0);
+        Transfers.SetMaximum(0, 0);
+        ChargeParked();
+        SetSnapshot(nullptr);
+        Budget.SetLimit(cbBudgetLimit / LOW_MEMORY_BUDGET_DIVISOR);
+        Logger.ReportWarn(MSG_MEMORY_LOW, "released {} cached bytes; memory budget reduced to {} bytes",
+                          cbReleased, Budget.Limit());
+    } else {
+        Transfers.SetMaximum(MAXIMUM_PARKED_BYTES, MAXIMUM_PARKED_TRANSFERS);
+        Budget.SetLimit(cbBudgetLimit);
+        ChargeParked();
+        Logger.ReportInfo(MSG_MEMORY_HIGH, "memory budget restored to {} bytes", Budget.Limit());
+    }
+}
+
+BOOL IsResumable(WSAEVENT hEvent)
+{
+    if (!Buffers.contains(hEvent) || !States.contains(hEvent)) {
+        return FALSE;
+    }
+
+    auto& State = States[hEvent];
+    return State.Mode == Protocol::Mode::Resume && State.bNegotiated && !Buffers[hEvent].IsFull();
+}
 
 void CleanupEvent(WSAEVENT hEvent)
 {
+    TRACE_ZONE("CleanupEvent");
+
     if (hEvent == WSA_INVALID_EVENT) {
         return;
     }
 
+    // Partial resumable transfers are parked rather than discarded so that
+    // a reconnecting client may continue from the acknowledged offset:
+    if (IsResumable(hEvent)) {
+        Park(hEvent);
+    }
+
+    Timers.Cancel(hEvent);
     Buffers.erase(hEvent);
+    if (States.contains(hEvent)) {
+        if (States[hEvent].cbWanted != 0) {
+            std::erase(Waiters, hEvent);
+        }
+        Release(States[hEvent]);
+        States.erase(hEvent);
+        ChargeParked();
+    }
     if (Sockets.contains(hEvent)) {
         closesocket(Sockets[hEvent]);
         Sockets.erase(hEvent);
     }
     WSACloseEvent(hEvent);
     Events.erase(std::find(Events.begin(), Events.end(), hEvent));
+    std::erase(Listeners, hEvent);
+    ListenerAddresses.erase(hEvent);
 }
 
 void CleanupEvents()
@@ -73,27 +435,170 @@ void CleanupEvents()
     while (!Events.empty()) {
         CleanupEvent(Events.back());
     }
+    ListenAddresses.clear();
+}
+
+void ScheduleTimeout(WSAEVENT hEvent, ULONGLONG ullNow)
+{
+    // The idle deadline is extended on each read, but never beyond the
+    // duration deadline established when the connection was accepted:
+    auto& State = States[hEvent];
+    auto ullDeadline = std::min(ullNow + CONNECTION_IDLE_TIMEOUT,
+                                State.ullAccepted + CONNECTION_DURATION_TIMEOUT);
+    Timers.Schedule(hEvent, ullDeadline, ullNow);
+}
+
+void ResumeRead(WSAEVENT hEvent, ULONGLONG ullNow)
+{
+    try {
+        States[hEvent].ullResumeRead = 0;
+        Unpause(hEvent);
+        ScheduleTimeout(hEvent, ullNow);
+    }
+    catch (const std::exception& e) {
+        Logger.ReportWarn(MSG_CONNECTION_FAILED, e.what());
+        CleanupEvent(hEvent);
+    }
+}
+
+void ExpireTimeouts(ULONGLONG ullNow)
+{
+    for (auto hEvent : Timers.Advance(ullNow)) {
+        auto& State = States[hEvent];
+        if (ullNow >= State.ullAccepted + CONNECTION_DURATION_TIMEOUT) {
+            Counters.cDurationTimeouts++;
+            Metrics::Add(Metrics::Metric::ConnectionsTimedOut);
+            Logger.ReportWarn(MSG_CONNECTION_TIMED_OUT, "open for more than {} ms",
+                              CONNECTION_DURATION_TIMEOUT);
+        } else if (State.ullResumeRead != 0) {
+            ResumeRead(hEvent, ullNow);
+            continue;
+        } else if (State.cbWanted != 0) {
+            // Connections waiting for memory are not idle; the idle deadline
+            // is scheduled again once they are resumed:
+            Timers.Schedule(hEvent, State.ullAccepted + CONNECTION_DURATION_TIMEOUT, ullNow);
+            continue;
+        } else {
+            Counters.cIdleTimeouts++;
+            Metrics::Add(Metrics::Metric::ConnectionsTimedOut);
+            Logger.ReportWarn(MSG_CONNECTION_TIMED_OUT, "idle for more than {} ms",
+                              CONNECTION_IDLE_TIMEOUT);
+        }
+        CleanupEvent(hEvent);
+    }
+}
+
+void ReportRejection(std::string_view svReason, ULONGLONG ullNow)
+{
+    // Rejections are reported at most once per interval to avoid flooding
+    // the event log while overloaded:
+    if (ullNow < ullNextRejectionReport) {
+        cRejectionsSuppressed++;
+        return;
+    }
+
+    Logger.ReportWarn(MSG_CONNECTION_REJECTED, "{} ({} rejections suppressed)",
+                      svReason, cRejectionsSuppressed);
+    ullNextRejectionReport = ullNow + REJECTION_REPORT_INTERVAL;
+    cRejectionsSuppressed = 0;
+}
+
+void ReportFailure(DWORD dwError)
+{
+    Logger.ReportWarn(MSG_CONNECTION_FAILED, "{}", GetCachedErrorMessageA(dwError));
+}
+
+void Reset(SOCKET hSocket)
+{
+    // A zero linger timeout resets the connection once closed, which gives
+    // the client an immediate signal rather than a graceful shutdown:
+    const LINGER Linger{.l_onoff = 1, .l_linger = 0};
+    setsockopt(hSocket, SOL_SOCKET, SO_LINGER,
+               reinterpret_cast<const char*>(&Linger), sizeof(Linger));
+}
+
+void Reject(SOCKET hSocket)
+{
+    Counters.cRejected++;
+    Metrics::Add(Metrics::Metric::ConnectionsRejected);
+
+    // Excess connections are reset rather than left in the backlog:
+    auto hNewSocket = accept(hSocket, nullptr, nullptr);
+    if (hNewSocket != INVALID_SOCKET) {
+        Reset(hNewSocket);
+        closesocket(hNewSocket);
+    }
+
+    ReportRejection(std::format("maximum number of clients reached: {}",
+                                MAXIMUM_EVENTS), GetTickCount64());
+}
+
+Win32Result<> Establish(SOCKET hSocket, WSAEVENT& hNewEvent)
+{
+    hNewEvent = WSACreateEvent();
+    TRY_WIN32(hNewEvent != WSA_INVALID_EVENT);
+    Events.push_back(hNewEvent);
+
+    // Peers outside of the access list are refused by the condition
+    // function; the listening socket uses conditional accept, so the
+    // connection is never established:
+    SOCKADDR_STORAGE PeerAddress{};
+    auto cbPeerAddress = static_cast<int>(sizeof(PeerAddress));
+    BOOL bRefused = FALSE;
+    auto hNewSocket = WSAAccept(hSocket, reinterpret_cast<PSOCKADDR>(&PeerAddress), &cbPeerAddress,
+                                AcceptCondition, reinterpret_cast<DWORD_PTR>(&bRefused));
+    if (bRefused) {
+        CleanupEvent(hNewEvent);
+        return {};
+    }
+    TRY_WIN32(hNewSocket != INVALID_SOCKET);
+    Sockets[hNewEvent] = hNewSocket;
+
+    // Connections are admitted against the peer's rate limit before any
+    // buffer memory is committed:
+    auto ullNow = GetTickCount64();
+    if (PeerAddress.ss_family == AF_INET || PeerAddress.ss_family == AF_INET6) {
+        if (!Admit(hNewEvent, Peer::GetAddress(PeerAddress), ullNow)) {
+            CleanupEvent(hNewEvent);
+            return {};
+        }
+    }
+
+    TRY_WIN32(WSAEventSelect(hNewSocket, hNewEvent, FD_READ | FD_CLOSE) != SOCKET_ERROR);
+
+    States[hNewEvent].ullAccepted = ullNow;
+    States[hNewEvent].Times.llAccepted = GetTimestamp();
+    ScheduleTimeout(hNewEvent, ullNow);
+    Metrics::Add(Metrics::Metric::ConnectionsAccepted);
+    if (Startup::Mark(Startup::Phase::FirstAccept)) {
+        Logger.ReportInfo(MSG_STARTUP_TIMELINE, "{}", Startup::Format());
+    }
+    return {};
 }
 
 void Accept(SOCKET hSocket)
 {
+    TRACE_ZONE("Accept");
+
     auto hNewEvent = WSA_INVALID_EVENT;
 
+    // Parked transfers are only otherwise expired when another transfer is
+    // parked or resumed:
+    Transfers.Expire(GetTickCount64());
+    ChargeParked();
+
     // Care must be taken when establishing a new connection; if a failure
     // propagates, it will close the listening socket and halt the server.
-    try {
-        VERIFY(Events.size() < WSA_MAXIMUM_WAIT_EVENTS,
-               "Maximum number of clients reached: {}", Events.size());
-
-        hNewEvent = WSACreateEvent();
-        VERIFY_WIN32(hNewEvent != WSA_INVALID_EVENT);
-        Events.push_back(hNewEvent);
-
-        auto hNewSocket = accept(hSocket, nullptr, nullptr);
-        VERIFY_WIN32(hNewSocket != INVALID_SOCKET);
-        Sockets[hNewEvent] = hNewSocket;
+    if (Events.size() >= MAXIMUM_EVENTS) {
+        Reject(hSocket);
+        return;
+    }
 
-        VERIFY_WIN32(WSAEventSelect(hNewSocket, hNewEvent, FD_READ | FD_CLOSE) != SOCKET_ERROR);
+    try {
+        if (auto Result = Establish(hSocket, hNewEvent); !Result) {
+            ReportFailure(Result.Error());
+            CleanupEvent(hNewEvent);
+        }
     }
     catch (const std::exception& e) {
         Logger.ReportWarn(MSG_CONNECTION_FAILED, e.what());
@@ -101,65 +606,573 @@ void Accept(SOCKET hSocket)
     }
 }
 
-void Read(SOCKET hSocket, EventBuffer& Buffer)
+INT GetInitialBufferSize()
+{
+    if (BufferSizes.Count() < BUFFER_SIZE_SAMPLES) {
+        return MAXIMUM_BUFFER_SIZE;
+    }
+
+    auto cbBuffer = BufferSizes.GetPercentile(BUFFER_SIZE_PERCENTILE);
+    return static_cast<INT>(std::clamp<SIZE_T>(cbBuffer, MINIMUM_BUFFER_SIZE, MAXIMUM_BUFFER_SIZE));
+}
+
+EventBuffer* GetBuffer(WSAEVENT hEvent)
 {
+    if (auto it = Buffers.find(hEvent); it != Buffers.end()) {
+        return std::addressof(it->second);
+    }
+
+    auto cbBuffer = GetInitialBufferSize();
+    if (!Charge(hEvent, static_cast<SIZE_T>(cbBuffer))) {
+        return nullptr;
+    }
+    return std::addressof(Buffers.try_emplace(hEvent, cbBuffer).first->second);
+}
+
+BOOL IsGrowable(WSAEVENT hEvent)
+{
+    // Resumable transfers are allocated in full during negotiation:
+    return States[hEvent].Mode != Protocol::Mode::Resume &&
+           Buffers[hEvent].Capacity() < MAXIMUM_BUFFER_SIZE;
+}
+
+BOOL Grow(WSAEVENT hEvent)
+{
+    auto& State = States[hEvent];
+    auto& Buffer = Buffers[hEvent];
+    auto cbGrowth = static_cast<SIZE_T>(MAXIMUM_BUFFER_SIZE - Buffer.Capacity());
+    if (!Charge(hEvent, State.cbCharged + cbGrowth)) {
+        return FALSE;
+    }
+
+    EventBuffer Grown;
+    std::memcpy(&Grown, Buffer.Data(), static_cast<SIZE_T>(Buffer.Size()));
+    Grown += Buffer.Size();
+    Buffer = std::move(Grown);
+    Counters.cBufferGrowths++;
+    Metrics::Add(Metrics::Metric::BufferGrowths);
+    return TRUE;
+}
+
+Win32Result<> Read(SOCKET hSocket, EventBuffer& Buffer)
+{
+    TRACE_ZONE("Read");
+
     auto nBytesRecvd = recv(hSocket, &Buffer, Buffer.Length(), 0);
-    VERIFY_WIN32(nBytesRecvd != SOCKET_ERROR);
+    TRY_WIN32(nBytesRecvd != SOCKET_ERROR);
     Buffer += nBytesRecvd;
+    Metrics::Add(Metrics::Metric::BytesReceived, nBytesRecvd);
+    return {};
+}
+
+void Throttle(WSAEVENT hEvent, SIZE_T cbRead, ULONGLONG ullNow)
+{
+    auto& State = States[hEvent];
+    auto pPeer = GetPeer(State);
+    if (!pPeer) {
+        return;
+    }
+
+    pPeer->Bytes.Consume(cbRead, ullNow);
+    auto ullDelay = pPeer->Bytes.GetDelay(ullNow);
+    if (ullDelay == 0) {
+        return;
+    }
+
+    // Network events are disabled until the peer's bucket is replenished,
+    // leaving data in the receive buffer so that TCP flow control applies
+    // back pressure. FD_CLOSE is deferred as well to avoid publishing a
+    // partial buffer:
+    VERIFY_WIN32(WSAEventSelect(Sockets[hEvent], hEvent, 0) != SOCKET_ERROR);
+    Counters.cThrottledReads++;
+    State.ullResumeRead = ullNow + ullDelay;
+    Timers.Schedule(hEvent, std::min(State.ullResumeRead,
+                                     State.ullAccepted + CONNECTION_DURATION_TIMEOUT), ullNow);
+}
+
+BOOL NegotiateDelta(SOCKET hSocket, WSAEVENT hEvent, std::string_view svFrame)
+{
+    auto& State = States[hEvent];
+    if (svFrame.size() < Delta::HEADER_SIZE) {
+        return TRUE;
+    }
+
+    // Delta transfers are only accepted if the base matches the most recently
+    // published text; otherwise the client is expected to fall back to a full
+    // transfer on a new connection:
+    auto Header = Delta::GetHeader(svFrame);
+    auto spBase = GetSnapshot();
+    auto bAccepted = spBase &&
+                     spBase->ullHash == Header.ullBaseHash &&
+                     Header.cbLength <= MAXIMUM_BUFFER_SIZE;
+
+    // Memory for the target is charged up front so that a connection waiting
+    // for memory may negotiate again once it has been released:
+    if (bAccepted && !Charge(hEvent, State.cbCharged + MAXIMUM_BUFFER_SIZE)) {
+        return TRUE;
+    }
+
+    auto chStatus = bAccepted ? Protocol::STATUS_ACCEPTED : Protocol::STATUS_REJECTED;
+    VERIFY_WIN32(send(hSocket, &chStatus, sizeof(chStatus), 0) != SOCKET_ERROR);
+
+    // Hold a reference to the base in case it is superseded by another
+    // connection before this transfer completes:
+    State.spBase = std::move(spBase);
+    State.bNegotiated = TRUE;
+    return bAccepted;
+}
+
+BOOL NegotiateResume(SOCKET hSocket, WSAEVENT hEvent)
+{
+    auto& State = States[hEvent];
+    auto& Buffer = Buffers[hEvent];
+    auto svFrame = std::string_view{Buffer.Data(), static_cast<SIZE_T>(Buffer.Size())};
+    if (svFrame.size() < Protocol::RESUME_HEADER_SIZE) {
+        return TRUE;
+    }
+
+    // Clients must wait for the acknowledged offset before sending data:
+    VERIFY(svFrame.size() == Protocol::RESUME_HEADER_SIZE,
+           "Unexpected data before resume offset: {} bytes", svFrame.size());
+
+    auto Header = Protocol::GetResumeHeader(svFrame);
+    VERIFY(Header.cbLength <= MAXIMUM_TRANSFER_SIZE,
+           "Transfer exceeds maximum size: {} bytes", Header.cbLength);
+
+    // Continue from a parked buffer if one exists for the transfer and was
+    // parked by the same peer, otherwise allocate the entire transfer up
+    // front. Transfers parked by other peers are left in place. The parked
+    // buffer is extracted before charging so that it is neither evicted to
+    // make room for itself nor charged twice; it is parked again if the
+    // connection must wait:
+    auto ullNow = GetTickCount64();
+    std::optional<ParkedTransfer> Parked;
+    Transfers.Expire(ullNow);
+    if (auto pParked = Transfers.Find(Header.ullTransferId);
+        pParked && pParked->PeerAddress == State.PeerAddress) {
+        Parked = Transfers.Extract(Header.ullTransferId, ullNow);
+    }
+    ChargeParked();
+    if (!Charge(hEvent, Header.cbLength)) {
+        if (Parked) {
+            auto cbBuffer = static_cast<SIZE_T>(Parked->Buffer.Capacity());
+            Transfers.Insert(Header.ullTransferId, std::move(*Parked), cbBuffer, ullNow);
+            ChargeParked();
+        }
+        return TRUE;
+    }
+    if (Parked && Parked->Buffer.Capacity() == static_cast<INT>(Header.cbLength)) {
+        Buffer = std::move(Parked->Buffer);
+        Metrics::Add(Metrics::Metric::ParkedHits);
+    } else {
+        Buffer = EventBuffer{static_cast<INT>(Header.cbLength)};
+        Metrics::Add(Metrics::Metric::ParkedMisses);
+    }
+
+    std::string sStatus{Protocol::STATUS_ACCEPTED};
+    Protocol::PutUInt64(sStatus, static_cast<UINT64>(Buffer.Size()));
+    VERIFY_WIN32(send(hSocket, sStatus.data(), static_cast<int>(sStatus.size()), 0) != SOCKET_ERROR);
+
+    State.ullTransferId = Header.ullTransferId;
+    State.bNegotiated = TRUE;
+    return TRUE;
+}
+
+BOOL Negotiate(SOCKET hSocket, WSAEVENT hEvent)
+{
+    auto& State = States[hEvent];
+    auto& Buffer = Buffers[hEvent];
+    auto svData = std::string_view{Buffer.Data(), static_cast<SIZE_T>(Buffer.Size())};
+
+    if (State.Mode == Protocol::Mode::Unknown) {
+        State.Mode = Protocol::Classify(svData);
+    }
+
+    if (State.bNegotiated) {
+        return TRUE;
+    }
+
+    switch (State.Mode) {
+    case Protocol::Mode::Delta:
+        return NegotiateDelta(hSocket, hEvent, svData);
+
+    case Protocol::Mode::Resume:
+        return NegotiateResume(hSocket, hEvent);
+
+    default:
+        return TRUE;
+    }
+}
+
+void Decode(WSAEVENT hEvent)
+{
+    auto& State = States[hEvent];
+    if (State.Mode != Protocol::Mode::Osc52) {
+        return;
+    }
+
+    // Data received since the last call is decoded in place immediately
+    // following previously decoded data; the remainder is rewound so the
+    // buffer holds only decoded text:
+    auto& Buffer = Buffers[hEvent];
+    auto cbReceived = static_cast<SIZE_T>(Buffer.Size() - State.cbDecoded);
+    auto cbDecoded = State.Decoder.Decode(Buffer.Data() + State.cbDecoded, cbReceived);
+    Buffer -= static_cast<INT>(cbReceived - cbDecoded);
+    State.cbDecoded = Buffer.Size();
+}
+
+BOOL Process(SOCKET hSocket, WSAEVENT hEvent)
+{
+    if (!Negotiate(hSocket, hEvent)) {
+        CleanupEvent(hEvent);
+        return FALSE;
+    }
+
+    Decode(hEvent);
+
+    // Buffers filled before reaching the maximum size are grown rather than
+    // closed; connections waiting for memory are processed again once it has
+    // been released:
+    auto& Buffer = Buffers[hEvent];
+    if (Buffer.IsFull() && IsGrowable(hEvent) && !Grow(hEvent)) {
+        return FALSE;
+    }
+
+    if (Buffer.IsFull() || States[hEvent].Decoder.IsComplete()) {
+        Close(hEvent);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void Park(WSAEVENT hEvent)
+{
+    auto& Buffer = Buffers[hEvent];
+    auto& State = States[hEvent];
+
+    // A transfer parked by another peer is not replaced; the parked buffer
+    // is charged once the connection's own charge has been released:
+    if (auto pParked = Transfers.Find(State.ullTransferId);
+        pParked && pParked->PeerAddress != State.PeerAddress) {
+        return;
+    }
+    auto cbBuffer = static_cast<SIZE_T>(Buffer.Capacity());
+    Transfers.Insert(State.ullTransferId, {State.PeerAddress, std::move(Buffer)}, cbBuffer, GetTickCount64());
+}
+
+DWORD GetTransformFlags(const Settings::Values& Values)
+{
+    DWORD dwFlags = 0;
+    if (Values.bStripEscapes) {
+        dwFlags |= Transform::STRIP_ESCAPES;
+    }
+    if (Values.bStripTrailingWhitespace) {
+        dwFlags |= Transform::STRIP_TRAILING_WHITESPACE;
+    }
+    return dwFlags;
+}
+
+SnapshotPtr GetSnapshot()
+{
+    ExclusiveLock Lock{SnapshotLock};
+    return spSnapshot;
+}
+
+void SetSnapshot(SnapshotPtr spNewSnapshot)
+{
+    ExclusiveLock Lock{SnapshotLock};
+    spSnapshot = std::move(spNewSnapshot);
+}
+
+void Publish(EventBuffer& Buffer, const ConnectionTimes& Times, SnapshotPtr spBase, SOCKET hSocket)
+{
+    // Payloads are numbered as connections complete and handed to the
+    // workers as received; transform flags are owned by the server thread,
+    // so they are captured here:
+    Publication Entry{
+        .ullSequence = Publications.Next(),
+        .Buffer = std::move(Buffer),
+        .spBase = std::move(spBase),
+        .hSocket = hSocket,
+        .dwFlags = dwTransformFlags,
+        .Times = Times
+    };
+    if (Workers.IsRunning() && Workers.Pending() >= MAXIMUM_PENDING_PUBLICATIONS) {
+        Prepare(Entry);
+        return;
+    }
+    Workers.Submit(std::move(Entry));
+}
+
+void Prepare(Publication& Entry)
+{
+    TRACE_ZONE("Prepare");
+
+    // Payloads that cannot be prepared are discarded; they must still be
+    // completed so that later payloads may be committed:
+    auto bPrepared = TRUE;
+    try {
+        if (Entry.spBase) {
+            auto svFrame = std::string_view{Entry.Buffer.Data(), static_cast<SIZE_T>(Entry.Buffer.Size())};
+            auto Header = Delta::GetHeader(svFrame);
+
+            EventBuffer Target;
+            Delta::Apply(Entry.spBase->sText, svFrame.substr(Delta::HEADER_SIZE),
+                         &Target, Header.cbLength, Header.ullTargetHash);
+            Target += static_cast<INT>(Header.cbLength);
+            Entry.Buffer = std::move(Target);
+            Entry.spBase.reset();
+        }
+
+        // Snapshots retain text as sent so that clients may continue to
+        // compute deltas against their own copy:
+        auto& Buffer = Entry.Buffer;
+        if (!Buffer.IsEmpty()) {
+            auto svText = std::string_view{Buffer.Data(), static_cast<SIZE_T>(Buffer.Size())};
+            Entry.spSnapshot = std::make_shared<const Snapshot>(Snapshot{
+                .sText{svText},
+                .ullHash = Delta::Hash(svText)
+            });
+
+            auto cbData = Transform::Apply(Entry.dwFlags, Buffer.Data(), static_cast<SIZE_T>(Buffer.Size()));
+            Buffer -= Buffer.Size() - static_cast<INT>(cbData);
+        }
+    }
+    catch (const std::exception& e) {
+        Logger.ReportWarn(MSG_CONNECTION_FAILED, e.what());
+        Entry.Buffer -= Entry.Buffer.Size();
+        bPrepared = FALSE;
+    }
+
+    // Delta clients are told whether their text was reconstructed; the
+    // client may already have gone, so the reply is best effort:
+    if (Entry.hSocket != INVALID_SOCKET) {
+        auto chStatus = bPrepared ? Protocol::STATUS_ACCEPTED : Protocol::STATUS_REJECTED;
+        send(Entry.hSocket, &chStatus, sizeof(chStatus), 0);
+        closesocket(std::exchange(Entry.hSocket, INVALID_SOCKET));
+    }
+    Publications.Complete(Entry.ullSequence, std::move(Entry));
+}
+
+void Commit(Publication& Entry)
+{
+    TRACE_ZONE("Commit");
+
+    // Snapshots are replaced in the order payloads are committed, so the
+    // delta base always follows the clipboard:
+    if (Entry.spSnapshot) {
+        SetSnapshot(std::move(Entry.spSnapshot));
+    }
+
+    auto& Buffer = Entry.Buffer;
+    if (Buffer.IsEmpty()) {
+        return;
+    }
+
+    auto& Times = Entry.Times;
+    OpenClipboard(nullptr);
+    Times.llOpened = GetTimestamp();
+    EmptyClipboard();
+    SetClipboardData(CF_TEXT, Buffer.Release());
+    Times.llCommitted = GetTimestamp();
+    CloseClipboard();
+    Metrics::Add(Metrics::Metric::Publications);
+    RecordLatency(Times);
+}
+
+void RecordLatency(const ConnectionTimes& Times)
+{
+    auto Record = [](Stage StageId, LONGLONG llStart, LONGLONG llEnd) {
+        if (llStart != 0 && llEnd != 0) {
+            Latencies[static_cast<SIZE_T>(StageId)].Record(GetElapsedMicroseconds(llStart, llEnd));
+        }
+    };
+    Record(Stage::FirstByte, Times.llAccepted, Times.llFirstByte);
+    Record(Stage::Transfer, Times.llFirstByte, Times.llClosed);
+    Record(Stage::Open, Times.llClosed, Times.llOpened);
+    Record(Stage::Commit, Times.llOpened, Times.llCommitted);
+    Record(Stage::Total, Times.llAccepted, Times.llCommitted);
+
+    // Percentiles are exported in stage order:
+    constexpr Metrics::Metric LATENCY_METRICS[STAGE_COUNT][2]{
+        {Metrics::Metric::LatencyFirstByteP50, Metrics::Metric::LatencyFirstByteP99},
+        {Metrics::Metric::LatencyTransferP50, Metrics::Metric::LatencyTransferP99},
+        {Metrics::Metric::LatencyOpenP50, Metrics::Metric::LatencyOpenP99},
+        {Metrics::Metric::LatencyCommitP50, Metrics::Metric::LatencyCommitP99},
+        {Metrics::Metric::LatencyTotalP50, Metrics::Metric::LatencyTotalP99},
+    };
+    for (SIZE_T i = 0; i < STAGE_COUNT; i++) {
+        Metrics::Set(LATENCY_METRICS[i][0], static_cast<LONGLONG>(Latencies[i].GetPercentile(50)));
+        Metrics::Set(LATENCY_METRICS[i][1], static_cast<LONGLONG>(Latencies[i].GetPercentile(99)));
+    }
 }
 
 void Close(WSAEVENT hEvent)
 {
+    TRACE_ZONE("Close");
+
     // Release ownership to the system and set clipboard data if a
     // non-empty buffer is associated with the event:
     if (Buffers.contains(hEvent)) {
         auto& Buffer = Buffers[hEvent];
-        if (!Buffer.IsEmpty()) {
-            OpenClipboard(nullptr);
-            EmptyClipboard();
-            SetClipboardData(CF_TEXT, Buffer.Release());
-            CloseClipboard();
+        auto& State = States[hEvent];
+        if (State.Times.llClosed == 0) {
+            State.Times.llClosed = GetTimestamp();
+        }
+        if (State.Mode != Protocol::Mode::Resume && !Buffer.IsEmpty()) {
+            BufferSizes.Add(static_cast<SIZE_T>(Buffer.Size()));
+        }
+
+        if (State.Mode == Protocol::Mode::Delta) {
+            // Deltas are applied by the workers against the base held
+            // since negotiation; the socket is handed over with the frame
+            // so that the result may be reported once it is known:
+            VERIFY(State.bNegotiated, "Incomplete delta frame: {} bytes", Buffer.Size());
+            auto hSocket = Sockets[hEvent];
+            Sockets.erase(hEvent);
+            Publish(Buffer, State.Times, State.spBase, hSocket);
+        } else if (State.Mode == Protocol::Mode::Resume) {
+            // Incomplete transfers are parked by CleanupEvent; only publish
+            // once every byte has been received:
+            VERIFY(State.bNegotiated, "Incomplete resume frame: {} bytes", Buffer.Size());
+            if (Buffer.IsFull() && !Buffer.IsEmpty()) {
+                Publish(Buffer, State.Times);
+            }
+        } else if (!Buffer.IsEmpty()) {
+            Publish(Buffer, State.Times);
         }
     }
 
     CleanupEvent(hEvent);
 }
 
+DWORD GetWorkerCount()
+{
+    auto cProcessors = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    return std::clamp<DWORD>(cProcessors, 1, MAXIMUM_WORKERS);
+}
+
+void UpdateMetrics()
+{
+    Metrics::Set(Metrics::Metric::ConnectionsActive, static_cast<LONGLONG>(States.size()));
+    Metrics::Set(Metrics::Metric::ConnectionsWaiting, static_cast<LONGLONG>(Waiters.size()));
+    Metrics::Set(Metrics::Metric::MemoryReserved, static_cast<LONGLONG>(Budget.Reserved()));
+    Metrics::Set(Metrics::Metric::ParkedBytes, static_cast<LONGLONG>(Transfers.Bytes()));
+    Notify::SendConnections(static_cast<LONGLONG>(States.size()));
+}
+
+// Network errors reported by Winsock are routine and returned rather than
+// thrown; exceptions are reserved for protocol violations and failures
+// outside of the connection:
+Win32Result<> Dispatch(SOCKET hSocket, WSAEVENT hEvent)
+{
+    WSANETWORKEVENTS NetworkEvents;
+    TRY_WIN32(WSAEnumNetworkEvents(hSocket, hEvent, &NetworkEvents) != SOCKET_ERROR);
+
+    if (NetworkEvents.lNetworkEvents & FD_ACCEPT) {
+        TRY_WIN32_RESULT(NetworkEvents.iErrorCode[FD_ACCEPT_BIT]);
+        Accept(hSocket);
+    }
+
+    if (NetworkEvents.lNetworkEvents & FD_READ) {
+        TRY_WIN32_RESULT(NetworkEvents.iErrorCode[FD_READ_BIT]);
+        auto pBuffer = GetBuffer(hEvent);
+        if (!pBuffer) {
+            return {};
+        }
+        auto cbPrevious = pBuffer->Size();
+        TRY_RESULT(Read(hSocket, *pBuffer));
+        if (auto& Times = States[hEvent].Times; Times.llFirstByte == 0 && pBuffer->Size() > cbPrevious) {
+            Times.llFirstByte = GetTimestamp();
+        }
+        auto ullNow = GetTickCount64();
+        if (Timers.Contains(hEvent)) {
+            ScheduleTimeout(hEvent, ullNow);
+        }
+        Throttle(hEvent, static_cast<SIZE_T>(pBuffer->Size() - cbPrevious), ullNow);
+        if (!Process(hSocket, hEvent)) {
+            return {};
+        }
+    }
+
+    if (NetworkEvents.lNetworkEvents & FD_CLOSE) {
+        TRY_WIN32_RESULT(NetworkEvents.iErrorCode[FD_CLOSE_BIT]);
+        Close(hEvent);
+    }
+    return {};
+}
+
 DWORD WINAPI ThreadProc(PVOID /*pParam*/)
 {
     try {
+        EventVector WaitEvents;
         for (;;) {
+            ExpireTimeouts(GetTickCount64());
+            ReloadSettings(GetTickCount64());
+            ResumeWaiters();
+            UpdateMetrics();
+
+            // The memory monitor, listen address resolver, command event, and
+            // settings monitor follow network events in the wait set:
             auto cEvents = static_cast<DWORD>(Events.size());
-            auto dwResult = WSAWaitForMultipleEvents(cEvents, Events.data(),
-                                                     FALSE, WSA_INFINITE, TRUE);
+            WaitEvents.assign(Events.begin(), Events.end());
+            if (Monitor.IsOpen()) {
+                WaitEvents.push_back(Monitor.GetHandle());
+            }
+            auto dwResolver = static_cast<DWORD>(WaitEvents.size());
+            if (ListenResolver.IsPending()) {
+                WaitEvents.push_back(ListenResolver.GetHandle());
+            }
+            auto dwCommands = static_cast<DWORD>(WaitEvents.size());
+            if (hCommandEvent) {
+                WaitEvents.push_back(hCommandEvent);
+            }
+            auto dwSettings = static_cast<DWORD>(WaitEvents.size());
+            if (SettingsMonitor.IsOpen()) {
+                WaitEvents.push_back(SettingsMonitor.GetHandle());
+            }
+
+            auto dwTimeout = GetWaitTimeout(GetTickCount64());
+            auto dwResult = WSAWaitForMultipleEvents(static_cast<DWORD>(WaitEvents.size()),
+                                                     WaitEvents.data(), FALSE, dwTimeout, TRUE);
+
+            // Commands may open or close listeners, which invalidates the
+            // result; signaled events remain signaled until handled. The
+            // command event may be signaled after its commands have run:
+            auto bCommands = RunCommands();
             if (bStopRequested) {
                 return 0;
             }
+            if (bCommands || dwResult == WSA_WAIT_TIMEOUT) {
+                continue;
+            }
+            if (dwResult == WSA_WAIT_EVENT_0 + dwCommands && hCommandEvent) {
+                continue;
+            }
+            if (dwResult == WSA_WAIT_EVENT_0 + cEvents && Monitor.IsOpen()) {
+                UpdateMemoryCondition();
+                continue;
+            }
+            if (dwResult == WSA_WAIT_EVENT_0 + dwResolver && ListenResolver.IsPending()) {
+                CompleteResolution();
+                continue;
+            }
+            if (dwResult == WSA_WAIT_EVENT_0 + dwSettings && SettingsMonitor.IsOpen()) {
+                UpdateSettings(GetTickCount64());
+                continue;
+            }
             VERIFY_WIN32_RANGE(dwResult, WSA_WAIT_EVENT_0, cEvents);
 
-            auto& hEvent = Events[dwResult - WSA_WAIT_EVENT_0];
-            auto& hSocket = Sockets[hEvent];
-            try {
-                WSANETWORKEVENTS NetworkEvents;
-                VERIFY_WIN32(WSAEnumNetworkEvents(hSocket, hEvent, &NetworkEvents) != SOCKET_ERROR);
-
-                if (NetworkEvents.lNetworkEvents & FD_ACCEPT) {
-                    VERIFY_WIN32_RESULT(NetworkEvents.iErrorCode[FD_ACCEPT_BIT]);
-                    Accept(hSocket);
-                }
-
-                if (NetworkEvents.lNetworkEvents & FD_READ) {
-                    VERIFY_WIN32_RESULT(NetworkEvents.iErrorCode[FD_READ_BIT]);
-                    auto& Buffer = Buffers[hEvent];
-                    Read(hSocket, Buffer);
-                    if (Buffer.IsFull()) {
-                        Close(hEvent);
-                    }
-                }
+            // Each signaled event is traced separately; time spent waiting
+            // is not recorded:
+            TRACE_ZONE("ThreadProc");
 
-                if (NetworkEvents.lNetworkEvents & FD_CLOSE) {
-                    VERIFY_WIN32_RESULT(NetworkEvents.iErrorCode[FD_CLOSE_BIT]);
-                    Close(hEvent);
+            auto hEvent = Events[dwResult - WSA_WAIT_EVENT_0];
+            auto hSocket = Sockets[hEvent];
+            try {
+                if (auto Result = Dispatch(hSocket, hEvent); !Result) {
+                    ReportFailure(Result.Error());
+                    CleanupEvent(hEvent);
                 }
             }
             catch (const std::exception& e) {
@@ -175,57 +1188,271 @@ DWORD WINAPI ThreadProc(PVOID /*pParam*/)
     return 0;
 }
 
-SIZE_T GetAddress(PCWSTR szAddress, PSOCKADDR_STORAGE pAddress)
+BOOL IsListening(const AddressList& Addresses)
+{
+    return IsSameAddresses(Addresses, ListenAddresses) && !Listeners.empty();
+}
+
+Win32Result<> OpenListener(const SOCKADDR_STORAGE& ListenAddress, WSAEVENT& hNewEvent)
+{
+    hNewEvent = WSACreateEvent();
+    TRY_WIN32(hNewEvent != WSA_INVALID_EVENT);
+    Events.push_back(hNewEvent);
+    Listeners.push_back(hNewEvent);
+    ListenerAddresses[hNewEvent] = ListenAddress;
+
+    auto hNewSocket = socket(ListenAddress.ss_family, SOCK_STREAM, IPPROTO_TCP);
+    TRY_WIN32(hNewSocket != INVALID_SOCKET);
+    Sockets[hNewEvent] = hNewSocket;
+
+    TRY_WIN32(bind(hNewSocket,
+                   reinterpret_cast<const SOCKADDR*>(&ListenAddress),
+                   GetAddressLength(ListenAddress)) != SOCKET_ERROR);
+
+    TRY_WIN32(WSAEventSelect(hNewSocket, hNewEvent, FD_ACCEPT | FD_CLOSE) != SOCKET_ERROR);
+
+    const BOOL bConditionalAccept = TRUE;
+    TRY_WIN32(setsockopt(hNewSocket, SOL_SOCKET, SO_CONDITIONAL_ACCEPT,
+                         reinterpret_cast<const char*>(&bConditionalAccept),
+                         sizeof(bConditionalAccept)) != SOCKET_ERROR);
+
+    TRY_WIN32(listen(hNewSocket, SOMAXCONN) != SOCKET_ERROR);
+    return {};
+}
+
+void Listen(const AddressList& Addresses)
 {
-    NET_ADDRESS_INFO AddressInfo;
-    VERIFY_WIN32_RESULT(ParseNetworkString(szAddress, NET_STRING_ANY_SERVICE,
-                                           &AddressInfo, nullptr, nullptr));
-    switch (AddressInfo.Format) {
-    case NET_ADDRESS_DNS_NAME: {
-        PADDRINFOW pResult;
-        VERIFY_WIN32_RESULT(GetAddrInfoW(AddressInfo.NamedAddress.Address,
-                                         AddressInfo.NamedAddress.Port,
-                                         nullptr,
-                                         &pResult));
-        auto _ = MakeUnique(pResult, FreeAddrInfoW);
-        std::memcpy(pAddress, pResult->ai_addr, pResult->ai_addrlen);
-        return pResult->ai_addrlen;
+    auto cAddresses = std::min<SIZE_T>(Addresses.size(), MAXIMUM_LISTENERS);
+    auto IsWanted = [&](const SOCKADDR_STORAGE& Address) {
+        return std::any_of(Addresses.begin(), Addresses.begin() + cAddresses,
+                           [&](const auto& Entry) { return IsSameAddress(Entry, Address); });
+    };
+    auto IsBound = [](const SOCKADDR_STORAGE& Address) {
+        return std::ranges::any_of(ListenerAddresses, [&](const auto& Entry) {
+            return IsSameAddress(Entry.second, Address);
+        });
+    };
+
+    // Listeners for addresses that remain are kept open so that clients are
+    // not refused while listening on a new address; only listeners for
+    // removed addresses are closed:
+    for (auto hEvent : EventVector{Listeners}) {
+        if (!IsWanted(ListenerAddresses[hEvent])) {
+            CleanupEvent(hEvent);
+        }
     }
+    ListenAddresses = Addresses;
 
-    case NET_ADDRESS_IPV4:
-        std::memcpy(pAddress, &AddressInfo.IpAddress, sizeof(SOCKADDR_IN));
-        return sizeof(SOCKADDR_IN);
+    // Names may resolve to addresses that cannot be bound, such as an IPv6
+    // address on a host without IPv6 configured. These are reported and
+    // skipped; the server only fails if no address can be bound:
+    for (SIZE_T i = 0; i < cAddresses; i++) {
+        auto& ListenAddress = Addresses[i];
+        if (IsBound(ListenAddress)) {
+            continue;
+        }
 
-    case NET_ADDRESS_IPV6:
-        std::memcpy(pAddress, &AddressInfo.IpAddress, sizeof(SOCKADDR_IN6));
-        return sizeof(SOCKADDR_IN6);
+        auto hNewEvent = WSA_INVALID_EVENT;
+        if (auto Result = OpenListener(ListenAddress, hNewEvent); !Result) {
+            Logger.ReportWarn(MSG_LISTEN_FAILED, "{}: {}",
+                              Peer::FormatAddress(Peer::GetAddress(ListenAddress)),
+                              GetCachedErrorMessageA(Result.Error()));
+            CleanupEvent(hNewEvent);
+        }
+    }
 
-    default:
-        THROW("Unsupported address format: {}", int{AddressInfo.Format});
+    VERIFY(!Listeners.empty(), "Unable to listen on any of {} addresses", cAddresses);
+    Startup::Mark(Startup::Phase::Listening);
+}
+
+void CloseListeners()
+{
+    // Connections accepted by a listener are unaffected when it is closed:
+    while (!Listeners.empty()) {
+        CleanupEvent(Listeners.back());
     }
+    ListenAddresses.clear();
 }
 
-void Start()
+void CompleteResolution()
+{
+    auto Result = ListenResolver.Complete();
+    if (!Result) {
+        // Previously resolved addresses remain in use if resolution fails:
+        VERIFY(!Listeners.empty(), "Unable to resolve listen address: {}",
+               GetCachedErrorMessageA(Result.Error()));
+        Logger.ReportWarn(MSG_RESOLVE_FAILED, "{}; using previously resolved addresses",
+                          GetCachedErrorMessageA(Result.Error()));
+        return;
+    }
+
+    auto& Addresses = Result.Value();
+    if (!IsListening(Addresses)) {
+        Listen(Addresses);
+    }
+    LastResolved = {ListenResolver.GetAddress(), Addresses};
+}
+
+void SetListenAddress(PCWSTR szAddress)
+{
+    // Numeric addresses are listened on immediately. Names are resolved by
+    // the server thread; existing listeners are kept until resolution
+    // completes, unless the name was resolved before:
+    auto Addresses = ListenResolver.Begin(szAddress, RESOLVE_TIMEOUT);
+    if (ListenResolver.IsPending() && LastResolved.sAddress == szAddress) {
+        Addresses = LastResolved.Addresses;
+    }
+    if (!Addresses.empty() && !IsListening(Addresses)) {
+        Listen(Addresses);
+    }
+}
+
+void SetMemoryBudget(DWORD dwMemoryBudget)
 {
+    // Connections waiting for memory are resumed by the server thread once
+    // the budget permits:
+    cbBudgetLimit = static_cast<SIZE_T>(dwMemoryBudget) * 1024 * 1024;
+    auto cbLimit = cbBudgetLimit;
+    if (Monitor.GetCondition() == MemoryMonitor::Condition::Low) {
+        cbLimit /= LOW_MEMORY_BUDGET_DIVISOR;
+    }
+    Budget.SetLimit(cbLimit);
+    ChargeParked();
+}
+
+void RunCommand(const Command& Entry)
+{
+    switch (Entry.Type) {
+    case CommandType::Stop:
+        bStopRequested = TRUE;
+        break;
+
+    case CommandType::SetListenAddress:
+        SetListenAddress(Entry.szValue);
+        break;
+
+    case CommandType::SetAccessList:
+        LoadAccessList(Entry.szValue);
+        break;
+
+    case CommandType::SetMemoryBudget:
+        SetMemoryBudget(Entry.dwValue);
+        break;
+
+    case CommandType::SetTransformFlags:
+        dwTransformFlags = Entry.dwValue;
+        break;
+
+    case CommandType::WatchSettings:
+        WatchSettings();
+        break;
+    }
+}
+
+BOOL RunCommands()
+{
+    auto bCommands = FALSE;
+    Command Entry;
+    while (Commands.TryPop(Entry)) {
+        RunCommand(Entry);
+        bCommands = TRUE;
+    }
+    return bCommands;
+}
+
+void WatchSettings()
+{
+    // Settings are not watched until the settings dialog has created the
+    // key; the server runs without watching them if the key cannot be
+    // watched:
+    if (SettingsMonitor.IsOpen()) {
+        return;
+    }
+
     try {
-        SOCKADDR_STORAGE ListenAddress;
-        auto ListenAddressLength = GetAddress(Settings::szListenAddress, &ListenAddress);
+        SettingsMonitor.Open(HKEY_CURRENT_USER, Settings::REGKEY_APP);
+    }
+    catch (const std::exception& e) {
+        Logger.ReportWarn(MSG_SETTINGS_UNWATCHED, e.what());
+    }
+}
 
-        auto hNewEvent = WSACreateEvent();
-        VERIFY_WIN32(hNewEvent != WSA_INVALID_EVENT);
-        Events.push_back(hNewEvent);
+void UpdateSettings(ULONGLONG ullNow)
+{
+    // The change that signaled the monitor is still reloaded if it cannot
+    // be rearmed; the monitor is closed rather than stopping the server:
+    try {
+        SettingsMonitor.Update();
+    }
+    catch (const std::exception& e) {
+        SettingsMonitor.Close();
+        Logger.ReportWarn(MSG_SETTINGS_UNWATCHED, e.what());
+    }
+    ScheduleReload(ullNow);
+}
+
+void ScheduleReload(ULONGLONG ullNow)
+{
+    ullReloadDeadline = ullNow + SETTINGS_RELOAD_DELAY;
+}
+
+void ReloadSettings(ULONGLONG ullNow)
+{
+    if (ullReloadDeadline == 0 || ullNow < ullReloadDeadline) {
+        return;
+    }
+
+    ullReloadDeadline = 0;
+    Notify::PostReload();
+}
+
+DWORD GetWaitTimeout(ULONGLONG ullNow)
+{
+    auto dwTimeout = Timers.GetTimeout(ullNow);
+    if (ullReloadDeadline != 0) {
+        auto ullDelay = ullReloadDeadline > ullNow ? ullReloadDeadline - ullNow : 0;
+        dwTimeout = static_cast<DWORD>(std::min<ULONGLONG>(dwTimeout, ullDelay));
+    }
+    return dwTimeout;
+}
+
+BOOL SendCommand(CommandType Type, DWORD dwValue, std::wstring_view svValue)
+{
+    Command Entry{.Type = Type, .dwValue = dwValue};
+    svValue = svValue.substr(0, ARRAYSIZE(Entry.szValue) - 1);
+    std::copy(svValue.begin(), svValue.end(), Entry.szValue);
+    if (!Commands.TryPush(Entry)) {
+        return FALSE;
+    }
+    SetEvent(hCommandEvent);
+    return TRUE;
+}
+
+void Start()
+{
+    try {
+        LoadAccessList(Settings::szAccessList);
 
-        auto hNewSocket = socket(ListenAddress.ss_family, SOCK_STREAM, IPPROTO_TCP);
-        VERIFY_WIN32(hNewSocket != INVALID_SOCKET);
-        Sockets[hNewEvent] = hNewSocket;
+        VERIFY(Settings::dwMemoryBudget > 0, "Invalid memory budget: {} MB", Settings::dwMemoryBudget);
+        cbBudgetLimit = static_cast<SIZE_T>(Settings::dwMemoryBudget) * 1024 * 1024;
+        Budget.SetLimit(cbBudgetLimit);
+        Budget.Reset();
+        cbParked = 0;
+        ChargeParked();
+        BufferSizes.Load(Settings::BufferSizes);
+        Transfers.SetMaximum(MAXIMUM_PARKED_BYTES, MAXIMUM_PARKED_TRANSFERS);
+        dwTransformFlags = GetTransformFlags(Settings::GetValues());
+        Monitor.Open();
 
-        VERIFY_WIN32(bind(hNewSocket,
-                          reinterpret_cast<PSOCKADDR>(&ListenAddress),
-                          static_cast<int>(ListenAddressLength)) != SOCKET_ERROR);
+        SetListenAddress(Settings::szListenAddress);
+        WatchSettings();
 
-        VERIFY_WIN32(WSAEventSelect(hNewSocket, hNewEvent, FD_ACCEPT | FD_CLOSE) != SOCKET_ERROR);
+        if (!hCommandEvent) {
+            hCommandEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+            VERIFY_WIN32(hCommandEvent);
+        }
 
-        VERIFY_WIN32(listen(hNewSocket, SOMAXCONN) != SOCKET_ERROR);
+        Workers.Start(GetWorkerCount());
 
         bStopRequested = FALSE;
         hThread = CreateThread(nullptr, 0, ThreadProc, nullptr, 0, nullptr);
@@ -243,20 +1470,47 @@ void Start()
 void Stop()
 {
     if (hThread) {
-        // Alert WSAWaitForMultipleEvents using an APC to prevent blocking
-        // until the next network event arrives:
-        auto fnAPC = [](ULONG_PTR /*dwData*/) {
-            bStopRequested = TRUE;
-        };
-        QueueUserAPC(fnAPC, hThread, 0);
+        // Stop is sent as a command so that it is handled in order with
+        // other commands; should the queue be full, an APC alerts
+        // WSAWaitForMultipleEvents instead:
+        if (!SendCommand(CommandType::Stop)) {
+            auto fnAPC = [](ULONG_PTR /*dwData*/) {
+                bStopRequested = TRUE;
+            };
+            QueueUserAPC(fnAPC, hThread, 0);
+        }
         WaitForMultipleObjects(1, &hThread, TRUE, INFINITE);
         CloseHandle(hThread);
         hThread = nullptr;
     }
 
+    // Payloads completed before stopping are committed before the workers
+    // exit:
+    Workers.Stop();
+
+    // Commands not run by the server thread are superseded by the settings
+    // read when it is next started:
+    Command Entry;
+    while (Commands.TryPop(Entry)) {
+    }
+    ListenResolver.Cancel();
+    SettingsMonitor.Close();
+    ullReloadDeadline = 0;
+    Monitor.Close();
+
     Logger.ReportInfo(MSG_SERVER_STOPPED);
     Notify::SendUpdate(L"Stopped");
     CleanupEvents();
+
+    Logger.ReportInfo(MSG_MEMORY_USAGE, "peak {} of {} bytes reserved; {} connections waited for memory; {} buffers grown",
+                      Budget.HighWater(), Budget.Limit(), Counters.cBudgetWaits, Counters.cBufferGrowths);
+
+    // Buffer sizes are only written once they have changed since they were
+    // loaded or last written:
+    if (BufferSizes.Counts() != Settings::BufferSizes) {
+        Settings::BufferSizes = BufferSizes.Counts();
+        Settings::SetBufferSizes();
+    }
 }
 
 void Restart()
@@ -265,6 +1519,64 @@ void Restart()
     Start();
 }
 
+BOOL IsRunning()
+{
+    return hThread && WaitForSingleObject(hThread, 0) == WAIT_TIMEOUT;
+}
+
+void Reconfigure(const Settings::Values& Previous)
+{
+    // Settings that cannot be applied in place are applied by restarting
+    // the server, which also reports invalid settings:
+    auto Current = Settings::GetValues();
+    if (!IsRunning() || Current.dwMemoryBudget == 0 || !IsValidAddress(Current.sListenAddress.c_str()) ||
+        !IsValidAccessList(Current.sAccessList)) {
+        Restart();
+        return;
+    }
+
+    // Only changed settings are sent to the server thread; listeners that
+    // are closed leave their connections to complete:
+    std::vector<std::string_view> Changes;
+    BOOL bSent = TRUE;
+    if (Current.sListenAddress != Previous.sListenAddress) {
+        bSent = bSent && SendCommand(CommandType::SetListenAddress, 0, Current.sListenAddress);
+        Changes.push_back("listen address");
+    }
+    if (Current.sAccessList != Previous.sAccessList) {
+        bSent = bSent && SendCommand(CommandType::SetAccessList, 0, Current.sAccessList);
+        Changes.push_back("access list");
+    }
+    if (Current.dwMemoryBudget != Previous.dwMemoryBudget) {
+        bSent = bSent && SendCommand(CommandType::SetMemoryBudget, Current.dwMemoryBudget);
+        Changes.push_back("memory budget");
+    }
+    if (Current.bStripEscapes != Previous.bStripEscapes ||
+        Current.bStripTrailingWhitespace != Previous.bStripTrailingWhitespace) {
+        bSent = bSent && SendCommand(CommandType::SetTransformFlags, GetTransformFlags(Current));
+        Changes.push_back("transforms");
+    }
+    if (!bSent) {
+        Restart();
+        return;
+    }
+
+    // Settings are watched once the key exists, which is not the case until
+    // they are first saved:
+    SendCommand(CommandType::WatchSettings);
+    if (Changes.empty()) {
+        return;
+    }
+
+    std::string sChanges;
+    for (auto svChange : Changes) {
+        sChanges += sChanges.empty() ? "" : ", ";
+        sChanges += svChange;
+    }
+    Logger.ReportInfo(MSG_SERVER_RECONFIGURED, "{} changed", sChanges);
+    Notify::SendUpdate(Settings::szListenAddress);
+}
+
 void Fail(PCSTR szReason)
 {
     Logger.ReportError(MSG_SERVER_FAILED, szReason);
@@ -282,6 +1594,16 @@ void Init()
     auto bMinorVersion = HIBYTE(wsaData.wVersion);
     VERIFY(bMajorVersion == 2 && bMinorVersion == 2,
            "Unsupported Winsock version: {}.{}", bMajorVersion, bMinorVersion);
+
+    // Metrics are opened for the lifetime of the process so that readers
+    // observe totals across restarts; the server runs without them if the
+    // mapping cannot be created:
+    try {
+        Metrics::Open();
+    }
+    catch (const std::exception& e) {
+        Logger.ReportWarn(MSG_METRICS_UNAVAILABLE, e.what());
+    }
 }
 
 } // namespace ClipSock::Server
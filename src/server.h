@@ -25,12 +25,35 @@
 
 #pragma once
 
+#include "budget.h"
 #include "buffer.h"
+#include "cache.h"
 #include "eventlog.h"
+#include "histogram.h"
+#include "latency.h"
+#include "memory.h"
+#include "osc52.h"
+#include "peer.h"
+#include "protocol.h"
+#include "queue.h"
+#include "registry.h"
+#include "ratelimit.h"
+#include "resolver.h"
+#include "settings.h"
+#include "timer.h"
+#include "trie.h"
+#include "util.h"
+#include "workers.h"
 
 #include <windows.h>
 #include <winsock2.h>
 
+#include <array>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -38,33 +61,318 @@ namespace ClipSock::Server {
 
 inline constexpr auto MAXIMUM_BUFFER_SIZE = 65535;
 
+// Buffers are initially sized to cover most recently completed payloads and
+// grown to the maximum only when filled. The maximum is used until enough
+// payloads have been observed. Sizes are observed across all listeners, as
+// every listener serves the same clients under the default configuration;
+// a listener with unusually large payloads only costs a buffer growth:
+inline constexpr auto MINIMUM_BUFFER_SIZE = 4096;
+inline constexpr auto BUFFER_SIZE_PERCENTILE = 90;
+inline constexpr auto BUFFER_SIZE_SAMPLES = 32;
+inline constexpr auto BUFFER_SIZE_WINDOW = 1024;
+inline constexpr auto MAXIMUM_TRANSFER_SIZE = 64 * 1024 * 1024;
+
+inline constexpr auto MAXIMUM_PARKED_BYTES = 128 * 1024 * 1024;
+inline constexpr auto MAXIMUM_PARKED_TRANSFERS = 8;
+inline constexpr auto PARKED_TRANSFER_TIMEOUT = 10 * 60 * 1000; // milliseconds
+
+// Connections are closed once idle or open for too long to prevent stalled
+// clients from holding wait slots indefinitely:
+inline constexpr auto CONNECTION_IDLE_TIMEOUT = 30 * 1000; // milliseconds
+inline constexpr auto CONNECTION_DURATION_TIMEOUT = 10 * 60 * 1000; // milliseconds
+inline constexpr auto CONNECTION_TIMER_RESOLUTION = 100; // milliseconds
+
+// Listen addresses are resolved in the background; a name that does not
+// resolve before the timeout fails the server unless it was previously
+// resolved:
+inline constexpr auto RESOLVE_TIMEOUT = 5 * 1000; // milliseconds
+inline constexpr auto MAXIMUM_LISTENERS = 8;
+
+// Settings changed while the server is running are sent to the server thread
+// as commands:
+inline constexpr auto COMMAND_QUEUE_CAPACITY = 16;
+
+// Registry writes made in quick succession are coalesced into a single
+// reload once no further changes arrive within the delay:
+inline constexpr auto SETTINGS_RELOAD_DELAY = 500; // milliseconds
+
+// Completed payloads are transformed and committed to the clipboard by a
+// pool of workers sized to the number of processors; the server thread
+// processes them itself once too many are outstanding:
+inline constexpr auto MAXIMUM_WORKERS = 16;
+inline constexpr auto MAXIMUM_PENDING_PUBLICATIONS = 32;
+
+inline constexpr auto REJECTION_REPORT_INTERVAL = 60 * 1000; // milliseconds
+
+// Peers are limited in the rate at which they connect and send data, and in
+// the amount of buffer memory held by their connections at any one time.
+// Loopback peers are exempt, as tunneled clients share the loopback address
+// and would otherwise throttle one another:
+inline constexpr auto PEER_CONNECTION_RATE = 10; // per second
+inline constexpr auto PEER_CONNECTION_BURST = 20;
+inline constexpr auto PEER_BYTE_RATE = 8 * 1024 * 1024; // per second
+inline constexpr auto PEER_BYTE_BURST = 16 * 1024 * 1024;
+inline constexpr auto MAXIMUM_PEER_BUFFER_SIZE = 96 * 1024 * 1024;
+inline constexpr auto MAXIMUM_PEERS = 256;
+
+// Wait slots are reserved for the memory monitor, listen address resolver,
+// command event, and settings monitor:
+inline constexpr auto RESERVED_EVENTS = 4;
+inline constexpr auto MAXIMUM_EVENTS = WSA_MAXIMUM_WAIT_EVENTS - RESERVED_EVENTS;
+
+// While system memory is low, cached data is released and the memory budget
+// is reduced by this factor:
+inline constexpr auto LOW_MEMORY_BUDGET_DIVISOR = 4;
+
+// Snapshot retains the most recently published text, which serves as the
+// base for delta transfers:
+struct Snapshot {
+    std::string sText;
+    UINT64 ullHash;
+};
+
+using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+// Connections are timestamped at each stage from accept to clipboard commit;
+// a timestamp of zero indicates the stage has not been reached:
+struct ConnectionTimes {
+    LONGLONG llAccepted{0};
+    LONGLONG llFirstByte{0};
+    LONGLONG llClosed{0};
+    LONGLONG llOpened{0};
+    LONGLONG llCommitted{0};
+};
+
+enum class Stage : UINT {
+    FirstByte,  // accept to first byte received
+    Transfer,   // first byte to close
+    Open,       // close to clipboard opened
+    Commit,     // clipboard opened to data set
+    Total,      // accept to data set
+    Count
+};
+
+inline constexpr auto STAGE_COUNT = static_cast<SIZE_T>(Stage::Count);
+
+enum class CommandType : UINT {
+    Stop,
+    SetListenAddress,
+    SetAccessList,
+    SetMemoryBudget,
+    SetTransformFlags,
+    WatchSettings
+};
+
+// Commands are copied into the queue, so values are held inline:
+struct Command {
+    CommandType Type;
+    DWORD dwValue;
+    WCHAR szValue[Settings::MAXIMUM_ACCESS_LIST];
+};
+
+// ResolvedAddress retains the most recent result for a listen address so
+// that the server may listen immediately when restarted:
+struct ResolvedAddress {
+    std::wstring sAddress;
+    AddressList Addresses;
+};
+
+struct EventState {
+    Protocol::Mode Mode{Protocol::Mode::Unknown};
+    BOOL bNegotiated{FALSE};
+    SnapshotPtr spBase;
+    UINT64 ullTransferId{0};
+    Osc52::Decoder Decoder;
+    INT cbDecoded{0};
+    ULONGLONG ullAccepted{0};
+    ULONGLONG ullResumeRead{0};
+    std::optional<Peer::Address> PeerAddress;
+    SIZE_T cbCharged{0};
+    SIZE_T cbWanted{0};
+    ConnectionTimes Times;
+};
+
+struct PeerState {
+    TokenBucket Connections{PEER_CONNECTION_RATE, PEER_CONNECTION_BURST};
+    TokenBucket Bytes{PEER_BYTE_RATE, PEER_BYTE_BURST};
+    SIZE_T cConnections{0};
+    SIZE_T cbBuffered{0};
+};
+
+struct ServerCounters {
+    ULONGLONG cIdleTimeouts;
+    ULONGLONG cDurationTimeouts;
+    ULONGLONG cRejected;
+    ULONGLONG cThrottledConnections;
+    ULONGLONG cThrottledReads;
+    ULONGLONG cQuotaExceeded;
+    ULONGLONG cRefused;
+    ULONGLONG cBudgetWaits;
+    ULONGLONG cBufferGrowths;
+};
+
 using EventLogger = EventLog::DefaultLogger;
 using EventBuffer = GlobalBuffer<CHAR, INT, MAXIMUM_BUFFER_SIZE>;
 using EventVector = std::vector<WSAEVENT>;
 using EventSocketMap = std::unordered_map<WSAEVENT, SOCKET>;
 using EventBufferMap = std::unordered_map<WSAEVENT, EventBuffer>;
+using EventStateMap = std::unordered_map<WSAEVENT, EventState>;
+using EventAddressMap = std::unordered_map<WSAEVENT, SOCKADDR_STORAGE>;
+using EventTimerWheel = TimerWheel<WSAEVENT>;
+using AccessTrie = PrefixTrie<BOOL>;
+using EventQueue = std::deque<WSAEVENT>;
+using PeerMap = std::unordered_map<Peer::Address, PeerState, Peer::AddressHash>;
+using LatencyArray = std::array<LatencyHistogram, STAGE_COUNT>;
+using CommandQueue = BoundedQueue<Command, COMMAND_QUEUE_CAPACITY>;
+
+// Publication holds a completed payload until it is committed; payloads are
+// committed in the order their connections completed. Delta payloads hold
+// the frame as received along with its base until prepared, and own their
+// socket so that the result may be reported to the client:
+struct Publication {
+    ULONGLONG ullSequence;
+    EventBuffer Buffer;
+    SnapshotPtr spBase;
+    SnapshotPtr spSnapshot;
+    SOCKET hSocket;
+    DWORD dwFlags;
+    ConnectionTimes Times;
+};
+
+// ParkedTransfer holds a partial resumable transfer along with the peer that
+// parked it; transfer IDs are chosen by clients, so only the same peer may
+// resume the transfer:
+struct ParkedTransfer {
+    std::optional<Peer::Address> PeerAddress;
+    EventBuffer Buffer;
+};
+
+using TransferCache = ExpiringCache<UINT64, ParkedTransfer>;
+using PublicationPool = WorkerPool<Publication>;
+using PublicationSequencer = Sequencer<Publication>;
 
 extern EventLogger Logger;
 extern HANDLE hThread;
 extern BOOL bStopRequested;
+extern CommandQueue Commands;
+extern HANDLE hCommandEvent;
 extern EventVector Events;
+extern EventVector Listeners;
+extern AddressList ListenAddresses;
+extern EventAddressMap ListenerAddresses;
 extern EventSocketMap Sockets;
 extern EventBufferMap Buffers;
+extern EventStateMap States;
+extern SnapshotPtr spSnapshot;
+extern SRWLOCK SnapshotLock;
+extern TransferCache Transfers;
+extern SIZE_T cbParked;
+extern EventTimerWheel Timers;
+extern PeerMap Peers;
+extern MemoryBudget Budget;
+extern SIZE_T cbBudgetLimit;
+extern DWORD dwTransformFlags;
+extern SizeHistogram BufferSizes;
+extern LatencyArray Latencies;
+extern PublicationPool Workers;
+extern PublicationSequencer Publications;
+extern EventQueue Waiters;
+extern MemoryMonitor Monitor;
+extern Resolver ListenResolver;
+extern RegistryMonitor SettingsMonitor;
+extern ULONGLONG ullReloadDeadline;
+extern ResolvedAddress LastResolved;
+extern AccessTrie AccessList;
+extern BOOL bAllowUnlisted;
+extern ServerCounters Counters;
+extern ULONGLONG ullNextRejectionReport;
+extern ULONGLONG cRejectionsSuppressed;
+
+void ParseAccessList(std::wstring_view svList, AccessTrie& Rules, BOOL& bUnlisted);
+void LoadAccessList(std::wstring_view svList);
+BOOL IsValidAccessList(std::wstring_view svList);
+BOOL IsAllowed(const Peer::Address& PeerAddress);
+int CALLBACK AcceptCondition(LPWSABUF lpCallerId, LPWSABUF lpCallerData,
+                             LPQOS lpSQOS, LPQOS lpGQOS,
+                             LPWSABUF lpCalleeId, LPWSABUF lpCalleeData,
+                             GROUP* g, DWORD_PTR dwCallbackData);
+
+PeerState* GetPeer(const EventState& State);
+BOOL Charge(WSAEVENT hEvent, SIZE_T cbCharged);
+void Release(EventState& State);
+void Wait(WSAEVENT hEvent, SIZE_T cbWanted);
+void Unpause(WSAEVENT hEvent);
+void ResumeWaiters();
+void ChargeParked();
+void TrimParked(SIZE_T cbWanted);
+void UpdateMemoryCondition();
+void PrunePeers(ULONGLONG ullNow);
+BOOL Admit(WSAEVENT hEvent, const Peer::Address& PeerAddress, ULONGLONG ullNow);
 
+BOOL IsResumable(WSAEVENT hEvent);
 void CleanupEvent(WSAEVENT hEvent);
 void CleanupEvents();
 
+void ScheduleTimeout(WSAEVENT hEvent, ULONGLONG ullNow);
+void ResumeRead(WSAEVENT hEvent, ULONGLONG ullNow);
+void ExpireTimeouts(ULONGLONG ullNow);
+
+void ReportRejection(std::string_view svReason, ULONGLONG ullNow);
+void ReportFailure(DWORD dwError);
+void Reset(SOCKET hSocket);
+void Reject(SOCKET hSocket);
+Win32Result<> Establish(SOCKET hSocket, WSAEVENT& hNewEvent);
 void Accept(SOCKET hSocket);
-void Read(SOCKET hSocket, EventBuffer& Buffer);
+INT GetInitialBufferSize();
+EventBuffer* GetBuffer(WSAEVENT hEvent);
+BOOL IsGrowable(WSAEVENT hEvent);
+BOOL Grow(WSAEVENT hEvent);
+Win32Result<> Read(SOCKET hSocket, EventBuffer& Buffer);
+void Throttle(WSAEVENT hEvent, SIZE_T cbRead, ULONGLONG ullNow);
+BOOL NegotiateDelta(SOCKET hSocket, WSAEVENT hEvent, std::string_view svFrame);
+BOOL NegotiateResume(SOCKET hSocket, WSAEVENT hEvent);
+BOOL Negotiate(SOCKET hSocket, WSAEVENT hEvent);
+void Decode(WSAEVENT hEvent);
+BOOL Process(SOCKET hSocket, WSAEVENT hEvent);
+void Park(WSAEVENT hEvent);
+DWORD GetTransformFlags(const Settings::Values& Values);
+SnapshotPtr GetSnapshot();
+void SetSnapshot(SnapshotPtr spNewSnapshot);
+void Publish(EventBuffer& Buffer, const ConnectionTimes& Times, SnapshotPtr spBase = nullptr,
+             SOCKET hSocket = INVALID_SOCKET);
+void Prepare(Publication& Entry);
+void Commit(Publication& Entry);
+void RecordLatency(const ConnectionTimes& Times);
+DWORD GetWorkerCount();
 void Close(WSAEVENT hEvent);
 
+void UpdateMetrics();
+Win32Result<> Dispatch(SOCKET hSocket, WSAEVENT hEvent);
 DWORD WINAPI ThreadProc(PVOID pParam);
 
-SIZE_T GetAddress(PCWSTR szAddress, PSOCKADDR_STORAGE pAddress);
+BOOL IsListening(const AddressList& Addresses);
+Win32Result<> OpenListener(const SOCKADDR_STORAGE& ListenAddress, WSAEVENT& hNewEvent);
+void Listen(const AddressList& Addresses);
+void CloseListeners();
+void CompleteResolution();
+
+void SetListenAddress(PCWSTR szAddress);
+void SetMemoryBudget(DWORD dwMemoryBudget);
+void RunCommand(const Command& Entry);
+BOOL RunCommands();
+void WatchSettings();
+void UpdateSettings(ULONGLONG ullNow);
+void ScheduleReload(ULONGLONG ullNow);
+void ReloadSettings(ULONGLONG ullNow);
+DWORD GetWaitTimeout(ULONGLONG ullNow);
+
+BOOL SendCommand(CommandType Type, DWORD dwValue = 0, std::wstring_view svValue = {});
 
 void Start();
 void Stop();
 void Restart();
+BOOL IsRunning();
+void Reconfigure(const Settings::Values& Previous);
 
 void Fail(PCSTR szReason);
 
@@ -27,6 +27,7 @@
 
 #include "resource.h"
 #include "server.h"
+#include "startup.h"
 #include "util.h"
 
 #include <windows.h>
@@ -39,6 +40,17 @@ namespace ClipSock::Settings {
 
 BOOL bLaunchAtStartup;
 WCHAR szListenAddress[INET6_ADDRSTRLEN];
+WCHAR szAccessList[MAXIMUM_ACCESS_LIST];
+BOOL bStripEscapes;
+BOOL bStripTrailingWhitespace;
+DWORD dwMemoryBudget;
+SizeHistogram::CountArray BufferSizes;
+
+// Settings are loaded before the dialog class is registered so that the
+// server may start listening first; requests to show the dialog in the
+// meantime are deferred until it is:
+BOOL bRegistered;
+BOOL bShowPending;
 
 BOOL GetRegValues()
 {
@@ -54,6 +66,22 @@ BOOL GetRegValues()
     RegGetValue(hKey, nullptr, REGVAL_LISTEN_ADDRESS, RRF_RT_REG_SZ,
                 nullptr, szListenAddress, &cbData);
 
+    cbData = sizeof(szAccessList);
+    RegGetValue(hKey, nullptr, REGVAL_ACCESS_LIST, RRF_RT_REG_SZ,
+                nullptr, szAccessList, &cbData);
+
+    cbData = sizeof(bStripEscapes);
+    RegGetValue(hKey, nullptr, REGVAL_STRIP_ESCAPES, RRF_RT_DWORD,
+                nullptr, &bStripEscapes, &cbData);
+
+    cbData = sizeof(bStripTrailingWhitespace);
+    RegGetValue(hKey, nullptr, REGVAL_STRIP_TRAILING_WHITESPACE, RRF_RT_DWORD,
+                nullptr, &bStripTrailingWhitespace, &cbData);
+
+    cbData = sizeof(dwMemoryBudget);
+    RegGetValue(hKey, nullptr, REGVAL_MEMORY_BUDGET, RRF_RT_DWORD,
+                nullptr, &dwMemoryBudget, &cbData);
+
     return TRUE;
 }
 
@@ -72,6 +100,29 @@ void SetRegValues()
                                       reinterpret_cast<PBYTE>(szListenAddress),
                                       sizeof(szListenAddress)));
 
+    VERIFY_WIN32_RESULT(RegSetValueEx(hKey, REGVAL_ACCESS_LIST, 0, REG_SZ,
+                                      reinterpret_cast<PBYTE>(szAccessList),
+                                      sizeof(szAccessList)));
+
+    VERIFY_WIN32_RESULT(RegSetValueEx(hKey, REGVAL_STRIP_ESCAPES, 0, REG_DWORD,
+                                      reinterpret_cast<PBYTE>(&bStripEscapes),
+                                      sizeof(bStripEscapes)));
+
+    VERIFY_WIN32_RESULT(RegSetValueEx(hKey, REGVAL_STRIP_TRAILING_WHITESPACE, 0, REG_DWORD,
+                                      reinterpret_cast<PBYTE>(&bStripTrailingWhitespace),
+                                      sizeof(bStripTrailingWhitespace)));
+
+    VERIFY_WIN32_RESULT(RegSetValueEx(hKey, REGVAL_MEMORY_BUDGET, 0, REG_DWORD,
+                                      reinterpret_cast<PBYTE>(&dwMemoryBudget),
+                                      sizeof(dwMemoryBudget)));
+    RegCloseKey(hKey);
+
+    SetLaunchAtStartup();
+}
+
+void SetLaunchAtStartup()
+{
+    HKEY hKey;
     ASSERT_WIN32_RESULT(RegOpenKeyEx(HKEY_CURRENT_USER, REGKEY_RUN, 0, KEY_WRITE, &hKey));
     if (bLaunchAtStartup) {
         WCHAR szFileName[MAX_PATH];
@@ -82,6 +133,61 @@ void SetRegValues()
     } else {
         RegDeleteValue(hKey, REGVAL_APP);
     }
+    RegCloseKey(hKey);
+}
+
+void GetBufferSizes()
+{
+    DWORD cbData = sizeof(BufferSizes);
+    if (RegGetValue(HKEY_CURRENT_USER, REGKEY_STATE, REGVAL_BUFFER_SIZES, RRF_RT_REG_BINARY,
+                    nullptr, BufferSizes.data(), &cbData) != ERROR_SUCCESS ||
+        cbData != sizeof(BufferSizes)) {
+        BufferSizes.fill(0);
+    }
+}
+
+void SetBufferSizes()
+{
+    // Failing to persist buffer sizes is not fatal; sizes are learned again
+    // once the server restarts:
+    HKEY hKey;
+    if (RegCreateKeyEx(HKEY_CURRENT_USER, REGKEY_STATE, 0, nullptr,
+                       REG_OPTION_NON_VOLATILE, KEY_WRITE, nullptr,
+                       &hKey, nullptr) != ERROR_SUCCESS)
+        return;
+
+    RegSetValueEx(hKey, REGVAL_BUFFER_SIZES, 0, REG_BINARY,
+                  reinterpret_cast<PBYTE>(BufferSizes.data()),
+                  sizeof(BufferSizes));
+    RegCloseKey(hKey);
+}
+
+void Reload()
+{
+    // Values written to the registry by other programs are applied as if
+    // changed using the settings dialog. Changes are also notified for
+    // values written by the dialog itself, which have already been applied:
+    auto Previous = GetValues();
+    if (!GetRegValues() || GetValues() == Previous) {
+        return;
+    }
+
+    if (bLaunchAtStartup != Previous.bLaunchAtStartup) {
+        SetLaunchAtStartup();
+    }
+    Server::Reconfigure(Previous);
+}
+
+Values GetValues()
+{
+    return {
+        .bLaunchAtStartup = bLaunchAtStartup,
+        .sListenAddress = szListenAddress,
+        .sAccessList = szAccessList,
+        .bStripEscapes = bStripEscapes,
+        .bStripTrailingWhitespace = bStripTrailingWhitespace,
+        .dwMemoryBudget = dwMemoryBudget
+    };
 }
 
 INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM /*lParam*/)
@@ -90,28 +196,44 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM /*lPa
     case WM_INITDIALOG:
         CheckDlgButton(hDlg, IDC_LAUNCH_AT_STARTUP, bLaunchAtStartup);
         SetDlgItemText(hDlg, IDC_LISTEN_ADDRESS, szListenAddress);
+        SetDlgItemText(hDlg, IDC_ACCESS_LIST, szAccessList);
+        CheckDlgButton(hDlg, IDC_STRIP_ESCAPES, bStripEscapes);
+        CheckDlgButton(hDlg, IDC_STRIP_TRAILING_WHITESPACE, bStripTrailingWhitespace);
+        SetDlgItemInt(hDlg, IDC_MEMORY_BUDGET, dwMemoryBudget, FALSE);
         return TRUE;
 
     case WM_COMMAND:
         switch (LOWORD(wParam)) {
-        case IDC_LAUNCH_AT_STARTUP: {
-            auto uCheck = IsDlgButtonChecked(hDlg, IDC_LAUNCH_AT_STARTUP);
-            CheckDlgButton(hDlg, IDC_LAUNCH_AT_STARTUP, !uCheck);
+        case IDC_LAUNCH_AT_STARTUP:
+        case IDC_STRIP_ESCAPES:
+        case IDC_STRIP_TRAILING_WHITESPACE: {
+            auto uCheck = IsDlgButtonChecked(hDlg, LOWORD(wParam));
+            CheckDlgButton(hDlg, LOWORD(wParam), !uCheck);
             return TRUE;
         }
 
         case IDC_RESET:
             CheckDlgButton(hDlg, IDC_LAUNCH_AT_STARTUP, DEFAULT_LAUNCH_AT_STARTUP);
             SetDlgItemText(hDlg, IDC_LISTEN_ADDRESS, DEFAULT_LISTEN_ADDRESS);
+            SetDlgItemText(hDlg, IDC_ACCESS_LIST, DEFAULT_ACCESS_LIST);
+            CheckDlgButton(hDlg, IDC_STRIP_ESCAPES, DEFAULT_STRIP_ESCAPES);
+            CheckDlgButton(hDlg, IDC_STRIP_TRAILING_WHITESPACE, DEFAULT_STRIP_TRAILING_WHITESPACE);
+            SetDlgItemInt(hDlg, IDC_MEMORY_BUDGET, DEFAULT_MEMORY_BUDGET, FALSE);
             return TRUE;
 
-        case IDOK:
+        case IDOK: {
+            auto Previous = GetValues();
             bLaunchAtStartup = IsDlgButtonChecked(hDlg, IDC_LAUNCH_AT_STARTUP);
             GetDlgItemText(hDlg, IDC_LISTEN_ADDRESS, szListenAddress, ARRAYSIZE(szListenAddress));
+            GetDlgItemText(hDlg, IDC_ACCESS_LIST, szAccessList, ARRAYSIZE(szAccessList));
+            bStripEscapes = IsDlgButtonChecked(hDlg, IDC_STRIP_ESCAPES);
+            bStripTrailingWhitespace = IsDlgButtonChecked(hDlg, IDC_STRIP_TRAILING_WHITESPACE);
+            dwMemoryBudget = GetDlgItemInt(hDlg, IDC_MEMORY_BUDGET, nullptr, FALSE);
             SetRegValues();
             DestroyWindow(hDlg);
-            Server::Restart();
+            Server::Reconfigure(Previous);
             return TRUE;
+        }
 
         case IDCANCEL:
             DestroyWindow(hDlg);
@@ -129,6 +251,11 @@ BOOL IsMessage(PMSG pMsg)
 
 void ShowDialog()
 {
+    if (!bRegistered) {
+        bShowPending = TRUE;
+        return;
+    }
+
     auto hDlg = FindWindow(CLASSNAME, nullptr);
     if (!hDlg) {
         hDlg = CreateDialog(nullptr, MAKEINTRESOURCE(IDD_SETTINGS), nullptr, DialogProc);
@@ -140,11 +267,25 @@ void ShowDialog()
     SetForegroundWindow(hDlg);
 }
 
-void Init(HINSTANCE hInstance)
+void Load()
 {
     bLaunchAtStartup = DEFAULT_LAUNCH_AT_STARTUP;
     StringCchCopy(szListenAddress, ARRAYSIZE(szListenAddress), DEFAULT_LISTEN_ADDRESS);
+    StringCchCopy(szAccessList, ARRAYSIZE(szAccessList), DEFAULT_ACCESS_LIST);
+    bStripEscapes = DEFAULT_STRIP_ESCAPES;
+    bStripTrailingWhitespace = DEFAULT_STRIP_TRAILING_WHITESPACE;
+    dwMemoryBudget = DEFAULT_MEMORY_BUDGET;
 
+    // Show settings if registry is uninitialized:
+    if (!GetRegValues()) {
+        ShowDialog();
+    }
+    GetBufferSizes();
+    Startup::Mark(Startup::Phase::SettingsLoaded);
+}
+
+void Init(HINSTANCE hInstance)
+{
     const INITCOMMONCONTROLSEX iccex{
         .dwSize = sizeof(INITCOMMONCONTROLSEX),
         .dwICC = ICC_STANDARD_CLASSES
@@ -161,9 +302,10 @@ void Init(HINSTANCE hInstance)
         .hIconSm = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_ICON))
     };
     ASSERT_WIN32(RegisterClassEx(&wcex));
+    bRegistered = TRUE;
 
-    // Show settings if registry is uninitialized:
-    if (!GetRegValues()) {
+    if (bShowPending) {
+        bShowPending = FALSE;
         ShowDialog();
     }
 }
@@ -25,34 +25,82 @@
 
 #pragma once
 
+#include "histogram.h"
+
 #include <windows.h>
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
+#include <string>
+
 namespace ClipSock::Settings {
 
 inline constexpr auto CLASSNAME = L"Settings Window Class";
 
 inline constexpr auto DEFAULT_LAUNCH_AT_STARTUP = TRUE;
 inline constexpr auto DEFAULT_LISTEN_ADDRESS = L"127.0.0.1:5494";
+inline constexpr auto DEFAULT_ACCESS_LIST = L"";
+inline constexpr auto DEFAULT_STRIP_ESCAPES = FALSE;
+inline constexpr auto DEFAULT_STRIP_TRAILING_WHITESPACE = FALSE;
+inline constexpr auto DEFAULT_MEMORY_BUDGET = 256; // megabytes
+
+inline constexpr auto MAXIMUM_ACCESS_LIST = 1024;
 
 inline constexpr auto REGKEY_APP = L"Software\\ClipSock";
+inline constexpr auto REGKEY_STATE = L"Software\\ClipSock\\State";
 inline constexpr auto REGKEY_RUN = L"Software\\Microsoft\\Windows\\CurrentVersion\\Run";
 inline constexpr auto REGVAL_APP = L"ClipSock";
 inline constexpr auto REGVAL_LAUNCH_AT_STARTUP = L"LaunchAtStartup";
 inline constexpr auto REGVAL_LISTEN_ADDRESS = L"ListenAddress";
+inline constexpr auto REGVAL_ACCESS_LIST = L"AccessList";
+inline constexpr auto REGVAL_STRIP_ESCAPES = L"StripEscapes";
+inline constexpr auto REGVAL_STRIP_TRAILING_WHITESPACE = L"StripTrailingWhitespace";
+inline constexpr auto REGVAL_MEMORY_BUDGET = L"MemoryBudget";
+inline constexpr auto REGVAL_BUFFER_SIZES = L"BufferSizes";
 
 extern BOOL bLaunchAtStartup;
 extern WCHAR szListenAddress[INET6_ADDRSTRLEN];
+extern WCHAR szAccessList[MAXIMUM_ACCESS_LIST];
+extern BOOL bStripEscapes;
+extern BOOL bStripTrailingWhitespace;
+extern DWORD dwMemoryBudget;
+
+// Buffer sizes are learned by the server rather than configured; they are
+// persisted under a separate key, which is not watched for changes, when
+// the server stops:
+extern SizeHistogram::CountArray BufferSizes;
+
+extern BOOL bRegistered;
+extern BOOL bShowPending;
+
+// Values holds the settings applied while running so that changes may be
+// compared and applied without restarting:
+struct Values {
+    BOOL bLaunchAtStartup;
+    std::wstring sListenAddress;
+    std::wstring sAccessList;
+    BOOL bStripEscapes;
+    BOOL bStripTrailingWhitespace;
+    DWORD dwMemoryBudget;
+
+    bool operator==(const Values&) const = default;
+};
+
+Values GetValues();
 
 BOOL GetRegValues();
+void Reload();
 void SetRegValues();
+void SetLaunchAtStartup();
+void GetBufferSizes();
+void SetBufferSizes();
 
 INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam);
 
 BOOL IsMessage(PMSG pMsg);
 void ShowDialog();
 
+void Load();
 void Init(HINSTANCE hInstance);
 
 } // namespace ClipSock::Settings
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define SIMD_X86
+#endif // x86
+
+// Clang and GCC require intrinsics beyond the baseline instruction set to be
+// enabled per function; MSVC makes them available unconditionally:
+#if defined(__clang__) || defined(__GNUC__)
+#define SIMD_TARGET(szTarget) __attribute__((target(szTarget)))
+#else
+#define SIMD_TARGET(szTarget)
+#endif // __clang__ || __GNUC__
+
+namespace ClipSock::Simd {
+
+inline bool HasSSE2()
+{
+#ifdef SIMD_X86
+    static const bool bPresent = IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE);
+    return bPresent;
+#else
+    return false;
+#endif // SIMD_X86
+}
+
+inline bool HasSSSE3()
+{
+#ifdef SIMD_X86
+    static const bool bPresent = IsProcessorFeaturePresent(PF_SSSE3_INSTRUCTIONS_AVAILABLE);
+    return bPresent;
+#else
+    return false;
+#endif // SIMD_X86
+}
+
+} // namespace ClipSock::Simd
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "startup.h"
+
+#include "metrics.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <string>
+
+namespace ClipSock::Startup {
+
+namespace {
+
+std::atomic<LONGLONG> Timestamps[PHASE_COUNT];
+
+// Each phase after process start is published as a gauge:
+constexpr Metrics::Metric PHASE_METRICS[]{
+    Metrics::Metric::Count,
+    Metrics::Metric::StartupSettingsLoaded,
+    Metrics::Metric::StartupListening,
+    Metrics::Metric::StartupTrayCreated,
+    Metrics::Metric::StartupFirstAccept,
+};
+
+static_assert(ARRAYSIZE(PHASE_METRICS) == PHASE_COUNT);
+
+ULONGLONG ToULongLong(const FILETIME& ft)
+{
+    return static_cast<ULONGLONG>(ft.dwHighDateTime) << 32 | ft.dwLowDateTime;
+}
+
+} // namespace
+
+BOOL Mark(Phase Id, LONGLONG llTimestamp)
+{
+    auto nIndex = static_cast<SIZE_T>(Id);
+    LONGLONG llExpected = 0;
+    if (!Timestamps[nIndex].compare_exchange_strong(llExpected, llTimestamp, std::memory_order_relaxed)) {
+        return FALSE;
+    }
+    if (Id != Phase::ProcessStart) {
+        Metrics::Set(PHASE_METRICS[nIndex], static_cast<LONGLONG>(GetElapsed(Id)));
+    }
+    return TRUE;
+}
+
+BOOL IsMarked(Phase Id)
+{
+    return Timestamps[static_cast<SIZE_T>(Id)].load(std::memory_order_relaxed) != 0;
+}
+
+ULONGLONG GetElapsed(Phase Id)
+{
+    auto llStart = Timestamps[static_cast<SIZE_T>(Phase::ProcessStart)].load(std::memory_order_relaxed);
+    auto llTimestamp = Timestamps[static_cast<SIZE_T>(Id)].load(std::memory_order_relaxed);
+    if (llStart == 0 || llTimestamp == 0) {
+        return 0;
+    }
+    return GetElapsedMicroseconds(llStart, llTimestamp);
+}
+
+std::string Format()
+{
+    std::string sTimeline;
+    for (SIZE_T i = 1; i < PHASE_COUNT; i++) {
+        auto Id = static_cast<Phase>(i);
+        if (!IsMarked(Id)) {
+            continue;
+        }
+        sTimeline += sTimeline.empty() ? "" : ", ";
+        sTimeline += std::format("{} {:.1f} ms", PHASE_NAMES[i], static_cast<double>(GetElapsed(Id)) / 1000);
+    }
+    return sTimeline;
+}
+
+void Reset()
+{
+    for (auto& llTimestamp : Timestamps) {
+        llTimestamp.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Init()
+{
+    // Process start is taken from the creation time so that time spent
+    // loading the image and its imports is included; the performance
+    // counter is used should it be unavailable:
+    auto llNow = GetTimestamp();
+    FILETIME ftNow;
+    GetSystemTimePreciseAsFileTime(&ftNow);
+
+    FILETIME ftCreation, ftExit, ftKernel, ftUser;
+    if (!GetProcessTimes(GetCurrentProcess(), &ftCreation, &ftExit, &ftKernel, &ftUser) ||
+        ToULongLong(ftNow) < ToULongLong(ftCreation)) {
+        Mark(Phase::ProcessStart, llNow);
+        return;
+    }
+
+    LARGE_INTEGER Frequency;
+    QueryPerformanceFrequency(&Frequency);
+
+    // File times are measured in 100-nanosecond intervals:
+    auto ullAge = ToULongLong(ftNow) - ToULongLong(ftCreation);
+    auto ullFrequency = static_cast<ULONGLONG>(Frequency.QuadPart);
+    auto ullTicks = ullAge / 10000000 * ullFrequency + ullAge % 10000000 * ullFrequency / 10000000;
+    Mark(Phase::ProcessStart, std::max(llNow - static_cast<LONGLONG>(ullTicks), 1LL));
+}
+
+} // namespace ClipSock::Startup
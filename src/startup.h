@@ -0,0 +1,74 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "latency.h"
+
+#include <windows.h>
+
+#include <atomic>
+#include <string>
+
+namespace ClipSock::Startup {
+
+// Phases are recorded in the order they are expected to complete; the tray
+// icon is created in parallel with listening, so it may complete before or
+// after the server is listening:
+enum class Phase : UINT {
+    ProcessStart,
+    SettingsLoaded,
+    Listening,
+    TrayCreated,
+    FirstAccept,
+    Count
+};
+
+inline constexpr auto PHASE_COUNT = static_cast<SIZE_T>(Phase::Count);
+
+inline constexpr PCSTR PHASE_NAMES[]{
+    "process start",
+    "settings loaded",
+    "listening",
+    "tray created",
+    "first accept",
+};
+
+static_assert(ARRAYSIZE(PHASE_NAMES) == PHASE_COUNT);
+
+// Only the first time each phase is reached is recorded; restarting the
+// server does not change the timeline:
+BOOL Mark(Phase Id, LONGLONG llTimestamp = GetTimestamp());
+BOOL IsMarked(Phase Id);
+
+// Elapsed time is measured from process start in microseconds and is zero
+// for phases that have not been reached:
+ULONGLONG GetElapsed(Phase Id);
+std::string Format();
+
+void Reset();
+void Init();
+
+} // namespace ClipSock::Startup
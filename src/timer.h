@@ -0,0 +1,241 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace ClipSock {
+
+// TimerWheel tracks a single deadline per key using a hierarchical timing
+// wheel. Scheduling, rescheduling and cancellation are constant time;
+// expiring a slot cascades entries from coarser levels as time advances.
+// Deadlines are rounded up to the resolution so timers never fire early.
+// Time is supplied by the caller to simplify testing.
+template<typename K>
+class TimerWheel {
+public:
+    using KeyType = K;
+
+    static constexpr auto SLOT_BITS = 6;
+    static constexpr auto SLOT_COUNT = 1u << SLOT_BITS;
+    static constexpr auto SLOT_MASK = ULONGLONG{SLOT_COUNT - 1};
+    static constexpr auto LEVEL_COUNT = 4;
+    static constexpr auto MAXIMUM_TICKS = (ULONGLONG{1} << (SLOT_BITS * LEVEL_COUNT)) - 1;
+
+    explicit TimerWheel(ULONGLONG ullResolution) : m_ullResolution{ullResolution} {}
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    SIZE_T Count() const { return m_Timers.size(); }
+
+    bool Contains(const K& Key) const { return m_Timers.contains(Key); }
+
+    void Schedule(const K& Key, ULONGLONG ullDeadline, ULONGLONG ullNow)
+    {
+        // An idle wheel is fast-forwarded to avoid clamping deadlines
+        // relative to a stale tick:
+        if (m_Timers.empty()) {
+            m_ullTick = std::max(m_ullTick, ullNow / m_ullResolution);
+        }
+
+        auto ullTick = std::max((ullDeadline + m_ullResolution - 1) / m_ullResolution, m_ullTick);
+        if (auto it = m_Timers.find(Key); it != m_Timers.end()) {
+            auto& Timer = it->second;
+            auto& Source = m_Slots[Timer.uLevel][Timer.uSlot];
+            auto uLevel = Timer.uLevel;
+            auto uSlot = Timer.uSlot;
+            Timer.ullTick = ullTick;
+            Link(Timer, Source, Timer.itNode);
+            if (Source.empty()) {
+                m_Occupied[uLevel] &= ~(ULONGLONG{1} << uSlot);
+            }
+        } else {
+            NodeList Node{Key};
+            auto& Timer = m_Timers[Key];
+            Timer.ullTick = ullTick;
+            Link(Timer, Node, Node.begin());
+        }
+    }
+
+    void Cancel(const K& Key)
+    {
+        if (auto it = m_Timers.find(Key); it != m_Timers.end()) {
+            auto& Timer = it->second;
+            auto& Slot = m_Slots[Timer.uLevel][Timer.uSlot];
+            Slot.erase(Timer.itNode);
+            if (Slot.empty()) {
+                m_Occupied[Timer.uLevel] &= ~(ULONGLONG{1} << Timer.uSlot);
+            }
+            m_Timers.erase(it);
+        }
+    }
+
+    // Advance returns keys whose deadlines have passed. Empty ticks are
+    // skipped, so the cost is proportional to the number of occupied slots
+    // and level boundaries crossed rather than elapsed time:
+    std::vector<K> Advance(ULONGLONG ullNow)
+    {
+        std::vector<K> Expired;
+        auto ullTarget = ullNow / m_ullResolution;
+        while (!m_Timers.empty()) {
+            auto ullTick = NextTick();
+            if (ullTick > ullTarget) {
+                break;
+            }
+
+            m_ullTick = ullTick;
+            Cascade();
+
+            NodeList Slot;
+            Take(0, static_cast<UINT>(m_ullTick & SLOT_MASK), Slot);
+            for (const auto& Key : Slot) {
+                m_Timers.erase(Key);
+                Expired.push_back(Key);
+            }
+            m_ullTick++;
+        }
+        m_ullTick = std::max(m_ullTick, ullTarget + 1);
+        return Expired;
+    }
+
+    // GetTimeout returns the number of milliseconds until the wheel must be
+    // advanced, suitable for use as a wait timeout:
+    DWORD GetTimeout(ULONGLONG ullNow) const
+    {
+        if (m_Timers.empty()) {
+            return INFINITE;
+        }
+
+        auto ullDue = NextTick() * m_ullResolution;
+        if (ullDue <= ullNow) {
+            return 0;
+        }
+        return static_cast<DWORD>(std::min<ULONGLONG>(ullDue - ullNow, INFINITE - 1));
+    }
+
+    void Clear()
+    {
+        for (auto& Level : m_Slots) {
+            for (auto& Slot : Level) {
+                Slot.clear();
+            }
+        }
+        m_Occupied.fill(0);
+        m_Timers.clear();
+        m_ullTick = 0;
+    }
+
+private:
+    using NodeList = std::list<K>;
+
+    struct Deadline {
+        ULONGLONG ullTick;
+        UINT uLevel;
+        UINT uSlot;
+        typename NodeList::iterator itNode;
+    };
+
+    // Link moves a node into the slot for its deadline relative to the
+    // current tick; deadlines beyond the range of the wheel are clamped:
+    void Link(Deadline& Timer, NodeList& Source, typename NodeList::iterator itNode)
+    {
+        auto ullDelta = Timer.ullTick - m_ullTick;
+        if (ullDelta > MAXIMUM_TICKS) {
+            ullDelta = MAXIMUM_TICKS;
+            Timer.ullTick = m_ullTick + ullDelta;
+        }
+
+        UINT uLevel = 0;
+        while (ullDelta >> (SLOT_BITS * (uLevel + 1))) {
+            uLevel++;
+        }
+
+        auto uSlot = static_cast<UINT>((Timer.ullTick >> (SLOT_BITS * uLevel)) & SLOT_MASK);
+        auto& Target = m_Slots[uLevel][uSlot];
+        Target.splice(Target.end(), Source, itNode);
+        m_Occupied[uLevel] |= ULONGLONG{1} << uSlot;
+        Timer.uLevel = uLevel;
+        Timer.uSlot = uSlot;
+        Timer.itNode = itNode;
+    }
+
+    void Take(UINT uLevel, UINT uSlot, NodeList& Nodes)
+    {
+        Nodes.splice(Nodes.end(), m_Slots[uLevel][uSlot]);
+        m_Occupied[uLevel] &= ~(ULONGLONG{1} << uSlot);
+    }
+
+    // Cascade redistributes coarser slots whose range begins at the current
+    // tick, starting with the coarsest level:
+    void Cascade()
+    {
+        for (auto uLevel = LEVEL_COUNT - 1; uLevel > 0; uLevel--) {
+            auto uShift = SLOT_BITS * uLevel;
+            if (m_ullTick & ((ULONGLONG{1} << uShift) - 1)) {
+                continue;
+            }
+
+            NodeList Nodes;
+            Take(uLevel, static_cast<UINT>((m_ullTick >> uShift) & SLOT_MASK), Nodes);
+            while (!Nodes.empty()) {
+                Link(m_Timers[Nodes.front()], Nodes, Nodes.begin());
+            }
+        }
+    }
+
+    // NextTick returns the next tick with an occupied slot, or the next
+    // boundary of the finest level if coarser levels must be cascaded:
+    ULONGLONG NextTick() const
+    {
+        auto ullNext = ULLONG_MAX;
+        auto ullOccupied = std::rotr(m_Occupied[0], static_cast<int>(m_ullTick & SLOT_MASK));
+        if (ullOccupied) {
+            ullNext = m_ullTick + static_cast<ULONGLONG>(std::countr_zero(ullOccupied));
+        }
+
+        if (std::any_of(m_Occupied.begin() + 1, m_Occupied.end(), [](auto ull) { return ull != 0; })) {
+            ullNext = std::min(ullNext, (m_ullTick + SLOT_MASK) & ~SLOT_MASK);
+        }
+        return ullNext;
+    }
+
+    ULONGLONG m_ullResolution;
+    ULONGLONG m_ullTick{0};
+    std::array<std::array<NodeList, SLOT_COUNT>, LEVEL_COUNT> m_Slots;
+    std::array<ULONGLONG, LEVEL_COUNT> m_Occupied{};
+    std::unordered_map<K, Deadline> m_Timers;
+};
+
+} // namespace ClipSock
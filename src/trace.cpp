@@ -0,0 +1,75 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "trace.h"
+
+#include "latency.h"
+#include "util.h"
+
+#include <gsl/gsl>
+
+#include <windows.h>
+
+#include <format>
+#include <string>
+#include <vector>
+
+namespace ClipSock::Trace {
+
+DefaultRing EventRing;
+
+std::string Format(const std::vector<Event>& TraceEvents, DWORD dwProcessId)
+{
+    // Events are written as complete events in the Chrome trace event
+    // format; timestamps are microseconds since the counter started:
+    std::string sTrace{"{\"traceEvents\":["};
+    for (auto& TraceEvent : TraceEvents) {
+        if (&TraceEvent != &TraceEvents.front()) {
+            sTrace.push_back(',');
+        }
+        sTrace += std::format("{{\"name\":\"{}\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":{},\"tid\":{}}}",
+                              TraceEvent.szName,
+                              GetElapsedMicroseconds(0, TraceEvent.llStart),
+                              GetElapsedMicroseconds(TraceEvent.llStart, TraceEvent.llEnd),
+                              dwProcessId, TraceEvent.dwThreadId);
+    }
+    sTrace.append("],\"displayTimeUnit\":\"ms\"}");
+    return sTrace;
+}
+
+void Save(PCWSTR szFileName)
+{
+    auto sTrace = Format(EventRing.Snapshot(), GetCurrentProcessId());
+
+    auto hFile = CreateFile(szFileName, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+    VERIFY_WIN32(hFile != INVALID_HANDLE_VALUE);
+    auto FinalAction = gsl::finally([&] { CloseHandle(hFile); });
+
+    DWORD cbWritten;
+    VERIFY_WIN32(WriteFile(hFile, sTrace.data(), static_cast<DWORD>(sTrace.size()), &cbWritten, nullptr));
+}
+
+} // namespace ClipSock::Trace
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "latency.h"
+
+#include <windows.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace ClipSock::Trace {
+
+#ifdef TRACING
+inline constexpr auto ENABLED = true;
+#else
+inline constexpr auto ENABLED = false;
+#endif // TRACING
+
+inline constexpr auto RING_CAPACITY = 4096;
+
+// Zone names must be string literals; they are recorded by pointer and
+// written to traces without escaping:
+struct Event {
+    PCSTR szName;
+    LONGLONG llStart;
+    LONGLONG llEnd;
+    DWORD dwThreadId;
+};
+
+// Ring retains the most recently recorded events. Writers claim a slot
+// without locking; each slot is guarded by a sequence number so that readers
+// may take a consistent snapshot while events are being recorded.
+template<SIZE_T Capacity>
+class Ring {
+public:
+    Ring() = default;
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    void Record(const Event& TraceEvent)
+    {
+        auto ullIndex = m_ullNext.fetch_add(1, std::memory_order_relaxed);
+        auto& Slot = m_Slots[ullIndex % Capacity];
+        Slot.ullSequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot.szName.store(TraceEvent.szName, std::memory_order_relaxed);
+        Slot.llStart.store(TraceEvent.llStart, std::memory_order_relaxed);
+        Slot.llEnd.store(TraceEvent.llEnd, std::memory_order_relaxed);
+        Slot.dwThreadId.store(TraceEvent.dwThreadId, std::memory_order_relaxed);
+        Slot.ullSequence.store(ullIndex + 1, std::memory_order_release);
+    }
+
+    // Returns retained events from oldest to newest; slots being written
+    // while the snapshot is taken are skipped:
+    std::vector<Event> Snapshot() const
+    {
+        std::vector<Event> TraceEvents;
+        auto ullNext = m_ullNext.load(std::memory_order_acquire);
+        auto ullFirst = ullNext > Capacity ? ullNext - Capacity : 0;
+        for (auto ullIndex = ullFirst; ullIndex < ullNext; ullIndex++) {
+            auto& Slot = m_Slots[ullIndex % Capacity];
+            if (Slot.ullSequence.load(std::memory_order_acquire) != ullIndex + 1) {
+                continue;
+            }
+
+            Event TraceEvent{
+                .szName = Slot.szName.load(std::memory_order_relaxed),
+                .llStart = Slot.llStart.load(std::memory_order_relaxed),
+                .llEnd = Slot.llEnd.load(std::memory_order_relaxed),
+                .dwThreadId = Slot.dwThreadId.load(std::memory_order_relaxed)
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Slot.ullSequence.load(std::memory_order_relaxed) == ullIndex + 1) {
+                TraceEvents.push_back(TraceEvent);
+            }
+        }
+        return TraceEvents;
+    }
+
+    void Clear()
+    {
+        for (auto& Slot : m_Slots) {
+            Slot.ullSequence.store(0, std::memory_order_relaxed);
+        }
+        m_ullNext.store(0, std::memory_order_release);
+    }
+
+private:
+    struct Entry {
+        std::atomic<ULONGLONG> ullSequence{0};
+        std::atomic<PCSTR> szName{nullptr};
+        std::atomic<LONGLONG> llStart{0};
+        std::atomic<LONGLONG> llEnd{0};
+        std::atomic<DWORD> dwThreadId{0};
+    };
+
+    std::atomic<ULONGLONG> m_ullNext{0};
+    Entry m_Slots[Capacity];
+};
+
+using DefaultRing = Ring<RING_CAPACITY>;
+
+extern DefaultRing EventRing;
+
+// Zone records the duration of the enclosing scope on destruction:
+class Zone {
+public:
+    explicit Zone(PCSTR szName) : m_szName{szName}, m_llStart{GetTimestamp()} {}
+
+    ~Zone()
+    {
+        EventRing.Record({m_szName, m_llStart, GetTimestamp(), GetCurrentThreadId()});
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    PCSTR m_szName;
+    LONGLONG m_llStart;
+};
+
+std::string Format(const std::vector<Event>& TraceEvents, DWORD dwProcessId);
+void Save(PCWSTR szFileName);
+
+} // namespace ClipSock::Trace
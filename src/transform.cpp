@@ -0,0 +1,210 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "transform.h"
+
+#include "simd.h"
+
+#include <windows.h>
+
+#ifdef SIMD_X86
+#include <emmintrin.h>
+#endif // SIMD_X86
+
+#include <bit>
+#include <cstring>
+
+namespace ClipSock::Transform {
+
+namespace {
+
+bool IsParameter(CHAR ch) { return ch >= 0x30 && ch <= 0x3F; }
+bool IsIntermediate(CHAR ch) { return ch >= 0x20 && ch <= 0x2F; }
+bool IsFinal(CHAR ch) { return ch >= 0x40 && ch <= 0x7E; }
+
+// Control strings (DCS, SOS, OSC, PM and APC) are terminated by BEL or ST;
+// an ESC not followed by a backslash begins a new sequence instead:
+SIZE_T SkipString(const CHAR* pData, SIZE_T cbData)
+{
+    for (SIZE_T i = 2; i < cbData; i++) {
+        if (pData[i] == BEL) {
+            return i + 1;
+        }
+        if (pData[i] == ESC) {
+            return i + 1 < cbData && pData[i + 1] == '\\' ? i + 2 : i;
+        }
+    }
+    return cbData;
+}
+
+} // namespace
+
+SIZE_T FindEscape(const CHAR* pData, SIZE_T cbData)
+{
+    return Simd::HasSSE2() ? FindEscapeSSE2(pData, cbData)
+                           : FindEscapeScalar(pData, cbData);
+}
+
+SIZE_T FindEscapeScalar(const CHAR* pData, SIZE_T cbData)
+{
+    auto pEscape = static_cast<const CHAR*>(std::memchr(pData, ESC, cbData));
+    return pEscape ? static_cast<SIZE_T>(pEscape - pData) : cbData;
+}
+
+#ifdef SIMD_X86
+SIMD_TARGET("sse2")
+SIZE_T FindEscapeSSE2(const CHAR* pData, SIZE_T cbData)
+{
+    const auto Escape = _mm_set1_epi8(ESC);
+    auto Compare = [&](SIZE_T uOffset) {
+        auto Input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + uOffset));
+        return _mm_cmpeq_epi8(Input, Escape);
+    };
+
+    // Scan 64 bytes per iteration, combining comparisons so that clean text
+    // requires a single test per block:
+    SIZE_T cbScanned = 0;
+    while (cbScanned + 64 <= cbData) {
+        auto Match0 = Compare(cbScanned);
+        auto Match1 = Compare(cbScanned + 16);
+        auto Match2 = Compare(cbScanned + 32);
+        auto Match3 = Compare(cbScanned + 48);
+        auto Any = _mm_or_si128(_mm_or_si128(Match0, Match1), _mm_or_si128(Match2, Match3));
+        if (_mm_movemask_epi8(Any)) {
+            break;
+        }
+        cbScanned += 64;
+    }
+
+    while (cbScanned + 16 <= cbData) {
+        auto uMask = static_cast<UINT>(_mm_movemask_epi8(Compare(cbScanned)));
+        if (uMask) {
+            return cbScanned + static_cast<SIZE_T>(std::countr_zero(uMask));
+        }
+        cbScanned += 16;
+    }
+    return cbScanned + FindEscapeScalar(pData + cbScanned, cbData - cbScanned);
+}
+#else
+SIZE_T FindEscapeSSE2(const CHAR* pData, SIZE_T cbData)
+{
+    return FindEscapeScalar(pData, cbData);
+}
+#endif // SIMD_X86
+
+SIZE_T SkipEscape(const CHAR* pData, SIZE_T cbData)
+{
+    if (cbData < 2) {
+        return cbData;
+    }
+
+    SIZE_T i = 1;
+    switch (pData[i]) {
+    case '[': // CSI
+        i++;
+        while (i < cbData && IsParameter(pData[i])) {
+            i++;
+        }
+        while (i < cbData && IsIntermediate(pData[i])) {
+            i++;
+        }
+        return i < cbData && IsFinal(pData[i]) ? i + 1 : i;
+
+    case ']': // OSC
+    case 'P': // DCS
+    case 'X': // SOS
+    case '^': // PM
+    case '_': // APC
+        return SkipString(pData, cbData);
+
+    default:
+        // Remaining sequences consist of intermediate bytes followed by a
+        // single final byte (e.g. character set designation); a lone ESC is
+        // dropped on its own:
+        while (i < cbData && IsIntermediate(pData[i])) {
+            i++;
+        }
+        return i < cbData && pData[i] >= 0x30 && pData[i] <= 0x7E ? i + 1 : i;
+    }
+}
+
+SIZE_T StripEscapes(CHAR* pData, SIZE_T cbData)
+{
+    SIZE_T cbIn = 0;
+    SIZE_T cbOut = 0;
+    while (cbIn < cbData) {
+        // Clean runs are located with a vectorized scan and only moved once
+        // an escape sequence has been removed:
+        auto cbClean = FindEscape(pData + cbIn, cbData - cbIn);
+        if (cbOut != cbIn) {
+            std::memmove(pData + cbOut, pData + cbIn, cbClean);
+        }
+        cbIn += cbClean;
+        cbOut += cbClean;
+
+        if (cbIn < cbData) {
+            cbIn += SkipEscape(pData + cbIn, cbData - cbIn);
+        }
+    }
+    return cbOut;
+}
+
+SIZE_T StripTrailingWhitespace(CHAR* pData, SIZE_T cbData)
+{
+    SIZE_T cbOut = 0;
+    SIZE_T uRun = 0;
+    SIZE_T cbRun = 0;
+    for (SIZE_T i = 0; i < cbData; i++) {
+        auto ch = pData[i];
+        if (ch == ' ' || ch == '\t') {
+            if (cbRun++ == 0) {
+                uRun = i;
+            }
+            continue;
+        }
+
+        // Whitespace is only retained when followed by text on the same line:
+        if (ch != '\r' && ch != '\n') {
+            std::memmove(pData + cbOut, pData + uRun, cbRun);
+            cbOut += cbRun;
+        }
+        cbRun = 0;
+        pData[cbOut++] = ch;
+    }
+    return cbOut;
+}
+
+SIZE_T Apply(DWORD dwFlags, CHAR* pData, SIZE_T cbData)
+{
+    if (dwFlags & STRIP_ESCAPES) {
+        cbData = StripEscapes(pData, cbData);
+    }
+    if (dwFlags & STRIP_TRAILING_WHITESPACE) {
+        cbData = StripTrailingWhitespace(pData, cbData);
+    }
+    return cbData;
+}
+
+} // namespace ClipSock::Transform
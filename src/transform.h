@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <windows.h>
+
+namespace ClipSock::Transform {
+
+inline constexpr CHAR BEL = '\x07';
+inline constexpr CHAR ESC = '\x1B';
+
+enum Flags : DWORD {
+    STRIP_ESCAPES = 0x1,
+    STRIP_TRAILING_WHITESPACE = 0x2
+};
+
+// FindEscape returns the offset of the first ESC byte, or cbData if none is
+// present:
+SIZE_T FindEscape(const CHAR* pData, SIZE_T cbData);
+
+SIZE_T FindEscapeScalar(const CHAR* pData, SIZE_T cbData);
+SIZE_T FindEscapeSSE2(const CHAR* pData, SIZE_T cbData);
+
+// SkipEscape returns the length of the escape sequence beginning at pData,
+// which must point to an ESC byte:
+SIZE_T SkipEscape(const CHAR* pData, SIZE_T cbData);
+
+// Transforms rewrite data in place and return the resulting length:
+SIZE_T StripEscapes(CHAR* pData, SIZE_T cbData);
+SIZE_T StripTrailingWhitespace(CHAR* pData, SIZE_T cbData);
+
+SIZE_T Apply(DWORD dwFlags, CHAR* pData, SIZE_T cbData);
+
+} // namespace ClipSock::Transform
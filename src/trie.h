@@ -0,0 +1,181 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "peer.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <vector>
+
+namespace ClipSock {
+
+// PrefixTrie maps address prefixes to values and finds the longest prefix
+// matching an address. Paths are compressed so that each node records the
+// full prefix it covers; lookups visit at most one node per distinct prefix
+// length along the path rather than one per bit. Nodes are stored in a
+// single vector and linked by index to keep the structure compact.
+template<typename V>
+class PrefixTrie {
+public:
+    using ValueType = V;
+
+    static constexpr BYTE MAXIMUM_BITS = 128;
+
+    SIZE_T Count() const { return m_cValues; }
+
+    void Insert(const Peer::Address& Prefix, BYTE cBits, const V& Value)
+    {
+        auto Key = Mask(Prefix, cBits);
+        auto uParent = NONE;
+        auto uChild = m_uRoot;
+        for (;;) {
+            if (uChild == NONE) {
+                Link(uParent, Key, NewNode(Key, cBits, Value));
+                return;
+            }
+
+            auto& Current = m_Nodes[uChild];
+            auto cCommon = std::min({CommonBits(Current.Prefix, Key), Current.cBits, cBits});
+            if (cCommon == Current.cBits) {
+                if (cBits == Current.cBits) {
+                    if (!Current.Value) {
+                        m_cValues++;
+                    }
+                    Current.Value = Value;
+                    return;
+                }
+                uParent = uChild;
+                uChild = Current.uChildren[GetBit(Key, Current.cBits)];
+                continue;
+            }
+
+            // The new prefix diverges from the current node; either it covers
+            // the current node, or a branch is needed where the two differ:
+            auto CurrentPrefix = Current.Prefix;
+            UINT uNode;
+            if (cCommon == cBits) {
+                uNode = NewNode(Key, cBits, Value);
+            } else {
+                uNode = NewNode(Mask(Key, cCommon), cCommon, std::nullopt);
+                m_Nodes[uNode].uChildren[GetBit(Key, cCommon)] = NewNode(Key, cBits, Value);
+            }
+            m_Nodes[uNode].uChildren[GetBit(CurrentPrefix, cCommon)] = uChild;
+            Link(uParent, Key, uNode);
+            return;
+        }
+    }
+
+    const V* Find(const Peer::Address& Address) const
+    {
+        const V* pValue = nullptr;
+        auto uNode = m_uRoot;
+        while (uNode != NONE) {
+            auto& Current = m_Nodes[uNode];
+            if (CommonBits(Current.Prefix, Address) < Current.cBits) {
+                break;
+            }
+            if (Current.Value) {
+                pValue = &*Current.Value;
+            }
+            if (Current.cBits == MAXIMUM_BITS) {
+                break;
+            }
+            uNode = Current.uChildren[GetBit(Address, Current.cBits)];
+        }
+        return pValue;
+    }
+
+    void Clear()
+    {
+        m_Nodes.clear();
+        m_uRoot = NONE;
+        m_cValues = 0;
+    }
+
+private:
+    static constexpr UINT NONE = static_cast<UINT>(-1);
+
+    struct Node {
+        Peer::Address Prefix;
+        BYTE cBits;
+        std::optional<V> Value;
+        UINT uChildren[2]{NONE, NONE};
+    };
+
+    static Peer::Address Mask(const Peer::Address& Address, BYTE cBits)
+    {
+        Peer::Address Masked{};
+        for (SIZE_T i = 0; i < Masked.size() && cBits > 0; ++i) {
+            auto cByteBits = std::min<BYTE>(cBits, 8);
+            Masked[i] = static_cast<BYTE>(Address[i] & (0xFF << (8 - cByteBits)));
+            cBits = static_cast<BYTE>(cBits - cByteBits);
+        }
+        return Masked;
+    }
+
+    static BYTE CommonBits(const Peer::Address& Address1, const Peer::Address& Address2)
+    {
+        for (SIZE_T i = 0; i < Address1.size(); ++i) {
+            if (auto bDiff = static_cast<BYTE>(Address1[i] ^ Address2[i])) {
+                return static_cast<BYTE>(i * 8 + std::countl_zero(bDiff));
+            }
+        }
+        return MAXIMUM_BITS;
+    }
+
+    static UINT GetBit(const Peer::Address& Address, BYTE uBit)
+    {
+        return (Address[uBit / 8] >> (7 - uBit % 8)) & 1;
+    }
+
+    UINT NewNode(const Peer::Address& Prefix, BYTE cBits, std::optional<V> Value)
+    {
+        if (Value) {
+            m_cValues++;
+        }
+        m_Nodes.push_back({Prefix, cBits, std::move(Value)});
+        return static_cast<UINT>(m_Nodes.size() - 1);
+    }
+
+    void Link(UINT uParent, const Peer::Address& Key, UINT uNode)
+    {
+        if (uParent == NONE) {
+            m_uRoot = uNode;
+        } else {
+            m_Nodes[uParent].uChildren[GetBit(Key, m_Nodes[uParent].cBits)] = uNode;
+        }
+    }
+
+    std::vector<Node> m_Nodes;
+    UINT m_uRoot{NONE};
+    SIZE_T m_cValues{0};
+};
+
+} // namespace ClipSock
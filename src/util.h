@@ -25,6 +25,12 @@
 
 #pragma once
 
+#include "error.h"
+
+#ifdef TRACING
+#include "trace.h"
+#endif // TRACING
+
 #include <windows.h>
 
 #include <format>
@@ -32,6 +38,7 @@
 #include <stdexcept>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 #ifdef DEBUG
 #define ERROR_LOCATION std::format("{}({},1): ", __FILE__, __LINE__)
@@ -52,16 +59,15 @@
 #define VERIFY_WIN32(bExpr_)                               \
     [](auto bExpr) {                                       \
         if (!bExpr) [[unlikely]] {                         \
-            auto upError = GetLastErrorMessageA();         \
-            THROW(upError.get());                          \
+            auto dwError = GetLastError();                 \
+            THROW("{}", GetCachedErrorMessageA(dwError));  \
         }                                                  \
     }(bExpr_)
 
 #define VERIFY_WIN32_RESULT(dwResult_)                     \
     [](auto dwResult) {                                    \
         if (dwResult != ERROR_SUCCESS) [[unlikely]] {      \
-            auto upError = GetErrorMessageA(dwResult);     \
-            THROW(upError.get());                          \
+            THROW("{}", GetCachedErrorMessageA(dwResult)); \
         }                                                  \
     }(dwResult_)
 
@@ -71,6 +77,33 @@
                      dwResult < dwFirst + dwLength);       \
     }(dwResult_, dwFirst_, dwLength_)
 
+// Non-throwing variants return a Win32Error from the enclosing function,
+// which must return a Win32Result. These are used where failures are
+// routine, such as clients resetting connections, to avoid formatting and
+// unwinding on every failure:
+#define TRY_WIN32(bExpr_)                                  \
+    do {                                                   \
+        if (!(bExpr_)) [[unlikely]] {                      \
+            return ClipSock::Win32Error{GetLastError()};   \
+        }                                                  \
+    } while (0)
+
+#define TRY_WIN32_RESULT(dwResult_)                        \
+    do {                                                   \
+        auto dwTryResult = static_cast<DWORD>(dwResult_);  \
+        if (dwTryResult != ERROR_SUCCESS) [[unlikely]] {   \
+            return ClipSock::Win32Error{dwTryResult};      \
+        }                                                  \
+    } while (0)
+
+#define TRY_RESULT(Result_)                                \
+    do {                                                   \
+        auto TryResult = (Result_);                        \
+        if (!TryResult) [[unlikely]] {                     \
+            return ClipSock::Win32Error{TryResult.Error()}; \
+        }                                                  \
+    } while (0)
+
 #ifdef DEBUG
 #define ASSERT(bExpr, svFormat, ...)    VERIFY(bExpr, svFormat, __VA_ARGS__)
 #define ASSERT_WIN32(bExpr)             VERIFY_WIN32(bExpr)
@@ -81,8 +114,72 @@
 #define ASSERT_WIN32_RESULT(dwResult)   static_cast<void>(dwResult)
 #endif // DEBUG
 
+// Tracing zones record the duration of the enclosing scope when built with
+// ENABLE_TRACING; otherwise they compile to nothing:
+#ifdef TRACING
+#define TRACE_CONCAT_(a, b)             a##b
+#define TRACE_CONCAT(a, b)              TRACE_CONCAT_(a, b)
+#define TRACE_ZONE(szName)              ClipSock::Trace::Zone TRACE_CONCAT(TraceZone, __LINE__){szName}
+#else
+#define TRACE_ZONE(szName)              static_cast<void>(0)
+#endif // TRACING
+
 namespace ClipSock {
 
+struct Win32Error {
+    DWORD dwError;
+};
+
+// Win32Result holds either a value or the error code of a failed call; it
+// follows std::expected, which is not available in C++20:
+template<typename T = void>
+class [[nodiscard]] Win32Result {
+public:
+    Win32Result(T Value) : m_Value{std::move(Value)}, m_bValue{TRUE} {}
+    Win32Result(Win32Error Error) : m_dwError{Error.dwError} {}
+
+    explicit operator bool() const
+    {
+        return m_bValue;
+    }
+
+    const T& Value() const
+    {
+        return m_Value;
+    }
+
+    DWORD Error() const
+    {
+        return m_dwError;
+    }
+
+private:
+    T m_Value{};
+    BOOL m_bValue{FALSE};
+    DWORD m_dwError{ERROR_SUCCESS};
+};
+
+template<>
+class [[nodiscard]] Win32Result<void> {
+public:
+    Win32Result() = default;
+    Win32Result(Win32Error Error) : m_bValue{FALSE}, m_dwError{Error.dwError} {}
+
+    explicit operator bool() const
+    {
+        return m_bValue;
+    }
+
+    DWORD Error() const
+    {
+        return m_dwError;
+    }
+
+private:
+    BOOL m_bValue{TRUE};
+    DWORD m_dwError{ERROR_SUCCESS};
+};
+
 constexpr auto MakeUnique(auto hMem)
 {
     return std::unique_ptr<std::remove_pointer_t<decltype(hMem)>>{hMem};
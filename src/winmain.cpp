@@ -27,6 +27,7 @@
 #include "notify.h"
 #include "server.h"
 #include "settings.h"
+#include "startup.h"
 
 #include <windows.h>
 
@@ -39,6 +40,8 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance,
                     _In_ PWSTR /*pCmdLine*/,
                     _In_ int /*nCmdShow*/)
 {
+    Startup::Init();
+
     CreateMutex(nullptr, TRUE, L"ClipSock Mutex");
     if (GetLastError() == ERROR_ALREADY_EXISTS) {
         return 0;
@@ -46,7 +49,14 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance,
 
     try {
         EventLog::Init();
+        EventLog::AsyncWriter.Start();
         Server::Init();
+
+        // The server starts listening as soon as settings are loaded; the
+        // settings dialog and tray icon are created while it accepts
+        // connections:
+        Settings::Load();
+        Server::Start();
         Settings::Init(hInstance);
         Notify::Init(hInstance);
 
@@ -57,6 +67,7 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance,
                 DispatchMessage(&msg);
             }
         }
+        EventLog::AsyncWriter.Stop();
         return static_cast<int>(msg.wParam);
     }
     catch (const std::exception& e) {
@@ -0,0 +1,292 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "util.h"
+
+#include <windows.h>
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ClipSock {
+
+// ExclusiveLock holds a slim reader/writer lock in exclusive mode for the
+// duration of the enclosing scope:
+class ExclusiveLock {
+public:
+    explicit ExclusiveLock(SRWLOCK& Lock) : m_Lock{Lock}
+    {
+        AcquireSRWLockExclusive(&m_Lock);
+    }
+
+    ~ExclusiveLock()
+    {
+        ReleaseSRWLockExclusive(&m_Lock);
+    }
+
+    ExclusiveLock(const ExclusiveLock&) = delete;
+    ExclusiveLock& operator=(const ExclusiveLock&) = delete;
+
+private:
+    SRWLOCK& m_Lock;
+};
+
+// WorkerPool processes entries on a fixed number of threads. Entries are
+// distributed round-robin to per-worker queues; each worker takes the oldest
+// entry from its own queue and, once empty, steals the newest entry from
+// another's. The pool counts submitted entries with a semaphore, so a woken
+// worker always finds an entry unless the pool is stopping. Entries are
+// processed inline while the pool is stopped. Handlers must not throw.
+template<typename T>
+class WorkerPool {
+public:
+    using Handler = void (*)(T& Entry);
+
+    explicit WorkerPool(Handler fnHandler) : m_fnHandler{fnHandler} {}
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    BOOL IsRunning() const
+    {
+        return m_bRunning.load(std::memory_order_acquire);
+    }
+
+    SIZE_T Pending() const
+    {
+        return m_cPending.load(std::memory_order_relaxed);
+    }
+
+    SIZE_T Workers() const
+    {
+        return m_Workers.size();
+    }
+
+    // Submit may only be called from a single thread:
+    void Submit(T&& Entry)
+    {
+        if (!IsRunning()) {
+            m_fnHandler(Entry);
+            return;
+        }
+
+        auto& pWorker = m_Workers[m_nNext++ % m_Workers.size()];
+        {
+            ExclusiveLock Lock{pWorker->Lock};
+            pWorker->Entries.push_back(std::move(Entry));
+        }
+        m_cPending.fetch_add(1, std::memory_order_relaxed);
+        ReleaseSemaphore(m_hSemaphore, 1, nullptr);
+    }
+
+    void Start(DWORD cWorkers)
+    {
+        VERIFY(cWorkers > 0, "Invalid number of workers: {}", cWorkers);
+
+        m_hSemaphore = CreateSemaphore(nullptr, 0, MAXLONG, nullptr);
+        VERIFY_WIN32(m_hSemaphore);
+
+        m_bStopRequested = FALSE;
+        for (DWORD i = 0; i < cWorkers; i++) {
+            auto pWorker = std::make_unique<Worker>();
+            pWorker->pPool = this;
+            pWorker->nIndex = i;
+            pWorker->hThread = CreateThread(nullptr, 0, ThreadProc, pWorker.get(), 0, nullptr);
+            if (!pWorker->hThread) {
+                auto dwError = GetLastError();
+                Stop();
+                VERIFY_WIN32_RESULT(dwError);
+            }
+            m_Workers.push_back(std::move(pWorker));
+        }
+        m_bRunning = TRUE;
+    }
+
+    // Entries submitted before stopping are processed before the workers
+    // exit; each worker is released once more than there are entries:
+    void Stop()
+    {
+        m_bRunning = FALSE;
+        m_bStopRequested = TRUE;
+        if (!m_Workers.empty()) {
+            ReleaseSemaphore(m_hSemaphore, static_cast<LONG>(m_Workers.size()), nullptr);
+        }
+        for (auto& pWorker : m_Workers) {
+            WaitForSingleObject(pWorker->hThread, INFINITE);
+            CloseHandle(pWorker->hThread);
+        }
+        m_Workers.clear();
+        m_nNext = 0;
+
+        if (m_hSemaphore) {
+            CloseHandle(m_hSemaphore);
+            m_hSemaphore = nullptr;
+        }
+    }
+
+private:
+    struct Worker {
+        WorkerPool* pPool;
+        SIZE_T nIndex;
+        HANDLE hThread;
+        SRWLOCK Lock = SRWLOCK_INIT;
+        std::deque<T> Entries;
+    };
+
+    static DWORD WINAPI ThreadProc(PVOID pParam)
+    {
+        auto pWorker = static_cast<Worker*>(pParam);
+        auto pPool = pWorker->pPool;
+        for (;;) {
+            WaitForSingleObject(pPool->m_hSemaphore, INFINITE);
+
+            auto Entry = pPool->Take(pWorker->nIndex);
+            if (!Entry) {
+                if (pPool->m_bStopRequested.load(std::memory_order_acquire)) {
+                    return 0;
+                }
+                continue;
+            }
+            pPool->m_cPending.fetch_sub(1, std::memory_order_relaxed);
+            pPool->m_fnHandler(*Entry);
+        }
+    }
+
+    std::optional<T> Take(SIZE_T nIndex)
+    {
+        auto& pOwn = m_Workers[nIndex];
+        {
+            ExclusiveLock Lock{pOwn->Lock};
+            if (!pOwn->Entries.empty()) {
+                auto Entry = std::make_optional(std::move(pOwn->Entries.front()));
+                pOwn->Entries.pop_front();
+                return Entry;
+            }
+        }
+
+        // Victims are visited starting from the next worker so that steals
+        // are spread across queues:
+        for (SIZE_T i = 1; i < m_Workers.size(); i++) {
+            auto& pVictim = m_Workers[(nIndex + i) % m_Workers.size()];
+            ExclusiveLock Lock{pVictim->Lock};
+            if (!pVictim->Entries.empty()) {
+                auto Entry = std::make_optional(std::move(pVictim->Entries.back()));
+                pVictim->Entries.pop_back();
+                return Entry;
+            }
+        }
+        return std::nullopt;
+    }
+
+    Handler m_fnHandler;
+    std::vector<std::unique_ptr<Worker>> m_Workers;
+    std::atomic<BOOL> m_bRunning{FALSE};
+    std::atomic<BOOL> m_bStopRequested{FALSE};
+    std::atomic<SIZE_T> m_cPending{0};
+    SIZE_T m_nNext{0};
+    HANDLE m_hSemaphore{nullptr};
+};
+
+// Sequencer commits entries in the order they were numbered regardless of
+// the order in which they complete. Whichever thread completes the next
+// entry in sequence commits it along with any entries completed ahead of
+// it. Entries are committed outside the lock so that other threads may
+// complete entries meanwhile; a thread that completes an entry while
+// another is committing leaves its entry to that thread, which serializes
+// commits. Handlers must not throw.
+template<typename T>
+class Sequencer {
+public:
+    using Handler = void (*)(T& Entry);
+
+    explicit Sequencer(Handler fnCommit) : m_fnCommit{fnCommit} {}
+
+    Sequencer(const Sequencer&) = delete;
+    Sequencer& operator=(const Sequencer&) = delete;
+
+    // Next may only be called from a single thread; every number returned
+    // must be completed exactly once:
+    ULONGLONG Next()
+    {
+        return m_ullNext++;
+    }
+
+    void Complete(ULONGLONG ullSequence, T&& Entry)
+    {
+        {
+            ExclusiveLock Lock{m_Lock};
+            m_Completed.emplace(ullSequence, std::move(Entry));
+            if (m_bCommitting) {
+                return;
+            }
+            m_bCommitting = TRUE;
+        }
+
+        // Ready entries are taken in batches until none remain; entries
+        // completed during a commit are picked up by the next batch:
+        std::vector<T> Ready;
+        for (;;) {
+            {
+                ExclusiveLock Lock{m_Lock};
+                while (!m_Completed.empty() && m_Completed.begin()->first == m_ullCommitted) {
+                    auto Node = m_Completed.extract(m_Completed.begin());
+                    Ready.push_back(std::move(Node.mapped()));
+                    m_ullCommitted++;
+                }
+                if (Ready.empty()) {
+                    m_bCommitting = FALSE;
+                    return;
+                }
+            }
+            for (auto& ReadyEntry : Ready) {
+                m_fnCommit(ReadyEntry);
+            }
+            Ready.clear();
+        }
+    }
+
+    SIZE_T Pending()
+    {
+        ExclusiveLock Lock{m_Lock};
+        return m_Completed.size();
+    }
+
+private:
+    Handler m_fnCommit;
+    SRWLOCK m_Lock = SRWLOCK_INIT;
+    std::map<ULONGLONG, T> m_Completed;
+    ULONGLONG m_ullNext{0};
+    ULONGLONG m_ullCommitted{0};
+    BOOL m_bCommitting{FALSE};
+};
+
+} // namespace ClipSock
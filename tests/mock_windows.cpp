@@ -51,6 +51,44 @@ MOCK_EXPORT BOOL WINAPI GlobalUnlock(HGLOBAL hMem)
     return MockGlobal::Call(&MockWindows::GlobalUnlock, hMem);
 }
 
+MOCK_EXPORT HANDLE WINAPI CreateMemoryResourceNotification(MEMORY_RESOURCE_NOTIFICATION_TYPE NotificationType)
+{
+    return MockGlobal::Call(&MockWindows::CreateMemoryResourceNotification, NotificationType);
+}
+
+MOCK_EXPORT BOOL WINAPI QueryMemoryResourceNotification(HANDLE ResourceNotificationHandle,
+                                                        PBOOL ResourceState)
+{
+    return MockGlobal::Call(&MockWindows::QueryMemoryResourceNotification,
+                            ResourceNotificationHandle, ResourceState);
+}
+
+MOCK_EXPORT HANDLE WINAPI CreateFileMappingW(HANDLE hFile,
+                                             LPSECURITY_ATTRIBUTES lpFileMappingAttributes,
+                                             DWORD flProtect,
+                                             DWORD dwMaximumSizeHigh,
+                                             DWORD dwMaximumSizeLow,
+                                             LPCWSTR lpName)
+{
+    return MockGlobal::Call(&MockWindows::CreateFileMappingW, hFile, lpFileMappingAttributes,
+                            flProtect, dwMaximumSizeHigh, dwMaximumSizeLow, lpName);
+}
+
+MOCK_EXPORT LPVOID WINAPI MapViewOfFile(HANDLE hFileMappingObject,
+                                        DWORD dwDesiredAccess,
+                                        DWORD dwFileOffsetHigh,
+                                        DWORD dwFileOffsetLow,
+                                        SIZE_T dwNumberOfBytesToMap)
+{
+    return MockGlobal::Call(&MockWindows::MapViewOfFile, hFileMappingObject, dwDesiredAccess,
+                            dwFileOffsetHigh, dwFileOffsetLow, dwNumberOfBytesToMap);
+}
+
+MOCK_EXPORT BOOL WINAPI UnmapViewOfFile(LPCVOID lpBaseAddress)
+{
+    return MockGlobal::Call(&MockWindows::UnmapViewOfFile, lpBaseAddress);
+}
+
 MOCK_EXPORT BOOL WINAPI CloseClipboard()
 {
     return MockGlobal::Call(&MockWindows::CloseClipboard);
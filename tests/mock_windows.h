@@ -51,6 +51,15 @@ public:
     MOCK_METHOD(LPVOID, GlobalLock, (HGLOBAL), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(BOOL, GlobalUnlock, (HGLOBAL), (Calltype(MOCK_EXPORT)));
 
+    MOCK_METHOD(HANDLE, CreateMemoryResourceNotification, (MEMORY_RESOURCE_NOTIFICATION_TYPE),
+                (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(BOOL, QueryMemoryResourceNotification, (HANDLE, PBOOL), (Calltype(MOCK_EXPORT)));
+
+    MOCK_METHOD(HANDLE, CreateFileMappingW, (HANDLE, LPSECURITY_ATTRIBUTES, DWORD, DWORD, DWORD, LPCWSTR),
+                (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(LPVOID, MapViewOfFile, (HANDLE, DWORD, DWORD, DWORD, SIZE_T), (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(BOOL, UnmapViewOfFile, (LPCVOID), (Calltype(MOCK_EXPORT)));
+
     MOCK_METHOD(BOOL, CloseClipboard, (), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(BOOL, EmptyClipboard, (), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(BOOL, OpenClipboard, (HWND), (Calltype(MOCK_EXPORT)));
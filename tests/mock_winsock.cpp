@@ -36,16 +36,47 @@ MOCK_EXPORT SOCKET WSAAPI accept(SOCKET s, struct sockaddr* addr, int* addrlen)
     return MockGlobal::Call(&MockWinsock::accept, s, addr, addrlen);
 }
 
+MOCK_EXPORT int WSAAPI bind(SOCKET s, const struct sockaddr* name, int namelen)
+{
+    return MockGlobal::Call(&MockWinsock::bind, s, name, namelen);
+}
+
 MOCK_EXPORT int WSAAPI closesocket(SOCKET s)
 {
     return MockGlobal::Call(&MockWinsock::closesocket, s);
 }
 
+MOCK_EXPORT int WSAAPI listen(SOCKET s, int backlog)
+{
+    return MockGlobal::Call(&MockWinsock::listen, s, backlog);
+}
+
 MOCK_EXPORT int WSAAPI recv(SOCKET s, char* buf, int len, int flags)
 {
     return MockGlobal::Call(&MockWinsock::recv, s, buf, len, flags);
 }
 
+MOCK_EXPORT int WSAAPI send(SOCKET s, const char* buf, int len, int flags)
+{
+    return MockGlobal::Call(&MockWinsock::send, s, buf, len, flags);
+}
+
+MOCK_EXPORT int WSAAPI setsockopt(SOCKET s, int level, int optname, const char* optval, int optlen)
+{
+    return MockGlobal::Call(&MockWinsock::setsockopt, s, level, optname, optval, optlen);
+}
+
+MOCK_EXPORT SOCKET WSAAPI socket(int af, int type, int protocol)
+{
+    return MockGlobal::Call(&MockWinsock::socket, af, type, protocol);
+}
+
+MOCK_EXPORT SOCKET WSAAPI WSAAccept(SOCKET s, struct sockaddr* addr, LPINT addrlen,
+                                    LPCONDITIONPROC lpfnCondition, DWORD_PTR dwCallbackData)
+{
+    return MockGlobal::Call(&MockWinsock::WSAAccept, s, addr, addrlen, lpfnCondition, dwCallbackData);
+}
+
 MOCK_EXPORT BOOL WSAAPI WSACloseEvent(WSAEVENT hEvent)
 {
     return MockGlobal::Call(&MockWinsock::WSACloseEvent, hEvent);
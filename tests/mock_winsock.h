@@ -40,9 +40,15 @@
 class MockWinsock {
 public:
     MOCK_METHOD(SOCKET, accept, (SOCKET, struct sockaddr*, int*), (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(int, bind, (SOCKET, const struct sockaddr*, int), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(int, closesocket, (SOCKET), (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(int, listen, (SOCKET, int), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(int, recv, (SOCKET, char*, int, int), (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(int, send, (SOCKET, const char*, int, int), (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(int, setsockopt, (SOCKET, int, int, const char*, int), (Calltype(MOCK_EXPORT)));
+    MOCK_METHOD(SOCKET, socket, (int, int, int), (Calltype(MOCK_EXPORT)));
 
+    MOCK_METHOD(SOCKET, WSAAccept, (SOCKET, struct sockaddr*, LPINT, LPCONDITIONPROC, DWORD_PTR), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(BOOL, WSACloseEvent, (WSAEVENT), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(WSAEVENT, WSACreateEvent, (), (Calltype(MOCK_EXPORT)));
     MOCK_METHOD(int, WSAEnumNetworkEvents, (SOCKET, WSAEVENT, LPWSANETWORKEVENTS), (Calltype(MOCK_EXPORT)));
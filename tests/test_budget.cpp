@@ -0,0 +1,82 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "budget.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ClipSock;
+using namespace testing;
+
+class MemoryBudgetTest : public Test {
+protected:
+    static constexpr auto TEST_LIMIT = 1000;
+
+    MemoryBudget test_Budget{TEST_LIMIT};
+};
+
+TEST_F(MemoryBudgetTest, Reserve)
+{
+    // Verify behavior when reserving up to the limit:
+    EXPECT_TRUE(test_Budget.TryReserve(0, 600));
+    EXPECT_TRUE(test_Budget.TryReserve(0, 400));
+    EXPECT_FALSE(test_Budget.TryReserve(0, 1));
+    EXPECT_EQ(test_Budget.Reserved(), TEST_LIMIT);
+}
+
+TEST_F(MemoryBudgetTest, Resize)
+{
+    // Verify behavior when resizing an existing reservation:
+    EXPECT_TRUE(test_Budget.TryReserve(0, 600));
+    EXPECT_TRUE(test_Budget.TryReserve(600, 1000));
+    EXPECT_FALSE(test_Budget.TryReserve(1000, 1001));
+    EXPECT_TRUE(test_Budget.TryReserve(1000, 200));
+    EXPECT_EQ(test_Budget.Reserved(), 200);
+}
+
+TEST_F(MemoryBudgetTest, HighWater)
+{
+    // Verify behavior when reservations are released:
+    EXPECT_TRUE(test_Budget.TryReserve(0, 800));
+    test_Budget.Release(500);
+    EXPECT_TRUE(test_Budget.TryReserve(0, 100));
+    EXPECT_EQ(test_Budget.Reserved(), 400);
+    EXPECT_EQ(test_Budget.HighWater(), 800);
+
+    test_Budget.Reset();
+    EXPECT_EQ(test_Budget.Reserved(), 0);
+    EXPECT_EQ(test_Budget.HighWater(), 0);
+}
+
+TEST_F(MemoryBudgetTest, Limit)
+{
+    // Verify behavior when the limit is lowered below current usage:
+    EXPECT_TRUE(test_Budget.TryReserve(0, 800));
+    test_Budget.SetLimit(500);
+    EXPECT_FALSE(test_Budget.CanReserve(0, 1));
+    EXPECT_TRUE(test_Budget.CanReserve(800, 300));
+    EXPECT_FALSE(test_Budget.CanReserve(800, 900));
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+using namespace ClipSock;
+using namespace testing;
+
+class CacheTest : public Test {
+protected:
+    static constexpr auto TEST_MAXIMUM_BYTES = 100;
+    static constexpr auto TEST_MAXIMUM_COUNT = 3;
+    static constexpr auto TEST_TIMEOUT = 1000;
+
+    using TestCache = ExpiringCache<int, std::unique_ptr<std::string>>;
+
+    TestCache test_Cache{TEST_MAXIMUM_BYTES, TEST_MAXIMUM_COUNT, TEST_TIMEOUT};
+
+    bool Insert(int Key, SIZE_T cbValue, ULONGLONG ullNow = 0)
+    {
+        auto Value = std::make_unique<std::string>(std::to_string(Key));
+        return test_Cache.Insert(Key, std::move(Value), cbValue, ullNow);
+    }
+};
+
+TEST_F(CacheTest, InsertAndExtract)
+{
+    // Verify behavior when inserting and extracting an entry:
+    EXPECT_TRUE(Insert(1, 10));
+    EXPECT_EQ(test_Cache.Count(), 1);
+    EXPECT_EQ(test_Cache.Bytes(), 10);
+
+    auto test_Value = test_Cache.Extract(1, 0);
+    ASSERT_TRUE(test_Value);
+    EXPECT_EQ(**test_Value, "1");
+    EXPECT_EQ(test_Cache.Count(), 0);
+    EXPECT_EQ(test_Cache.Bytes(), 0);
+}
+
+TEST_F(CacheTest, ExtractMissing)
+{
+    // Verify behavior when extracting an entry that does not exist:
+    EXPECT_FALSE(test_Cache.Extract(1, 0));
+}
+
+TEST_F(CacheTest, InsertReplaces)
+{
+    // Verify behavior when inserting an existing key:
+    EXPECT_TRUE(Insert(1, 10));
+    EXPECT_TRUE(Insert(1, 20));
+    EXPECT_EQ(test_Cache.Count(), 1);
+    EXPECT_EQ(test_Cache.Bytes(), 20);
+}
+
+TEST_F(CacheTest, EvictByCount)
+{
+    // Verify behavior when the maximum number of entries is exceeded:
+    for (auto i = 0; i <= TEST_MAXIMUM_COUNT; i++) {
+        EXPECT_TRUE(Insert(i, 1));
+    }
+    EXPECT_EQ(test_Cache.Count(), TEST_MAXIMUM_COUNT);
+    EXPECT_FALSE(test_Cache.Contains(0));
+    EXPECT_TRUE(test_Cache.Contains(TEST_MAXIMUM_COUNT));
+}
+
+TEST_F(CacheTest, EvictByBytes)
+{
+    // Verify behavior when the maximum number of bytes is exceeded:
+    EXPECT_TRUE(Insert(1, 40));
+    EXPECT_TRUE(Insert(2, 40));
+    EXPECT_TRUE(Insert(3, 40));
+    EXPECT_FALSE(test_Cache.Contains(1));
+    EXPECT_TRUE(test_Cache.Contains(2));
+    EXPECT_TRUE(test_Cache.Contains(3));
+    EXPECT_EQ(test_Cache.Bytes(), 80);
+}
+
+TEST_F(CacheTest, InsertOversized)
+{
+    // Verify behavior when an entry can never fit:
+    EXPECT_TRUE(Insert(1, 10));
+    EXPECT_FALSE(Insert(2, TEST_MAXIMUM_BYTES + 1));
+    EXPECT_TRUE(test_Cache.Contains(1));
+    EXPECT_FALSE(test_Cache.Contains(2));
+}
+
+TEST_F(CacheTest, Expire)
+{
+    // Verify behavior when entries exceed their timeout:
+    EXPECT_TRUE(Insert(1, 10, 0));
+    EXPECT_TRUE(Insert(2, 10, TEST_TIMEOUT / 2));
+
+    test_Cache.Expire(TEST_TIMEOUT);
+    EXPECT_FALSE(test_Cache.Contains(1));
+    EXPECT_TRUE(test_Cache.Contains(2));
+
+    EXPECT_FALSE(test_Cache.Extract(2, TEST_TIMEOUT + TEST_TIMEOUT / 2));
+    EXPECT_EQ(test_Cache.Bytes(), 0);
+}
+
+TEST_F(CacheTest, SetMaximum)
+{
+    EXPECT_TRUE(Insert(1, 30));
+    EXPECT_TRUE(Insert(2, 30));
+    EXPECT_TRUE(Insert(3, 30));
+
+    // Verify behavior when limits are lowered and raised again:
+    test_Cache.SetMaximum(60, TEST_MAXIMUM_COUNT);
+    EXPECT_FALSE(test_Cache.Contains(1));
+    EXPECT_EQ(test_Cache.Count(), 2);
+
+    test_Cache.SetMaximum(0, 0);
+    EXPECT_EQ(test_Cache.Count(), 0);
+    EXPECT_FALSE(Insert(4, 10));
+
+    test_Cache.SetMaximum(TEST_MAXIMUM_BYTES, TEST_MAXIMUM_COUNT);
+    EXPECT_TRUE(Insert(4, 10));
+}
+
+TEST_F(CacheTest, Find)
+{
+    EXPECT_TRUE(Insert(1, 10));
+
+    // Verify behavior when finding an entry without extracting it:
+    auto pValue = test_Cache.Find(1);
+    ASSERT_TRUE(pValue);
+    EXPECT_EQ(**pValue, "1");
+    EXPECT_TRUE(test_Cache.Contains(1));
+    EXPECT_FALSE(test_Cache.Find(2));
+}
+
+TEST_F(CacheTest, Trim)
+{
+    EXPECT_TRUE(Insert(1, 30));
+    EXPECT_TRUE(Insert(2, 30));
+    EXPECT_TRUE(Insert(3, 30));
+
+    // Verify behavior when entries are trimmed to a number of bytes:
+    test_Cache.Trim(60);
+    EXPECT_FALSE(test_Cache.Contains(1));
+    EXPECT_EQ(test_Cache.Bytes(), 60);
+
+    test_Cache.Trim(0);
+    EXPECT_EQ(test_Cache.Count(), 0);
+    EXPECT_TRUE(Insert(4, 30));
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "delta.h"
+#include "protocol.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ClipSock;
+using namespace testing;
+
+class DeltaTest : public Test {
+protected:
+    static constexpr auto TEST_TEXT_SIZE = 4096;
+
+    std::string MakeText(char chSeed)
+    {
+        std::string sText;
+        for (auto i = 0; i < TEST_TEXT_SIZE; i++) {
+            sText.push_back(static_cast<char>('a' + (i * chSeed + i / 7) % 26));
+            if (i % 61 == 60) {
+                sText.push_back('\n');
+            }
+        }
+        return sText;
+    }
+
+    std::string Rebuild(std::string_view svBase, std::string_view svFrame)
+    {
+        auto Header = Delta::GetHeader(svFrame);
+        std::string sText(Header.cbLength, '\0');
+        Delta::Apply(svBase, svFrame.substr(Delta::HEADER_SIZE), sText.data(), sText.size(),
+                     Header.ullTargetHash);
+        return sText;
+    }
+};
+
+TEST_F(DeltaTest, Hash)
+{
+    // Verify behavior when hashing known values:
+    EXPECT_EQ(Delta::Hash(""), 0xCBF29CE484222325);
+    EXPECT_EQ(Delta::Hash("a"), 0xAF63DC4C8601EC8C);
+    EXPECT_NE(Delta::Hash("ab"), Delta::Hash("ba"));
+}
+
+TEST_F(DeltaTest, Classify)
+{
+    using namespace std::string_literals;
+
+    // Verify behavior when classifying partial and complete prefixes:
+    EXPECT_EQ(Protocol::Classify(""), Protocol::Mode::Unknown);
+    EXPECT_EQ(Protocol::Classify("\0C"s), Protocol::Mode::Unknown);
+    EXPECT_EQ(Protocol::Classify("\0CSD"s), Protocol::Mode::Delta);
+    EXPECT_EQ(Protocol::Classify("hello"), Protocol::Mode::Raw);
+    EXPECT_EQ(Protocol::Classify("\0X"s), Protocol::Mode::Raw);
+    EXPECT_THROW(Protocol::Classify("\0CS?"s), std::runtime_error);
+}
+
+TEST_F(DeltaTest, EncodeHeader)
+{
+    auto test_Base = MakeText(3);
+    auto test_Target = test_Base + "tail";
+
+    // Verify behavior when encoding the frame header:
+    auto test_Frame = Delta::Encode(test_Base, test_Target);
+    ASSERT_GE(test_Frame.size(), Delta::HEADER_SIZE);
+    EXPECT_EQ(Protocol::Classify(test_Frame), Protocol::Mode::Delta);
+
+    auto test_Header = Delta::GetHeader(test_Frame);
+    EXPECT_EQ(test_Header.ullBaseHash, Delta::Hash(test_Base));
+    EXPECT_EQ(test_Header.ullTargetHash, Delta::Hash(test_Target));
+    EXPECT_EQ(test_Header.cbLength, test_Target.size());
+}
+
+TEST_F(DeltaTest, RoundTrip)
+{
+    auto test_Base = MakeText(3);
+    auto test_Target = test_Base;
+    test_Target.replace(1000, 10, "edited line");
+    test_Target.insert(3000, "inserted\n");
+    test_Target.erase(200, 50);
+
+    // Verify behavior when re-sending a lightly edited base:
+    auto test_Frame = Delta::Encode(test_Base, test_Target);
+    EXPECT_LT(test_Frame.size(), test_Target.size() / 4);
+    EXPECT_EQ(Rebuild(test_Base, test_Frame), test_Target);
+}
+
+TEST_F(DeltaTest, RoundTripUnrelated)
+{
+    auto test_Base = MakeText(3);
+    auto test_Target = MakeText(5);
+
+    // Verify behavior when the target shares nothing with the base:
+    auto test_Frame = Delta::Encode(test_Base, test_Target);
+    EXPECT_EQ(Rebuild(test_Base, test_Frame), test_Target);
+}
+
+TEST_F(DeltaTest, RoundTripEmpty)
+{
+    auto test_Base = MakeText(3);
+
+    // Verify behavior when either side is empty:
+    EXPECT_EQ(Rebuild("", Delta::Encode("", test_Base)), test_Base);
+    EXPECT_EQ(Rebuild(test_Base, Delta::Encode(test_Base, "")), "");
+}
+
+TEST_F(DeltaTest, ApplyCopyOutOfRange)
+{
+    std::string test_Ops{Delta::OP_COPY};
+    Protocol::PutUInt32(test_Ops, 2);
+    Protocol::PutUInt32(test_Ops, 4);
+    char test_Out[4];
+
+    // Verify behavior when a copy exceeds the base:
+    EXPECT_THROW(Delta::Apply("base", test_Ops, test_Out, sizeof(test_Out), 0), std::runtime_error);
+}
+
+TEST_F(DeltaTest, ApplyCopyWraps)
+{
+    std::string test_Ops{Delta::OP_COPY};
+    Protocol::PutUInt32(test_Ops, 0xFFFFFFF0);
+    Protocol::PutUInt32(test_Ops, 0x20);
+    char test_Out[0x20];
+
+    // Verify behavior when the end of a copy wraps around 32 bits:
+    EXPECT_THROW(Delta::Apply("base", test_Ops, test_Out, sizeof(test_Out), 0), std::runtime_error);
+}
+
+TEST_F(DeltaTest, ApplyLiteralTruncated)
+{
+    std::string test_Ops{Delta::OP_LITERAL};
+    Protocol::PutUInt32(test_Ops, 4);
+    test_Ops.append("ab");
+    char test_Out[4];
+
+    // Verify behavior when a literal is truncated:
+    EXPECT_THROW(Delta::Apply("", test_Ops, test_Out, sizeof(test_Out), 0), std::runtime_error);
+}
+
+TEST_F(DeltaTest, ApplyLengthMismatch)
+{
+    std::string test_Ops{Delta::OP_LITERAL};
+    Protocol::PutUInt32(test_Ops, 2);
+    test_Ops.append("ab");
+    char test_Out[4];
+
+    // Verify behavior when operations do not fill the declared length:
+    EXPECT_THROW(Delta::Apply("", test_Ops, test_Out, sizeof(test_Out), 0), std::runtime_error);
+}
+
+TEST_F(DeltaTest, ApplyUnsupportedOperation)
+{
+    std::string test_Ops{"?"};
+    char test_Out[4];
+
+    // Verify behavior when an unknown operation is encountered:
+    EXPECT_THROW(Delta::Apply("", test_Ops, test_Out, sizeof(test_Out), 0), std::runtime_error);
+}
+
+TEST_F(DeltaTest, ApplyTargetMismatch)
+{
+    std::string test_Ops{Delta::OP_LITERAL};
+    Protocol::PutUInt32(test_Ops, 4);
+    test_Ops.append("text");
+    char test_Out[4];
+
+    // Verify behavior when the result does not match the target hash:
+    EXPECT_THROW(Delta::Apply("", test_Ops, test_Out, sizeof(test_Out), Delta::Hash("test")),
+                 std::runtime_error);
+    EXPECT_NO_THROW(Delta::Apply("", test_Ops, test_Out, sizeof(test_Out), Delta::Hash("text")));
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "error.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <windows.h>
+#include <winsock2.h>
+
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace ClipSock;
+using namespace testing;
+
+class ErrorCacheTest : public Test {
+protected:
+    static constexpr auto TEST_CAPACITY = 2;
+
+    ErrorCache<TEST_CAPACITY> test_Cache;
+};
+
+TEST_F(ErrorCacheTest, Find)
+{
+    // Verify behavior when a message is formatted on first use:
+    auto test_szMessage = test_Cache.Find(WSAECONNRESET);
+    ASSERT_NE(test_szMessage, nullptr);
+    std::string_view test_svMessage{test_szMessage};
+    EXPECT_FALSE(test_svMessage.empty());
+    EXPECT_FALSE(test_svMessage.ends_with('\n'));
+
+    // Verify behavior when a message is found in the cache:
+    EXPECT_EQ(test_Cache.Find(WSAECONNRESET), test_szMessage);
+}
+
+TEST_F(ErrorCacheTest, FindSuccess)
+{
+    // Verify behavior when ERROR_SUCCESS is looked up:
+    EXPECT_EQ(test_Cache.Find(ERROR_SUCCESS), nullptr);
+}
+
+TEST_F(ErrorCacheTest, FindFull)
+{
+    // Verify behavior when the cache is full:
+    auto test_szReset = test_Cache.Find(WSAECONNRESET);
+    auto test_szAborted = test_Cache.Find(WSAECONNABORTED);
+    ASSERT_NE(test_szReset, nullptr);
+    ASSERT_NE(test_szAborted, nullptr);
+    EXPECT_NE(test_szReset, test_szAborted);
+    EXPECT_EQ(test_Cache.Find(WSAENETDOWN), nullptr);
+
+    EXPECT_EQ(test_Cache.Find(WSAECONNRESET), test_szReset);
+    EXPECT_EQ(test_Cache.Find(WSAECONNABORTED), test_szAborted);
+}
+
+TEST_F(ErrorCacheTest, FindConcurrent)
+{
+    static constexpr auto TEST_THREADS = 4;
+    static constexpr auto TEST_ITERATIONS = 1000;
+
+    // Verify behavior when messages are looked up from several threads;
+    // each lookup returns the interned message or nullptr while it is
+    // being formatted:
+    std::vector<std::thread> test_Threads;
+    std::vector<PCSTR> test_Messages(TEST_THREADS);
+    for (auto i = 0; i < TEST_THREADS; i++) {
+        test_Threads.emplace_back([this, i, &test_Messages] {
+            for (auto j = 0; j < TEST_ITERATIONS; j++) {
+                if (auto szMessage = test_Cache.Find(WSAECONNRESET)) {
+                    test_Messages[i] = szMessage;
+                }
+            }
+        });
+    }
+    for (auto& Thread : test_Threads) {
+        Thread.join();
+    }
+
+    auto test_szMessage = test_Cache.Find(WSAECONNRESET);
+    ASSERT_NE(test_szMessage, nullptr);
+    EXPECT_THAT(test_Messages, Each(test_szMessage));
+}
+
+TEST_F(ErrorCacheTest, GetCachedErrorMessage)
+{
+    // Verify behavior when a message is not held in the cache:
+    auto test_szMessage = GetCachedErrorMessageA(ERROR_SUCCESS);
+    ASSERT_NE(test_szMessage, nullptr);
+    EXPECT_STRNE(test_szMessage, "");
+
+    // Verify behavior when a message is held in the cache:
+    EXPECT_EQ(GetCachedErrorMessageA(WSAECONNRESET), ErrorMessages.Find(WSAECONNRESET));
+}
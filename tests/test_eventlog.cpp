@@ -0,0 +1,207 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "mock_global.h"
+#include "mock_windows.h"
+
+#include "eventlog.h"
+#include "messages.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace ClipSock;
+using namespace testing;
+
+class EventLogTest : public Test {
+protected:
+    static constexpr auto TEST_CAPACITY = 4;
+
+    void SetUp() override
+    {
+        ON_CALL(mock_Windows, ReportEventA)
+            .WillByDefault(DoAll(WithArg<7>([this](LPCSTR* pStrings) {
+                                     test_Texts.emplace_back(pStrings[0]);
+                                 }),
+                                 Return(TRUE)));
+    }
+
+    static EventLog::Record MakeRecord(DWORD dwEventId, const std::string& sText)
+    {
+        EventLog::Record Entry{.wType = EVENTLOG_WARNING_TYPE, .wCategory = 0, .dwEventId = dwEventId, .bText = TRUE};
+        sText.copy(Entry.szText, ARRAYSIZE(Entry.szText) - 1);
+        return Entry;
+    }
+
+    GlobalMock<MockWindows> mock_Windows;
+    EventLog::Queue<TEST_CAPACITY> test_Queue;
+    EventLog::Writer test_Writer;
+    std::vector<std::string> test_Texts;
+};
+
+TEST_F(EventLogTest, QueueEmpty)
+{
+    EventLog::Record test_Entry;
+
+    // Verify behavior when the queue is empty:
+    EXPECT_FALSE(test_Queue.TryPop(test_Entry));
+}
+
+TEST_F(EventLogTest, QueueOrder)
+{
+    EventLog::Record test_Entry;
+
+    // Verify behavior when records are pushed and popped across the end of
+    // the queue:
+    for (DWORD i = 0; i < TEST_CAPACITY * 2; i++) {
+        ASSERT_TRUE(test_Queue.TryPush(MakeRecord(i, "Text")));
+        ASSERT_TRUE(test_Queue.TryPop(test_Entry));
+        EXPECT_EQ(test_Entry.dwEventId, i);
+    }
+    EXPECT_FALSE(test_Queue.TryPop(test_Entry));
+}
+
+TEST_F(EventLogTest, QueueFull)
+{
+    EventLog::Record test_Entry;
+
+    // Verify behavior when the queue is full:
+    for (DWORD i = 0; i < TEST_CAPACITY; i++) {
+        ASSERT_TRUE(test_Queue.TryPush(MakeRecord(i, "Text")));
+    }
+    EXPECT_FALSE(test_Queue.TryPush(MakeRecord(TEST_CAPACITY, "Text")));
+
+    ASSERT_TRUE(test_Queue.TryPop(test_Entry));
+    EXPECT_EQ(test_Entry.dwEventId, 0);
+    EXPECT_TRUE(test_Queue.TryPush(MakeRecord(TEST_CAPACITY, "Text")));
+}
+
+TEST_F(EventLogTest, Format)
+{
+    EventLog::Record test_Entry;
+    int test_nValue = 42;
+
+    // Verify behavior when a record is formatted:
+    EventLog::Format(test_Entry, "value {}", std::make_format_args(test_nValue));
+    EXPECT_STREQ(test_Entry.szText, "value 42");
+}
+
+TEST_F(EventLogTest, FormatTruncated)
+{
+    EventLog::Record test_Entry;
+    std::string test_sLong(EventLog::RECORD_LENGTH * 2, 'x');
+
+    // Verify behavior when formatted text does not fit in a record:
+    EventLog::Format(test_Entry, "{}", std::make_format_args(test_sLong));
+    EXPECT_EQ(std::string{test_Entry.szText}, test_sLong.substr(0, EventLog::RECORD_LENGTH - 1));
+}
+
+TEST_F(EventLogTest, Drain)
+{
+    EXPECT_CALL(mock_Windows, ReportEventA(_, EVENTLOG_WARNING_TYPE, 0, MSG_CONNECTION_FAILED,
+                                           _, 1, _, NotNull(), _))
+        .Times(2);
+
+    // Verify behavior when distinct records are drained:
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "First"));
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Second"));
+    test_Writer.Drain(0);
+    EXPECT_THAT(test_Texts, ElementsAre("First", "Second"));
+}
+
+TEST_F(EventLogTest, DrainRepeated)
+{
+    // Verify behavior when identical records are reported within the
+    // window:
+    for (auto i = 0; i < 3; i++) {
+        test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset"));
+    }
+    test_Writer.Drain(0);
+    EXPECT_THAT(test_Texts, ElementsAre("Reset"));
+
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset"));
+    test_Writer.Drain(EventLog::REPEAT_WINDOW - 1);
+    EXPECT_THAT(test_Texts, ElementsAre("Reset"));
+
+    // Verify behavior when the window closes:
+    test_Writer.Drain(EventLog::REPEAT_WINDOW);
+    EXPECT_THAT(test_Texts, ElementsAre("Reset", "Reset (repeated 3 times)"));
+
+    test_Writer.Drain(EventLog::REPEAT_WINDOW * 2);
+    EXPECT_THAT(test_Texts, SizeIs(2));
+}
+
+TEST_F(EventLogTest, DrainRepeatedInterrupted)
+{
+    // Verify behavior when repeats are interrupted by a different record:
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset"));
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset"));
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_TIMED_OUT, "Reset"));
+    test_Writer.Drain(0);
+    EXPECT_THAT(test_Texts, ElementsAre("Reset", "Reset (repeated 1 times)", "Reset"));
+}
+
+TEST_F(EventLogTest, DrainDropped)
+{
+    EXPECT_CALL(mock_Windows, ReportEventA(_, _, _, MSG_CONNECTION_FAILED, _, _, _, _, _))
+        .Times(1);
+    EXPECT_CALL(mock_Windows, ReportEventA(_, EVENTLOG_WARNING_TYPE, _, MSG_EVENTS_DROPPED, _, _, _, _, _));
+
+    // Verify behavior when records are dropped while the queue is full:
+    for (auto i = 0; i < EventLog::QUEUE_CAPACITY; i++) {
+        ASSERT_TRUE(test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset")));
+    }
+    EXPECT_FALSE(test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset")));
+    test_Writer.Drain(0);
+    EXPECT_EQ(test_Texts.back(), "1 records dropped; queue full");
+}
+
+TEST_F(EventLogTest, PushStopped)
+{
+    EXPECT_CALL(mock_Windows, ReportEventA(_, EVENTLOG_WARNING_TYPE, 0, MSG_CONNECTION_FAILED,
+                                           _, 1, _, NotNull(), _));
+
+    // Verify behavior when a record is pushed after the writer has stopped:
+    test_Writer.Start();
+    test_Writer.Stop();
+    EXPECT_TRUE(test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Late")));
+    EXPECT_THAT(test_Texts, ElementsAre("Late"));
+}
+
+TEST_F(EventLogTest, Flush)
+{
+    // Verify behavior when outstanding repeats are flushed:
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset"));
+    test_Writer.Push(MakeRecord(MSG_CONNECTION_FAILED, "Reset"));
+    test_Writer.Drain(0);
+    test_Writer.Flush();
+    EXPECT_THAT(test_Texts, ElementsAre("Reset", "Reset (repeated 1 times)"));
+
+    test_Writer.Flush();
+    EXPECT_THAT(test_Texts, SizeIs(2));
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "histogram.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ClipSock;
+using namespace testing;
+
+class SizeHistogramTest : public Test {
+protected:
+    static constexpr auto TEST_WINDOW = 100;
+
+    SizeHistogram test_Histogram{TEST_WINDOW};
+};
+
+TEST_F(SizeHistogramTest, Empty)
+{
+    // Verify behavior when no sizes have been counted:
+    EXPECT_EQ(test_Histogram.Count(), 0);
+    EXPECT_EQ(test_Histogram.GetPercentile(90), 0);
+}
+
+TEST_F(SizeHistogramTest, Classes)
+{
+    // Verify behavior when sizes are counted by power of two:
+    test_Histogram.Add(0);
+    test_Histogram.Add(1);
+    test_Histogram.Add(1023);
+    test_Histogram.Add(1024);
+    test_Histogram.Add(1024 * 1024);
+    EXPECT_EQ(test_Histogram.Count(), 5);
+    EXPECT_EQ(test_Histogram.Counts()[0], 1);
+    EXPECT_EQ(test_Histogram.Counts()[1], 1);
+    EXPECT_EQ(test_Histogram.Counts()[10], 1);
+    EXPECT_EQ(test_Histogram.Counts()[11], 1);
+    EXPECT_EQ(test_Histogram.Counts()[SizeHistogram::CLASSES - 1], 1);
+}
+
+TEST_F(SizeHistogramTest, Percentile)
+{
+    // Verify behavior when selecting the class covering a percentile:
+    for (auto i = 0; i < 9; i++) {
+        test_Histogram.Add(1000);
+    }
+    test_Histogram.Add(50000);
+    EXPECT_EQ(test_Histogram.GetPercentile(50), 1024);
+    EXPECT_EQ(test_Histogram.GetPercentile(90), 1024);
+    EXPECT_EQ(test_Histogram.GetPercentile(91), 65536);
+    EXPECT_EQ(test_Histogram.GetPercentile(100), 65536);
+}
+
+TEST_F(SizeHistogramTest, Window)
+{
+    // Verify behavior when counts are halved at the window:
+    for (auto i = 0; i < TEST_WINDOW - 1; i++) {
+        test_Histogram.Add(100);
+    }
+    EXPECT_EQ(test_Histogram.Count(), TEST_WINDOW - 1);
+
+    test_Histogram.Add(100);
+    EXPECT_EQ(test_Histogram.Count(), TEST_WINDOW / 2);
+    EXPECT_EQ(test_Histogram.Counts()[7], TEST_WINDOW / 2);
+}
+
+TEST_F(SizeHistogramTest, Load)
+{
+    SizeHistogram::CountArray test_Counts{};
+    test_Counts[4] = 3;
+    test_Counts[12] = 7;
+
+    // Verify behavior when counts are loaded and cleared:
+    test_Histogram.Load(test_Counts);
+    EXPECT_EQ(test_Histogram.Count(), 10);
+    EXPECT_EQ(test_Histogram.GetPercentile(30), 16);
+    EXPECT_EQ(test_Histogram.GetPercentile(31), 4096);
+
+    test_Histogram.Clear();
+    EXPECT_EQ(test_Histogram.Count(), 0);
+    EXPECT_THAT(test_Histogram.Counts(), Each(0));
+}
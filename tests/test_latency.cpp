@@ -0,0 +1,107 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "latency.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ClipSock;
+using namespace testing;
+
+class LatencyHistogramTest : public Test {
+protected:
+    LatencyHistogram test_Histogram;
+};
+
+TEST_F(LatencyHistogramTest, Empty)
+{
+    // Verify behavior when no values have been recorded:
+    EXPECT_EQ(test_Histogram.Count(), 0);
+    EXPECT_EQ(test_Histogram.GetPercentile(50), 0);
+}
+
+TEST_F(LatencyHistogramTest, Exact)
+{
+    // Verify behavior when values fit within the first sub-buckets:
+    for (ULONGLONG i = 0; i < LatencyHistogram::SUB_BUCKETS; i++) {
+        EXPECT_EQ(LatencyHistogram::GetIndex(i), i);
+        EXPECT_EQ(LatencyHistogram::GetUpperBound(LatencyHistogram::GetIndex(i)), i);
+    }
+}
+
+TEST_F(LatencyHistogramTest, Bounds)
+{
+    // Verify behavior when values are bucketed with bounded relative error:
+    for (ULONGLONG ullValue = 1; ullValue < (1ULL << LatencyHistogram::MAXIMUM_BITS); ullValue = ullValue * 3 + 1) {
+        auto nIndex = LatencyHistogram::GetIndex(ullValue);
+        auto ullBound = LatencyHistogram::GetUpperBound(nIndex);
+        EXPECT_LT(nIndex, LatencyHistogram::BUCKETS);
+        EXPECT_GE(ullBound, ullValue);
+        EXPECT_LE(ullBound - ullValue, ullValue / (LatencyHistogram::SUB_BUCKETS / 2));
+        if (nIndex > 0) {
+            EXPECT_LT(LatencyHistogram::GetUpperBound(nIndex - 1), ullValue);
+        }
+    }
+}
+
+TEST_F(LatencyHistogramTest, Overflow)
+{
+    // Verify behavior when values exceed the range:
+    EXPECT_EQ(LatencyHistogram::GetIndex(1ULL << LatencyHistogram::MAXIMUM_BITS),
+              LatencyHistogram::BUCKETS - 1);
+    EXPECT_EQ(LatencyHistogram::GetIndex(~0ULL), LatencyHistogram::BUCKETS - 1);
+}
+
+TEST_F(LatencyHistogramTest, Percentile)
+{
+    // Verify behavior when selecting percentiles:
+    for (ULONGLONG i = 1; i <= 100; i++) {
+        test_Histogram.Record(i * 1000);
+    }
+    EXPECT_EQ(test_Histogram.Count(), 100);
+    EXPECT_THAT(test_Histogram.GetPercentile(50), AllOf(Ge(50000), Le(50000 + 50000 / 16)));
+    EXPECT_THAT(test_Histogram.GetPercentile(99), AllOf(Ge(99000), Le(99000 + 99000 / 16)));
+    EXPECT_THAT(test_Histogram.GetPercentile(100), AllOf(Ge(100000), Le(100000 + 100000 / 16)));
+
+    test_Histogram.Clear();
+    EXPECT_EQ(test_Histogram.Count(), 0);
+    EXPECT_EQ(test_Histogram.GetPercentile(50), 0);
+}
+
+TEST(LatencyTest, ElapsedMicroseconds)
+{
+    LARGE_INTEGER test_Frequency;
+    QueryPerformanceFrequency(&test_Frequency);
+
+    // Verify behavior when converting elapsed timestamps:
+    EXPECT_EQ(GetElapsedMicroseconds(0, test_Frequency.QuadPart), 1000000);
+    EXPECT_EQ(GetElapsedMicroseconds(0, test_Frequency.QuadPart * 86400), 86400ULL * 1000000);
+    EXPECT_EQ(GetElapsedMicroseconds(test_Frequency.QuadPart, 0), 0);
+
+    auto test_llStart = GetTimestamp();
+    auto test_llEnd = GetTimestamp();
+    EXPECT_LE(test_llStart, test_llEnd);
+}
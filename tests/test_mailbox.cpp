@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "mailbox.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace ClipSock;
+using namespace testing;
+
+struct TestValue {
+    ULONGLONG ullFirst;
+    ULONGLONG ullSecond;
+};
+
+class MailboxTest : public Test {
+protected:
+    Mailbox<TestValue> test_Mailbox;
+};
+
+TEST_F(MailboxTest, Empty)
+{
+    // Verify behavior when no value has been written:
+    auto test_Value = test_Mailbox.Read();
+    EXPECT_EQ(test_Value.ullFirst, 0);
+    EXPECT_EQ(test_Value.ullSecond, 0);
+}
+
+TEST_F(MailboxTest, Update)
+{
+    // Verify behavior when the value is changed:
+    EXPECT_TRUE(test_Mailbox.Update([](TestValue& Value) {
+        Value.ullFirst = 1;
+        return TRUE;
+    }));
+    EXPECT_EQ(test_Mailbox.Read().ullFirst, 1);
+}
+
+TEST_F(MailboxTest, Unchanged)
+{
+    // Verify behavior when the update reports no change:
+    EXPECT_FALSE(test_Mailbox.Update([](TestValue&) {
+        return FALSE;
+    }));
+    EXPECT_EQ(test_Mailbox.Read().ullFirst, 0);
+}
+
+TEST_F(MailboxTest, Concurrent)
+{
+    // Verify behavior when several threads write while another reads; the
+    // reader must never observe a partially written value:
+    constexpr auto THREADS = 4;
+    constexpr auto UPDATES = 10000;
+
+    std::vector<std::thread> test_Threads;
+    for (auto i = 0; i < THREADS; i++) {
+        test_Threads.emplace_back([this] {
+            for (auto j = 0; j < UPDATES; j++) {
+                test_Mailbox.Update([](TestValue& Value) {
+                    Value.ullFirst++;
+                    Value.ullSecond++;
+                    return TRUE;
+                });
+            }
+        });
+    }
+    for (auto i = 0; i < UPDATES; i++) {
+        auto test_Value = test_Mailbox.Read();
+        EXPECT_EQ(test_Value.ullFirst, test_Value.ullSecond);
+    }
+    for (auto& test_Thread : test_Threads) {
+        test_Thread.join();
+    }
+    EXPECT_EQ(test_Mailbox.Read().ullFirst, THREADS * UPDATES);
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "mock_global.h"
+#include "mock_windows.h"
+
+#include "memory.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace ClipSock;
+using namespace testing;
+
+class MemoryMonitorTest : public Test {
+protected:
+    GlobalMock<MockWindows> mock_Windows;
+
+    void SetUpMonitor()
+    {
+        ON_CALL(mock_Windows, CreateMemoryResourceNotification(LowMemoryResourceNotification))
+            .WillByDefault(Return(mock_hLowMemory));
+        ON_CALL(mock_Windows, CreateMemoryResourceNotification(HighMemoryResourceNotification))
+            .WillByDefault(Return(mock_hHighMemory));
+        test_Monitor.Open();
+    }
+
+    // Notifications are closed by the monitor, so real handles are used in
+    // place of unique values:
+    HANDLE mock_hLowMemory{CreateEvent(nullptr, TRUE, FALSE, nullptr)};
+    HANDLE mock_hHighMemory{CreateEvent(nullptr, TRUE, FALSE, nullptr)};
+    MemoryMonitor test_Monitor;
+};
+
+TEST_F(MemoryMonitorTest, Open)
+{
+    // Verify behavior when the monitor is opened:
+    SetUpMonitor();
+    EXPECT_TRUE(test_Monitor.IsOpen());
+    EXPECT_EQ(test_Monitor.GetCondition(), MemoryMonitor::Condition::Normal);
+    EXPECT_EQ(test_Monitor.GetHandle(), mock_hLowMemory);
+}
+
+TEST_F(MemoryMonitorTest, OpenFails)
+{
+    EXPECT_CALL(mock_Windows, CreateMemoryResourceNotification(LowMemoryResourceNotification))
+        .WillOnce(Return(mock_hLowMemory));
+    EXPECT_CALL(mock_Windows, CreateMemoryResourceNotification(HighMemoryResourceNotification))
+        .WillOnce(Return(nullptr));
+
+    // Verify behavior when a notification cannot be created:
+    EXPECT_THROW(test_Monitor.Open(), std::runtime_error);
+    EXPECT_FALSE(test_Monitor.IsOpen());
+    CloseHandle(mock_hHighMemory);
+}
+
+TEST_F(MemoryMonitorTest, Transitions)
+{
+    SetUpMonitor();
+
+    EXPECT_CALL(mock_Windows, QueryMemoryResourceNotification(mock_hLowMemory, NotNull()))
+        .WillOnce(DoAll(SetArgPointee<1>(FALSE), Return(TRUE)))
+        .WillOnce(DoAll(SetArgPointee<1>(TRUE), Return(TRUE)));
+    EXPECT_CALL(mock_Windows, QueryMemoryResourceNotification(mock_hHighMemory, NotNull()))
+        .WillOnce(DoAll(SetArgPointee<1>(TRUE), Return(TRUE)));
+
+    // Verify behavior when memory becomes low and then high again:
+    EXPECT_FALSE(test_Monitor.Update());
+    EXPECT_TRUE(test_Monitor.Update());
+    EXPECT_EQ(test_Monitor.GetCondition(), MemoryMonitor::Condition::Low);
+    EXPECT_EQ(test_Monitor.GetHandle(), mock_hHighMemory);
+
+    EXPECT_TRUE(test_Monitor.Update());
+    EXPECT_EQ(test_Monitor.GetCondition(), MemoryMonitor::Condition::Normal);
+    EXPECT_EQ(test_Monitor.GetHandle(), mock_hLowMemory);
+}
+
+TEST_F(MemoryMonitorTest, QueryFails)
+{
+    SetUpMonitor();
+
+    EXPECT_CALL(mock_Windows, QueryMemoryResourceNotification)
+        .WillOnce(Return(FALSE));
+
+    // Verify behavior when the notification cannot be queried:
+    EXPECT_THROW(test_Monitor.Update(), std::runtime_error);
+    EXPECT_EQ(test_Monitor.GetCondition(), MemoryMonitor::Condition::Normal);
+}
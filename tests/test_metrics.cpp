@@ -0,0 +1,127 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "mock_global.h"
+#include "mock_windows.h"
+
+#include "metrics.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace ClipSock;
+using namespace testing;
+
+class MetricsTest : public Test {
+protected:
+    GlobalMock<MockWindows> mock_Windows;
+
+    void SetUpMapping()
+    {
+        ON_CALL(mock_Windows, CreateFileMappingW(INVALID_HANDLE_VALUE, _, PAGE_READWRITE,
+                                                 0, sizeof(Metrics::Layout), _))
+            .WillByDefault(Return(mock_hMapping));
+        ON_CALL(mock_Windows, MapViewOfFile(mock_hMapping, FILE_MAP_WRITE, 0, 0, sizeof(Metrics::Layout)))
+            .WillByDefault(Return(&mock_View));
+    }
+
+    void TearDown() override
+    {
+        Metrics::Close();
+    }
+
+    // The mapping is closed by Metrics::Close, so a real handle is used in
+    // place of a unique value:
+    HANDLE mock_hMapping{CreateEvent(nullptr, TRUE, FALSE, nullptr)};
+    Metrics::Layout mock_View;
+};
+
+TEST_F(MetricsTest, Local)
+{
+    auto test_Accepted = Metrics::Get(Metrics::Metric::ConnectionsAccepted);
+
+    // Verify behavior when metrics are recorded before the mapping is opened:
+    EXPECT_FALSE(Metrics::IsOpen());
+    Metrics::Add(Metrics::Metric::ConnectionsAccepted);
+    Metrics::Add(Metrics::Metric::ConnectionsAccepted, 2);
+    Metrics::Set(Metrics::Metric::ConnectionsActive, 5);
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::ConnectionsAccepted), test_Accepted + 3);
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::ConnectionsActive), 5);
+}
+
+TEST_F(MetricsTest, Open)
+{
+    SetUpMapping();
+    Metrics::Set(Metrics::Metric::MemoryReserved, 1024);
+
+    // Verify behavior when the mapping is opened:
+    Metrics::Open();
+    EXPECT_TRUE(Metrics::IsOpen());
+    EXPECT_EQ(mock_View.dwVersion, Metrics::LAYOUT_VERSION);
+    EXPECT_EQ(mock_View.cMetrics, Metrics::METRIC_COUNT);
+    EXPECT_EQ(mock_View.dwProcessId, GetCurrentProcessId());
+
+    auto& test_Slot = mock_View.Slots[static_cast<SIZE_T>(Metrics::Metric::MemoryReserved)];
+    EXPECT_EQ(test_Slot.llValue, 1024);
+
+    Metrics::Set(Metrics::Metric::MemoryReserved, 2048);
+    EXPECT_EQ(test_Slot.llValue, 2048);
+}
+
+TEST_F(MetricsTest, Close)
+{
+    SetUpMapping();
+    Metrics::Open();
+    Metrics::Set(Metrics::Metric::ParkedBytes, 4096);
+
+    EXPECT_CALL(mock_Windows, UnmapViewOfFile(&mock_View));
+
+    // Verify behavior when the mapping is closed:
+    Metrics::Close();
+    EXPECT_FALSE(Metrics::IsOpen());
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::ParkedBytes), 4096);
+}
+
+TEST_F(MetricsTest, OpenFails)
+{
+    EXPECT_CALL(mock_Windows, CreateFileMappingW).WillOnce(Return(nullptr));
+
+    // Verify behavior when the mapping cannot be created:
+    EXPECT_THROW(Metrics::Open(), std::runtime_error);
+    EXPECT_FALSE(Metrics::IsOpen());
+    CloseHandle(mock_hMapping);
+}
+
+TEST_F(MetricsTest, MapFails)
+{
+    EXPECT_CALL(mock_Windows, CreateFileMappingW).WillOnce(Return(mock_hMapping));
+    EXPECT_CALL(mock_Windows, MapViewOfFile).WillOnce(Return(nullptr));
+
+    // Verify behavior when the mapping cannot be mapped:
+    EXPECT_THROW(Metrics::Open(), std::runtime_error);
+    EXPECT_FALSE(Metrics::IsOpen());
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "base64.h"
+#include "osc52.h"
+#include "protocol.h"
+#include "simd.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace ClipSock;
+using namespace testing;
+
+class Osc52Test : public Test {
+protected:
+    static constexpr auto TEST_TEXT_SIZE = 1000;
+
+    std::string MakeText()
+    {
+        std::string sText;
+        for (auto i = 0; i < TEST_TEXT_SIZE; i++) {
+            sText.push_back(static_cast<char>(i * 7 + i / 13));
+        }
+        return sText;
+    }
+
+    std::string Encode(std::string_view svText)
+    {
+        constexpr auto szAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::string sEncoded;
+        for (size_t i = 0; i < svText.size(); i += 3) {
+            auto cbQuantum = std::min<size_t>(3, svText.size() - i);
+            unsigned uValue = 0;
+            for (size_t j = 0; j < 3; j++) {
+                uValue = uValue << 8 | (j < cbQuantum ? static_cast<unsigned char>(svText[i + j]) : 0);
+            }
+            for (size_t j = 0; j < 4; j++) {
+                sEncoded.push_back(j <= cbQuantum ? szAlphabet[(uValue >> (18 - 6 * j)) & 0x3F] : '=');
+            }
+        }
+        return sEncoded;
+    }
+
+    // Decode simulates a receive buffer, decoding each chunk in place
+    // immediately following previously decoded data:
+    std::string Decode(std::string_view svSequence, size_t cbChunk)
+    {
+        Osc52::Decoder Decoder;
+        std::string sBuffer(svSequence.size(), '\0');
+        size_t cbDecoded = 0;
+        for (size_t i = 0; i < svSequence.size(); i += cbChunk) {
+            auto svChunk = svSequence.substr(i, cbChunk);
+            svChunk.copy(sBuffer.data() + cbDecoded, svChunk.size());
+            cbDecoded += Decoder.Decode(sBuffer.data() + cbDecoded, svChunk.size());
+        }
+        return sBuffer.substr(0, cbDecoded);
+    }
+
+    std::string test_text = MakeText();
+    std::string test_sequence = "\x1B]52;c;" + Encode(test_text) + "\x07";
+};
+
+TEST_F(Osc52Test, Classify)
+{
+    // Verify behavior when classifying partial and complete prefixes:
+    EXPECT_EQ(Protocol::Classify("\x1B"), Protocol::Mode::Unknown);
+    EXPECT_EQ(Protocol::Classify("\x1B]5"), Protocol::Mode::Unknown);
+    EXPECT_EQ(Protocol::Classify("\x1B]52;"), Protocol::Mode::Osc52);
+    EXPECT_EQ(Protocol::Classify("\x1B[0m"), Protocol::Mode::Raw);
+}
+
+TEST_F(Osc52Test, DecodeQuartets)
+{
+    // Verify behavior when decoding complete quartets with each kernel:
+    auto test_encoded = Encode(test_text.substr(0, 999));
+    std::string expect_text(test_encoded.size(), '\0');
+    auto cbExpected = Base64::DecodeQuartetsScalar(test_encoded.data(), test_encoded.size(),
+                                                   expect_text.data());
+    EXPECT_EQ(cbExpected, test_encoded.size());
+    EXPECT_EQ(expect_text.substr(0, 999), test_text.substr(0, 999));
+
+    if (Simd::HasSSSE3()) {
+        std::string test_buffer = test_encoded;
+        auto cbConsumed = Base64::DecodeQuartetsSSSE3(test_buffer.data(), test_buffer.size(),
+                                                      test_buffer.data());
+        EXPECT_EQ(cbConsumed, test_encoded.size() / 16 * 16);
+        EXPECT_EQ(test_buffer.substr(0, cbConsumed / 4 * 3), test_text.substr(0, cbConsumed / 4 * 3));
+    }
+}
+
+TEST_F(Osc52Test, DecodeQuartetsSeparate)
+{
+    // Verify behavior when decoding into a separate buffer sized for the
+    // decoded data only:
+    auto test_encoded = Encode(test_text.substr(0, 36));
+    std::string test_buffer(36 + 4, '!');
+    if (Simd::HasSSSE3()) {
+        EXPECT_EQ(Base64::DecodeQuartetsSSSE3(test_encoded.data(), 48, test_buffer.data()), 48);
+        EXPECT_EQ(test_buffer.substr(0, 36), test_text.substr(0, 36));
+        EXPECT_EQ(test_buffer.substr(36), "!!!!");
+    }
+}
+
+TEST_F(Osc52Test, DecodeQuartetsInvalid)
+{
+    // Verify behavior when decoding stops at padding and invalid characters:
+    std::string test_buffer = "QUJDREVGR0hJSktMTU5PUFFSU1RVVldY" "QQ==";
+    EXPECT_EQ(Base64::DecodeQuartets(test_buffer.data(), test_buffer.size(), test_buffer.data()), 32);
+
+    test_buffer = "QUJDREVGR0hJSktM\x07NOPQRSTUVWXYZ";
+    EXPECT_EQ(Base64::DecodeQuartets(test_buffer.data(), test_buffer.size(), test_buffer.data()), 16);
+}
+
+TEST_F(Osc52Test, Decode)
+{
+    // Verify behavior when decoding a complete sequence at once:
+    Osc52::Decoder Decoder;
+    std::string test_buffer = test_sequence;
+    auto cbDecoded = Decoder.Decode(test_buffer.data(), test_buffer.size());
+    EXPECT_EQ(test_buffer.substr(0, cbDecoded), test_text);
+    EXPECT_TRUE(Decoder.IsComplete());
+}
+
+TEST_F(Osc52Test, DecodeChunked)
+{
+    // Verify behavior when decoding a sequence received in arbitrary chunks:
+    for (auto cbChunk : {1, 2, 3, 5, 17, 64}) {
+        EXPECT_EQ(Decode(test_sequence, cbChunk), test_text) << "cbChunk = " << cbChunk;
+    }
+}
+
+TEST_F(Osc52Test, DecodeTerminators)
+{
+    // Verify behavior when decoding sequences terminated by ST and padding:
+    EXPECT_EQ(Decode("\x1B]52;;aGVsbG8=\x1B\\", 4), "hello");
+    EXPECT_EQ(Decode("\x1B]52;p;aGk\x07trailing", 4), "hi");
+    EXPECT_EQ(Decode("\x1B]52;c;\x07", 4), "");
+}
+
+TEST_F(Osc52Test, DecodeInvalid)
+{
+    // Verify behavior when decoding invalid sequences:
+    Osc52::Decoder Decoder;
+    std::string test_buffer = "\x1B]52;c;aGVs*G8=\x07";
+    EXPECT_THROW(Decoder.Decode(test_buffer.data(), test_buffer.size()), std::runtime_error);
+}
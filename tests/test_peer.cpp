@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "peer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace ClipSock::Peer;
+using namespace testing;
+
+class PeerTest : public Test {
+protected:
+    static constexpr BYTE TEST_IPV4[]{192, 0, 2, 1};
+    static constexpr BYTE TEST_IPV6[]{0x20, 0x01, 0x0D, 0xB8, 0, 0, 0, 0,
+                                      0, 0, 0, 0, 0, 0, 0, 1};
+};
+
+TEST_F(PeerTest, AddressIPv4)
+{
+    SOCKADDR_STORAGE test_Storage{};
+    auto& test_Address = reinterpret_cast<SOCKADDR_IN&>(test_Storage);
+    test_Address.sin_family = AF_INET;
+    std::memcpy(&test_Address.sin_addr, TEST_IPV4, sizeof(TEST_IPV4));
+
+    // Verify behavior when normalizing an IPv4 address:
+    EXPECT_THAT(GetAddress(test_Storage),
+                ElementsAre(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 192, 0, 2, 1));
+}
+
+TEST_F(PeerTest, AddressIPv6)
+{
+    SOCKADDR_STORAGE test_Storage{};
+    auto& test_Address = reinterpret_cast<SOCKADDR_IN6&>(test_Storage);
+    test_Address.sin6_family = AF_INET6;
+    std::memcpy(&test_Address.sin6_addr, TEST_IPV6, sizeof(TEST_IPV6));
+
+    // Verify behavior when normalizing an IPv6 address:
+    EXPECT_THAT(GetAddress(test_Storage), ElementsAreArray(TEST_IPV6));
+}
+
+TEST_F(PeerTest, AddressHash)
+{
+    SOCKADDR_STORAGE test_Storage{};
+    test_Storage.ss_family = AF_INET;
+    auto test_Address1 = GetAddress(test_Storage);
+    auto test_Address2 = test_Address1;
+    test_Address2.back() = 1;
+
+    // Verify behavior when hashing equal and distinct addresses:
+    AddressHash test_Hash;
+    EXPECT_EQ(test_Hash(test_Address1), test_Hash(GetAddress(test_Storage)));
+    EXPECT_NE(test_Hash(test_Address1), test_Hash(test_Address2));
+}
+
+TEST_F(PeerTest, Loopback)
+{
+    SOCKADDR_STORAGE test_Storage{};
+    auto& test_Address = reinterpret_cast<SOCKADDR_IN&>(test_Storage);
+    test_Address.sin_family = AF_INET;
+    std::memcpy(&test_Address.sin_addr, TEST_IPV4, sizeof(TEST_IPV4));
+
+    // Verify behavior when checking loopback and other addresses:
+    EXPECT_FALSE(IsLoopback(GetAddress(test_Storage)));
+    EXPECT_TRUE(IsLoopback(ParsePrefix(L"127.0.0.1").PrefixAddress));
+    EXPECT_TRUE(IsLoopback(ParsePrefix(L"127.1.2.3").PrefixAddress));
+    EXPECT_TRUE(IsLoopback(ParsePrefix(L"::1").PrefixAddress));
+    EXPECT_FALSE(IsLoopback(ParsePrefix(L"::").PrefixAddress));
+    EXPECT_FALSE(IsLoopback(ParsePrefix(L"2001:db8::1").PrefixAddress));
+}
+
+TEST_F(PeerTest, PrefixIPv4)
+{
+    // Verify behavior when parsing an IPv4 prefix:
+    auto test_Prefix = ParsePrefix(L"192.0.2.1/24");
+    EXPECT_THAT(test_Prefix.PrefixAddress,
+                ElementsAre(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 192, 0, 2, 1));
+    EXPECT_EQ(test_Prefix.cBits, 96 + 24);
+}
+
+TEST_F(PeerTest, PrefixIPv6)
+{
+    // Verify behavior when parsing an IPv6 prefix:
+    auto test_Prefix = ParsePrefix(L"2001:db8::1/32");
+    EXPECT_THAT(test_Prefix.PrefixAddress, ElementsAreArray(TEST_IPV6));
+    EXPECT_EQ(test_Prefix.cBits, 32);
+}
+
+TEST_F(PeerTest, PrefixHost)
+{
+    // Verify behavior when parsing an address without a prefix length:
+    EXPECT_EQ(ParsePrefix(L"192.0.2.1").cBits, 128);
+    EXPECT_EQ(ParsePrefix(L"2001:db8::1").cBits, 128);
+}
+
+TEST_F(PeerTest, PrefixInvalid)
+{
+    // Verify behavior when parsing invalid prefixes:
+    EXPECT_THROW(ParsePrefix(L"192.0.2"), std::runtime_error);
+    EXPECT_THROW(ParsePrefix(L"192.0.2.1/"), std::runtime_error);
+    EXPECT_THROW(ParsePrefix(L"192.0.2.1/33"), std::runtime_error);
+    EXPECT_THROW(ParsePrefix(L"2001:db8::1/129"), std::runtime_error);
+    EXPECT_THROW(ParsePrefix(L"2001:db8::1/-1"), std::runtime_error);
+}
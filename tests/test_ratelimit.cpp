@@ -0,0 +1,80 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "ratelimit.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ClipSock;
+using namespace testing;
+
+class TokenBucketTest : public Test {
+protected:
+    static constexpr auto TEST_RATE = 10;
+    static constexpr auto TEST_CAPACITY = 20;
+    static constexpr auto TEST_START = 1'000'000'000ull;
+
+    TokenBucket test_Bucket{TEST_RATE, TEST_CAPACITY};
+};
+
+TEST_F(TokenBucketTest, Burst)
+{
+    // Verify behavior when consuming a full burst:
+    for (auto i = 0; i < TEST_CAPACITY; ++i) {
+        EXPECT_TRUE(test_Bucket.TryConsume(1, TEST_START));
+    }
+    EXPECT_FALSE(test_Bucket.TryConsume(1, TEST_START));
+    EXPECT_FALSE(test_Bucket.IsFull(TEST_START));
+}
+
+TEST_F(TokenBucketTest, Refill)
+{
+    // Verify behavior when tokens are replenished over time:
+    EXPECT_TRUE(test_Bucket.TryConsume(TEST_CAPACITY, TEST_START));
+    EXPECT_FALSE(test_Bucket.TryConsume(1, TEST_START + 99));
+    EXPECT_TRUE(test_Bucket.TryConsume(1, TEST_START + 100));
+    EXPECT_FALSE(test_Bucket.TryConsume(1, TEST_START + 100));
+    EXPECT_TRUE(test_Bucket.IsFull(TEST_START + 100 + 2000));
+}
+
+TEST_F(TokenBucketTest, Overdraw)
+{
+    // Verify behavior when the bucket is overdrawn:
+    test_Bucket.Consume(TEST_CAPACITY + TEST_RATE, TEST_START);
+    EXPECT_EQ(test_Bucket.GetDelay(TEST_START), 1000);
+    EXPECT_EQ(test_Bucket.GetDelay(TEST_START + 950), 50);
+    EXPECT_FALSE(test_Bucket.TryConsume(1, TEST_START + 1000));
+    EXPECT_EQ(test_Bucket.GetDelay(TEST_START + 1000), 0);
+    EXPECT_TRUE(test_Bucket.TryConsume(1, TEST_START + 1100));
+}
+
+TEST_F(TokenBucketTest, TimeReversed)
+{
+    // Verify behavior when time does not advance monotonically:
+    EXPECT_TRUE(test_Bucket.TryConsume(TEST_CAPACITY, TEST_START));
+    EXPECT_FALSE(test_Bucket.TryConsume(1, TEST_START - 1000));
+    EXPECT_TRUE(test_Bucket.TryConsume(1, TEST_START + 100));
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "registry.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <windows.h>
+
+using namespace ClipSock;
+using namespace testing;
+
+class RegistryMonitorTest : public Test {
+protected:
+    static constexpr auto TEST_SUBKEY = L"Software\\ClipSock-Tests";
+    static constexpr auto TEST_TIMEOUT = 5 * 1000; // milliseconds
+
+    void SetUp() override
+    {
+        ASSERT_EQ(RegCreateKeyEx(HKEY_CURRENT_USER, TEST_SUBKEY, 0, nullptr,
+                                 REG_OPTION_VOLATILE, KEY_WRITE, nullptr,
+                                 &test_hKey, nullptr), ERROR_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        test_Monitor.Close();
+        RegCloseKey(test_hKey);
+        RegDeleteKey(HKEY_CURRENT_USER, TEST_SUBKEY);
+    }
+
+    void SetValue(DWORD dwValue)
+    {
+        ASSERT_EQ(RegSetValueEx(test_hKey, L"Value", 0, REG_DWORD,
+                                reinterpret_cast<PBYTE>(&dwValue),
+                                sizeof(dwValue)), ERROR_SUCCESS);
+    }
+
+    HKEY test_hKey{nullptr};
+    RegistryMonitor test_Monitor;
+};
+
+TEST_F(RegistryMonitorTest, Open)
+{
+    // Verify behavior when the monitor is opened:
+    ASSERT_TRUE(test_Monitor.Open(HKEY_CURRENT_USER, TEST_SUBKEY));
+    EXPECT_TRUE(test_Monitor.IsOpen());
+    EXPECT_EQ(WaitForSingleObject(test_Monitor.GetHandle(), 0), WAIT_TIMEOUT);
+}
+
+TEST_F(RegistryMonitorTest, OpenMissing)
+{
+    // Verify behavior when the key does not exist:
+    EXPECT_FALSE(test_Monitor.Open(HKEY_CURRENT_USER, L"Software\\ClipSock-Tests\\Missing"));
+    EXPECT_FALSE(test_Monitor.IsOpen());
+}
+
+TEST_F(RegistryMonitorTest, Update)
+{
+    ASSERT_TRUE(test_Monitor.Open(HKEY_CURRENT_USER, TEST_SUBKEY));
+
+    // Verify behavior when a value is changed:
+    SetValue(1);
+    EXPECT_EQ(WaitForSingleObject(test_Monitor.GetHandle(), TEST_TIMEOUT), WAIT_OBJECT_0);
+
+    // Verify behavior when the notification is rearmed:
+    test_Monitor.Update();
+    EXPECT_EQ(WaitForSingleObject(test_Monitor.GetHandle(), 0), WAIT_TIMEOUT);
+    SetValue(2);
+    EXPECT_EQ(WaitForSingleObject(test_Monitor.GetHandle(), TEST_TIMEOUT), WAIT_OBJECT_0);
+}
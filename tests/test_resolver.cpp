@@ -0,0 +1,136 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "resolver.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#include <stdexcept>
+
+using namespace ClipSock;
+using namespace testing;
+
+class ResolverTest : public Test {
+protected:
+    static constexpr auto TEST_TIMEOUT = 5 * 1000; // milliseconds
+
+    void SetUp() override
+    {
+        WSADATA wsaData;
+        ASSERT_EQ(WSAStartup(MAKEWORD(2, 2), &wsaData), 0);
+    }
+
+    void TearDown() override
+    {
+        test_Resolver.Cancel();
+        WSACleanup();
+    }
+
+    Resolver test_Resolver;
+};
+
+TEST_F(ResolverTest, BeginIPv4)
+{
+    // Verify behavior when resolving a numeric IPv4 address:
+    auto test_Addresses = test_Resolver.Begin(L"127.0.0.1:5494", TEST_TIMEOUT);
+    EXPECT_FALSE(test_Resolver.IsPending());
+    ASSERT_EQ(test_Addresses.size(), 1);
+    EXPECT_EQ(test_Addresses[0].ss_family, AF_INET);
+    EXPECT_EQ(GetAddressLength(test_Addresses[0]), sizeof(SOCKADDR_IN));
+
+    auto pAddress = reinterpret_cast<const SOCKADDR_IN*>(&test_Addresses[0]);
+    EXPECT_EQ(ntohs(pAddress->sin_port), 5494);
+    EXPECT_EQ(ntohl(pAddress->sin_addr.s_addr), INADDR_LOOPBACK);
+}
+
+TEST_F(ResolverTest, BeginIPv6)
+{
+    // Verify behavior when resolving a numeric IPv6 address:
+    auto test_Addresses = test_Resolver.Begin(L"[::1]:5494", TEST_TIMEOUT);
+    EXPECT_FALSE(test_Resolver.IsPending());
+    ASSERT_EQ(test_Addresses.size(), 1);
+    EXPECT_EQ(test_Addresses[0].ss_family, AF_INET6);
+    EXPECT_EQ(GetAddressLength(test_Addresses[0]), sizeof(SOCKADDR_IN6));
+}
+
+TEST_F(ResolverTest, BeginInvalid)
+{
+    // Verify behavior when resolving an invalid address:
+    EXPECT_THROW(test_Resolver.Begin(L"", TEST_TIMEOUT), std::runtime_error);
+    EXPECT_FALSE(test_Resolver.IsPending());
+}
+
+TEST_F(ResolverTest, BeginName)
+{
+    // Verify behavior when resolving a name:
+    auto test_Addresses = test_Resolver.Begin(L"localhost:5494", TEST_TIMEOUT);
+    EXPECT_THAT(test_Addresses, IsEmpty());
+    ASSERT_TRUE(test_Resolver.IsPending());
+    EXPECT_EQ(test_Resolver.GetAddress(), L"localhost:5494");
+
+    // Verify behavior when resolution completes:
+    ASSERT_EQ(WaitForSingleObject(test_Resolver.GetHandle(), TEST_TIMEOUT * 2), WAIT_OBJECT_0);
+    auto Result = test_Resolver.Complete();
+    ASSERT_TRUE(Result);
+    EXPECT_THAT(Result.Value(), Not(IsEmpty()));
+    EXPECT_FALSE(test_Resolver.IsPending());
+    for (auto& Address : Result.Value()) {
+        EXPECT_THAT(Address.ss_family, AnyOf(AF_INET, AF_INET6));
+    }
+}
+
+TEST_F(ResolverTest, Cancel)
+{
+    // Verify behavior when resolution is cancelled:
+    test_Resolver.Begin(L"localhost:5494", TEST_TIMEOUT);
+    test_Resolver.Cancel();
+    EXPECT_FALSE(test_Resolver.IsPending());
+    EXPECT_EQ(test_Resolver.GetHandle(), nullptr);
+}
+
+TEST(AddressListTest, IsValidAddress)
+{
+    // Verify behavior when validating addresses:
+    EXPECT_TRUE(IsValidAddress(L"127.0.0.1:5494"));
+    EXPECT_TRUE(IsValidAddress(L"[::1]:5494"));
+    EXPECT_TRUE(IsValidAddress(L"localhost:5494"));
+    EXPECT_FALSE(IsValidAddress(L""));
+}
+
+TEST(AddressListTest, IsSameAddresses)
+{
+    SOCKADDR_STORAGE test_IPv4{.ss_family = AF_INET};
+    SOCKADDR_STORAGE test_IPv6{.ss_family = AF_INET6};
+
+    // Verify behavior when comparing address lists:
+    EXPECT_TRUE(IsSameAddresses({}, {}));
+    EXPECT_TRUE(IsSameAddresses({test_IPv4, test_IPv6}, {test_IPv4, test_IPv6}));
+    EXPECT_FALSE(IsSameAddresses({test_IPv4, test_IPv6}, {test_IPv6, test_IPv4}));
+    EXPECT_FALSE(IsSameAddresses({test_IPv4}, {test_IPv4, test_IPv6}));
+}
@@ -28,18 +28,39 @@
 #include "mock_winsock.h"
 #include "test_support.h"
 
+#include "delta.h"
+#include "memory.h"
+#include "metrics.h"
+#include "peer.h"
+#include "protocol.h"
 #include "server.h"
+#include "settings.h"
+#include "startup.h"
+#include "transform.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <tuple>
 
 using namespace ClipSock::Server;
+using ClipSock::GetTimestamp;
+using ClipSock::MemoryMonitor;
 using namespace testing;
 
+namespace Delta = ClipSock::Delta;
+namespace Metrics = ClipSock::Metrics;
+namespace Peer = ClipSock::Peer;
+namespace Protocol = ClipSock::Protocol;
+namespace Settings = ClipSock::Settings;
+namespace Startup = ClipSock::Startup;
+namespace Transform = ClipSock::Transform;
+
 class ServerTest : public Test {
 protected:
     GlobalMock<MockWindows> mock_Windows;
@@ -87,11 +108,77 @@ protected:
         return SocketResult;
     }
 
+    auto SetUpPeerAddress()
+    {
+        SOCKADDR_STORAGE test_Storage{};
+        test_Storage.ss_family = AF_INET;
+        return test_Storage;
+    }
+
+    auto SetUpPeer(WSAEVENT mock_hEvent)
+    {
+        auto test_Address = Peer::GetAddress(SetUpPeerAddress());
+        States[mock_hEvent].PeerAddress = test_Address;
+        Peers[test_Address].cConnections++;
+        return test_Address;
+    }
+
+    void SetUpSnapshot(std::string_view svText)
+    {
+        spSnapshot = std::make_shared<const Snapshot>(Snapshot{
+            .sText = std::string{svText},
+            .ullHash = Delta::Hash(svText)
+        });
+    }
+
+    std::string MakeResumeFrame(UINT64 ullTransferId, UINT32 cbLength)
+    {
+        std::string sFrame{Protocol::FRAME_MAGIC, ARRAYSIZE(Protocol::FRAME_MAGIC)};
+        sFrame.push_back(Protocol::FRAME_RESUME);
+        Protocol::PutUInt64(sFrame, ullTransferId);
+        Protocol::PutUInt32(sFrame, cbLength);
+        return sFrame;
+    }
+
+    void SetUpFrame(WSAEVENT mock_hEvent, std::string_view svFrame)
+    {
+        auto& Buffer = Buffers[mock_hEvent];
+        std::memcpy(&Buffer, svFrame.data(), svFrame.size());
+        Buffer += static_cast<INT>(svFrame.size());
+    }
+
     void TearDown() override
     {
+        Workers.Stop();
         Events.clear();
+        Listeners.clear();
+        ListenAddresses.clear();
+        ListenerAddresses.clear();
         Sockets.clear();
         Buffers.clear();
+        States.clear();
+        Transfers.Clear();
+        cbParked = 0;
+        Timers.Clear();
+        Peers.clear();
+        Waiters.clear();
+        RunCommands();
+        Monitor.Close();
+        Transfers.SetMaximum(MAXIMUM_PARKED_BYTES, MAXIMUM_PARKED_TRANSFERS);
+        Budget.Reset();
+        cbBudgetLimit = static_cast<SIZE_T>(Settings::DEFAULT_MEMORY_BUDGET) * 1024 * 1024;
+        Budget.SetLimit(cbBudgetLimit);
+        BufferSizes.Clear();
+        for (auto& Histogram : Latencies) {
+            Histogram.Clear();
+        }
+        LoadAccessList(L"");
+        Counters = {};
+        ullNextRejectionReport = 0;
+        cRejectionsSuppressed = 0;
+        ullReloadDeadline = 0;
+        spSnapshot.reset();
+        dwTransformFlags = 0;
     }
 
     UniqueGenerator<WSAEVENT> UniqueEvent;
@@ -161,6 +248,118 @@ TEST_F(ServerTest, CleanupEvents)
     CleanupEvents();
 }
 
+TEST_F(ServerTest, CloseListeners)
+{
+    auto [mock_hListenEvent, mock_hListenSocket] = SetUpSocket();
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    Listeners.push_back(mock_hListenEvent);
+
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hListenSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hListenEvent));
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket)).Times(0);
+
+    // Verify behavior when listeners are closed with a connection open:
+    CloseListeners();
+    EXPECT_THAT(Listeners, IsEmpty());
+    EXPECT_THAT(Events, ElementsAre(mock_hEvent));
+}
+
+TEST_F(ServerTest, ListenSkipsFailures)
+{
+    auto mock_hEvent1 = UniqueEvent();
+    auto mock_hEvent2 = UniqueEvent();
+    auto mock_hSocket1 = UniqueSocket();
+    auto mock_hSocket2 = UniqueSocket();
+    ClipSock::AddressList test_Addresses{SetUpPeerAddress(), SetUpPeerAddress()};
+    test_Addresses[1].ss_family = AF_INET6;
+
+    EXPECT_CALL(mock_Winsock, WSACreateEvent())
+        .WillOnce(Return(mock_hEvent1))
+        .WillOnce(Return(mock_hEvent2));
+    EXPECT_CALL(mock_Winsock, socket(AF_INET, SOCK_STREAM, IPPROTO_TCP))
+        .WillOnce(Return(mock_hSocket1));
+    EXPECT_CALL(mock_Winsock, socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP))
+        .WillOnce(Return(mock_hSocket2));
+    EXPECT_CALL(mock_Winsock, bind(mock_hSocket1, _, _))
+        .WillOnce(Return(0));
+    EXPECT_CALL(mock_Winsock, bind(mock_hSocket2, _, _))
+        .WillOnce(DoAll(InvokeWithoutArgs([] { SetLastError(WSAEADDRNOTAVAIL); }),
+                        Return(SOCKET_ERROR)));
+    EXPECT_CALL(mock_Winsock, listen(mock_hSocket1, SOMAXCONN))
+        .WillOnce(Return(0));
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket2));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent2));
+    EXPECT_CALL(mock_Windows, ReportEventA);
+
+    // Verify behavior when one of several addresses cannot be bound:
+    Listen(test_Addresses);
+    EXPECT_THAT(Listeners, ElementsAre(mock_hEvent1));
+    EXPECT_THAT(Events, ElementsAre(mock_hEvent1));
+    EXPECT_TRUE(IsListening(test_Addresses));
+}
+
+TEST_F(ServerTest, ListenChanged)
+{
+    auto mock_hEvent1 = UniqueEvent();
+    auto mock_hEvent2 = UniqueEvent();
+    auto mock_hSocket1 = UniqueSocket();
+    auto mock_hSocket2 = UniqueSocket();
+    auto test_IPv4 = SetUpPeerAddress();
+    auto test_IPv6 = SetUpPeerAddress();
+    test_IPv6.ss_family = AF_INET6;
+
+    ON_CALL(mock_Winsock, WSACreateEvent())
+        .WillByDefault(Return(mock_hEvent1));
+    ON_CALL(mock_Winsock, socket)
+        .WillByDefault(Return(mock_hSocket1));
+
+    EXPECT_CALL(mock_Winsock, socket).Times(1);
+    Listen({test_IPv4});
+
+    // Verify behavior when an address is added; the existing listener is
+    // kept open:
+    EXPECT_CALL(mock_Winsock, WSACreateEvent())
+        .WillOnce(Return(mock_hEvent2));
+    EXPECT_CALL(mock_Winsock, socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP))
+        .WillOnce(Return(mock_hSocket2));
+    EXPECT_CALL(mock_Winsock, closesocket).Times(0);
+    Listen({test_IPv4, test_IPv6});
+    EXPECT_THAT(Listeners, ElementsAre(mock_hEvent1, mock_hEvent2));
+    Mock::VerifyAndClearExpectations(&mock_Winsock);
+
+    // Verify behavior when an address is removed; only its listener is
+    // closed:
+    EXPECT_CALL(mock_Winsock, socket).Times(0);
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket1));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent1));
+    Listen({test_IPv6});
+    EXPECT_THAT(Listeners, ElementsAre(mock_hEvent2));
+    EXPECT_TRUE(IsListening({test_IPv6}));
+}
+
+TEST_F(ServerTest, ListenFailed)
+{
+    auto mock_hEvent = UniqueEvent();
+    auto mock_hSocket = UniqueSocket();
+    ClipSock::AddressList test_Addresses{SetUpPeerAddress()};
+
+    EXPECT_CALL(mock_Winsock, WSACreateEvent())
+        .WillOnce(Return(mock_hEvent));
+    EXPECT_CALL(mock_Winsock, socket)
+        .WillOnce(Return(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, bind(mock_hSocket, _, _))
+        .WillOnce(DoAll(InvokeWithoutArgs([] { SetLastError(WSAEADDRINUSE); }),
+                        Return(SOCKET_ERROR)));
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+    EXPECT_CALL(mock_Windows, ReportEventA);
+
+    // Verify behavior when no address can be bound:
+    EXPECT_THROW(Listen(test_Addresses), std::runtime_error);
+    EXPECT_THAT(Listeners, IsEmpty());
+    EXPECT_THAT(Events, IsEmpty());
+}
+
 TEST_F(ServerTest, AcceptEvent)
 {
     WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_ACCEPT };
@@ -170,7 +369,7 @@ TEST_F(ServerTest, AcceptEvent)
     EXPECT_CALL(mock_Winsock, WSACreateEvent())
         .WillOnce(Return(mock_hNewEvent));
 
-    EXPECT_CALL(mock_Winsock, accept(mock_hSocket, _, _))
+    EXPECT_CALL(mock_Winsock, WSAAccept(mock_hSocket, _, _, _, _))
         .WillOnce(Return(mock_hNewSocket));
 
     long expect_lNetworkEvents{FD_READ | FD_CLOSE};
@@ -181,6 +380,8 @@ TEST_F(ServerTest, AcceptEvent)
 
     // Verify behavior when an FD_ACCEPT network event occurs:
     ThreadProc(nullptr);
+
+    EXPECT_TRUE(Timers.Contains(mock_hNewEvent));
 }
 
 TEST_F(ServerTest, AcceptEventError)
@@ -201,11 +402,37 @@ TEST_F(ServerTest, AcceptFull)
 {
     auto [mock_hEvent, mock_hSocket] = SetUpSocket();
 
+    auto mock_hNewSocket = UniqueSocket();
+
+    EXPECT_CALL(mock_Winsock, accept(mock_hSocket, _, _))
+        .WillOnce(Return(mock_hNewSocket));
+    EXPECT_CALL(mock_Winsock, setsockopt(mock_hNewSocket, SOL_SOCKET, SO_LINGER, _, _));
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hNewSocket));
+    EXPECT_CALL(mock_Winsock, WSACreateEvent).Times(0);
     EXPECT_CALL(mock_Windows, ReportEventA);
 
     // Verify behavior when server is full:
     Events.resize(WSA_MAXIMUM_WAIT_EVENTS);
     EXPECT_NO_THROW(Accept(mock_hSocket));
+    EXPECT_EQ(Counters.cRejected, 1);
+}
+
+TEST_F(ServerTest, AcceptFullReported)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+
+    EXPECT_CALL(mock_Winsock, accept(mock_hSocket, _, _))
+        .Times(3)
+        .WillRepeatedly(Return(INVALID_SOCKET));
+    EXPECT_CALL(mock_Windows, ReportEventA);
+
+    // Verify behavior when rejections are reported while server is full:
+    Events.resize(WSA_MAXIMUM_WAIT_EVENTS);
+    Accept(mock_hSocket);
+    Accept(mock_hSocket);
+    Accept(mock_hSocket);
+    EXPECT_EQ(Counters.cRejected, 3);
+    EXPECT_EQ(cRejectionsSuppressed, 2);
 }
 
 TEST_F(ServerTest, AcceptInvalidEvent)
@@ -229,13 +456,13 @@ TEST_F(ServerTest, AcceptInvalidSocket)
     EXPECT_CALL(mock_Winsock, WSACreateEvent)
         .WillOnce(Return(mock_hNewEvent));
 
-    EXPECT_CALL(mock_Winsock, accept)
+    EXPECT_CALL(mock_Winsock, WSAAccept)
         .WillOnce(Return(INVALID_SOCKET));
 
     EXPECT_CALL(mock_Windows, ReportEventA);
     EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hNewEvent));
 
-    // Verify behavior when accept() fails:
+    // Verify behavior when WSAAccept() fails:
     EXPECT_NO_THROW(Accept(mock_hSocket));
 }
 
@@ -247,7 +474,7 @@ TEST_F(ServerTest, AcceptSelectFails)
     EXPECT_CALL(mock_Winsock, WSACreateEvent)
         .WillOnce(Return(mock_hNewEvent));
 
-    EXPECT_CALL(mock_Winsock, accept)
+    EXPECT_CALL(mock_Winsock, WSAAccept)
         .WillOnce(Return(mock_hNewSocket));
 
     EXPECT_CALL(mock_Winsock, WSAEventSelect)
@@ -261,6 +488,242 @@ TEST_F(ServerTest, AcceptSelectFails)
     EXPECT_NO_THROW(Accept(mock_hSocket));
 }
 
+TEST_F(ServerTest, AcceptPeer)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto [mock_hNewEvent, mock_hNewSocket] = SetUpSocket();
+    auto test_Storage = SetUpPeerAddress();
+    auto expect_Address = Peer::GetAddress(test_Storage);
+
+    EXPECT_CALL(mock_Winsock, WSACreateEvent())
+        .WillOnce(Return(mock_hNewEvent));
+
+    EXPECT_CALL(mock_Winsock, WSAAccept(mock_hSocket, NotNull(), NotNull(), _, _))
+        .WillOnce(DoAll(WithArg<1>([&](auto pAddress) {
+                            std::memcpy(pAddress, &test_Storage, sizeof(test_Storage));
+                        }),
+                        Return(mock_hNewSocket)));
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hNewSocket, mock_hNewEvent, _))
+        .WillOnce(Return(0));
+
+    // Verify behavior when a connection is accepted from a known peer:
+    Accept(mock_hSocket);
+    EXPECT_EQ(States[mock_hNewEvent].PeerAddress, expect_Address);
+    EXPECT_EQ(Peers[expect_Address].cConnections, 1);
+
+    CleanupEvent(mock_hNewEvent);
+    EXPECT_EQ(Peers[expect_Address].cConnections, 0);
+}
+
+TEST_F(ServerTest, AcceptLoopback)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto [mock_hNewEvent, mock_hNewSocket] = SetUpSocket();
+    SOCKADDR_STORAGE test_Storage{};
+    auto& test_Address = reinterpret_cast<SOCKADDR_IN&>(test_Storage);
+    test_Address.sin_family = AF_INET;
+    constexpr BYTE test_Loopback[]{127, 0, 0, 1};
+    std::memcpy(&test_Address.sin_addr, test_Loopback, sizeof(test_Loopback));
+    auto expect_Address = Peer::GetAddress(test_Storage);
+
+    EXPECT_CALL(mock_Winsock, WSACreateEvent())
+        .WillOnce(Return(mock_hNewEvent));
+
+    EXPECT_CALL(mock_Winsock, WSAAccept(mock_hSocket, NotNull(), NotNull(), _, _))
+        .WillOnce(DoAll(WithArg<1>([&](auto pAddress) {
+                            std::memcpy(pAddress, &test_Storage, sizeof(test_Storage));
+                        }),
+                        Return(mock_hNewSocket)));
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hNewSocket, mock_hNewEvent, _))
+        .WillOnce(Return(0));
+
+    // Verify behavior when a connection is accepted from a loopback peer;
+    // it is exempt from per-peer limits:
+    Accept(mock_hSocket);
+    EXPECT_EQ(States[mock_hNewEvent].PeerAddress, expect_Address);
+    EXPECT_FALSE(Peers.contains(expect_Address));
+
+    Throttle(mock_hNewEvent, PEER_BYTE_BURST + PEER_BYTE_RATE, GetTickCount64());
+    EXPECT_EQ(States[mock_hNewEvent].ullResumeRead, 0);
+    EXPECT_TRUE(Charge(mock_hNewEvent, MAXIMUM_BUFFER_SIZE));
+}
+
+TEST_F(ServerTest, AcceptRefused)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto mock_hNewEvent = SetUpEvent();
+    SOCKADDR_STORAGE test_Storage{};
+    auto& test_Address = reinterpret_cast<SOCKADDR_IN&>(test_Storage);
+    test_Address.sin_family = AF_INET;
+    std::memcpy(&test_Address.sin_addr, "\xC0\x00\x02\x01", 4); // 192.0.2.1
+
+    LoadAccessList(L"10.0.0.0/8");
+
+    EXPECT_CALL(mock_Winsock, WSACreateEvent)
+        .WillOnce(Return(mock_hNewEvent));
+
+    EXPECT_CALL(mock_Winsock, WSAAccept(mock_hSocket, _, _, NotNull(), _))
+        .WillOnce([&](auto, auto, auto, auto lpfnCondition, auto dwCallbackData) {
+            WSABUF CallerId{sizeof(test_Storage), reinterpret_cast<CHAR*>(&test_Storage)};
+            EXPECT_EQ(lpfnCondition(&CallerId, nullptr, nullptr, nullptr,
+                                    nullptr, nullptr, nullptr, dwCallbackData), CF_REJECT);
+            return INVALID_SOCKET;
+        });
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect).Times(0);
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hNewEvent));
+    EXPECT_CALL(mock_Windows, ReportEventA);
+
+    // Verify behavior when a peer is not in the access list:
+    EXPECT_NO_THROW(Accept(mock_hSocket));
+    EXPECT_FALSE(States.contains(mock_hNewEvent));
+    EXPECT_EQ(Counters.cRefused, 1);
+}
+
+TEST_F(ServerTest, AccessList)
+{
+    auto GetAddress = [](std::wstring_view svAddress) {
+        return ClipSock::Peer::ParsePrefix(svAddress).PrefixAddress;
+    };
+
+    // Verify behavior when unlisted peers are allowed:
+    LoadAccessList(L"!192.0.2.0/24, !2001:db8::1");
+    EXPECT_FALSE(IsAllowed(GetAddress(L"192.0.2.1")));
+    EXPECT_FALSE(IsAllowed(GetAddress(L"2001:db8::1")));
+    EXPECT_TRUE(IsAllowed(GetAddress(L"192.0.3.1")));
+    EXPECT_TRUE(IsAllowed(GetAddress(L"2001:db8::2")));
+
+    // Verify behavior when only listed peers are allowed:
+    LoadAccessList(L"10.0.0.0/8 !10.1.0.0/16; 10.1.2.3");
+    EXPECT_TRUE(IsAllowed(GetAddress(L"10.0.0.1")));
+    EXPECT_FALSE(IsAllowed(GetAddress(L"10.1.0.1")));
+    EXPECT_TRUE(IsAllowed(GetAddress(L"10.1.2.3")));
+    EXPECT_FALSE(IsAllowed(GetAddress(L"192.0.2.1")));
+    EXPECT_FALSE(IsAllowed(GetAddress(L"::1")));
+
+    // Verify behavior when the access list is invalid:
+    EXPECT_FALSE(IsValidAccessList(L"10.0.0.0/33"));
+    EXPECT_THROW(LoadAccessList(L"10.0.0.0/33"), std::runtime_error);
+    EXPECT_TRUE(IsAllowed(GetAddress(L"10.0.0.1")));
+    EXPECT_FALSE(IsAllowed(GetAddress(L"192.0.2.1")));
+}
+
+TEST_F(ServerTest, RunCommands)
+{
+    auto GetAddress = [](std::wstring_view svAddress) {
+        return ClipSock::Peer::ParsePrefix(svAddress).PrefixAddress;
+    };
+
+    // Verify behavior when no commands have been sent:
+    EXPECT_FALSE(RunCommands());
+
+    // Verify behavior when settings are changed:
+    EXPECT_TRUE(SendCommand(CommandType::SetAccessList, 0, L"!192.0.2.0/24"));
+    EXPECT_TRUE(SendCommand(CommandType::SetMemoryBudget, 1));
+    EXPECT_TRUE(SendCommand(CommandType::SetTransformFlags, Transform::STRIP_ESCAPES));
+    EXPECT_TRUE(RunCommands());
+    EXPECT_FALSE(IsAllowed(GetAddress(L"192.0.2.1")));
+    EXPECT_EQ(Budget.Limit(), 1024 * 1024);
+    EXPECT_EQ(cbBudgetLimit, 1024 * 1024);
+    EXPECT_EQ(dwTransformFlags, Transform::STRIP_ESCAPES);
+    EXPECT_FALSE(RunCommands());
+}
+
+TEST_F(ServerTest, SendCommandFull)
+{
+    // Verify behavior when the command queue is full:
+    for (auto i = 0; i < COMMAND_QUEUE_CAPACITY; i++) {
+        ASSERT_TRUE(SendCommand(CommandType::SetMemoryBudget, i + 1));
+    }
+    EXPECT_FALSE(SendCommand(CommandType::SetMemoryBudget, 1));
+
+    // Verify behavior when commands run in order:
+    EXPECT_TRUE(RunCommands());
+    EXPECT_EQ(Budget.Limit(), static_cast<SIZE_T>(COMMAND_QUEUE_CAPACITY) * 1024 * 1024);
+}
+
+TEST_F(ServerTest, StopCommand)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+
+    bStopRequested = FALSE;
+    EXPECT_CALL(mock_Winsock, WSAWaitForMultipleEvents)
+        .WillOnce(Return(WSA_WAIT_EVENT_0));
+
+    EXPECT_CALL(mock_Winsock, WSAEnumNetworkEvents).Times(0);
+    EXPECT_CALL(mock_Winsock, closesocket).Times(0);
+
+    // Verify behavior when a stop command is sent with a network event
+    // pending:
+    ASSERT_TRUE(SendCommand(CommandType::Stop));
+    ThreadProc(nullptr);
+    EXPECT_TRUE(bStopRequested);
+}
+
+TEST_F(ServerTest, ScheduleReload)
+{
+    auto test_Now = GetTickCount64();
+
+    // Verify behavior when no reload is scheduled:
+    EXPECT_EQ(GetWaitTimeout(test_Now), INFINITE);
+
+    // Verify behavior when changes arrive in quick succession:
+    ScheduleReload(test_Now);
+    ScheduleReload(test_Now + SETTINGS_RELOAD_DELAY / 2);
+    EXPECT_EQ(ullReloadDeadline, test_Now + SETTINGS_RELOAD_DELAY / 2 + SETTINGS_RELOAD_DELAY);
+    EXPECT_EQ(GetWaitTimeout(test_Now + SETTINGS_RELOAD_DELAY), SETTINGS_RELOAD_DELAY / 2);
+
+    // Verify behavior when the deadline has not yet passed:
+    ReloadSettings(test_Now + SETTINGS_RELOAD_DELAY);
+    EXPECT_NE(ullReloadDeadline, 0);
+}
+
+TEST_F(ServerTest, UpdateSettingsFailure)
+{
+    auto test_Now = GetTickCount64();
+
+    // Verify behavior when the monitor cannot be rearmed:
+    ASSERT_FALSE(SettingsMonitor.IsOpen());
+    EXPECT_NO_THROW(UpdateSettings(test_Now));
+    EXPECT_FALSE(SettingsMonitor.IsOpen());
+    EXPECT_EQ(ullReloadDeadline, test_Now + SETTINGS_RELOAD_DELAY);
+}
+
+TEST_F(ServerTest, AcceptPeerThrottled)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto [mock_hNewEvent, mock_hNewSocket] = SetUpSocket();
+    auto test_Storage = SetUpPeerAddress();
+    auto expect_Address = Peer::GetAddress(test_Storage);
+
+    auto& test_Peer = Peers[expect_Address];
+    while (test_Peer.Connections.TryConsume(1, GetTickCount64())) {
+    }
+
+    EXPECT_CALL(mock_Winsock, WSACreateEvent())
+        .WillOnce(Return(mock_hNewEvent));
+
+    EXPECT_CALL(mock_Winsock, WSAAccept(mock_hSocket, NotNull(), NotNull(), _, _))
+        .WillOnce(DoAll(WithArg<1>([&](auto pAddress) {
+                            std::memcpy(pAddress, &test_Storage, sizeof(test_Storage));
+                        }),
+                        Return(mock_hNewSocket)));
+
+    EXPECT_CALL(mock_Winsock, setsockopt(mock_hNewSocket, SOL_SOCKET, SO_LINGER, _, _));
+    EXPECT_CALL(mock_Winsock, WSAEventSelect).Times(0);
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hNewSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hNewEvent));
+    EXPECT_CALL(mock_Windows, ReportEventA);
+
+    // Verify behavior when a peer connects too frequently:
+    EXPECT_NO_THROW(Accept(mock_hSocket));
+    EXPECT_FALSE(Timers.Contains(mock_hNewEvent));
+    EXPECT_EQ(Counters.cThrottledConnections, 1);
+    EXPECT_EQ(test_Peer.cConnections, 0);
+}
+
 TEST_F(ServerTest, ReadEvent)
 {
     WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_READ };
@@ -283,6 +746,26 @@ TEST_F(ServerTest, ReadEvent)
     EXPECT_THAT(mock_hMem, Contains(expect_Fill).Times(expect_Length));
 }
 
+TEST_F(ServerTest, ReadEventMetrics)
+{
+    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_READ };
+    auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    auto expect_Length = 100;
+    EXPECT_CALL(mock_Winsock, recv(mock_hSocket, mock_hMem, MAXIMUM_BUFFER_SIZE, _))
+        .WillOnce(Return(expect_Length));
+
+    auto test_BytesReceived = Metrics::Get(Metrics::Metric::BytesReceived);
+
+    // Verify behavior when metrics are updated by an FD_READ network event:
+    ThreadProc(nullptr);
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::BytesReceived), test_BytesReceived + expect_Length);
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::ConnectionsActive), 1);
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::MemoryReserved), MAXIMUM_BUFFER_SIZE);
+}
+
 TEST_F(ServerTest, ReadEventFull)
 {
     WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_READ };
@@ -326,59 +809,1050 @@ TEST_F(ServerTest, ReadRecvFails)
     SetUpBuffer(mock_hMem);
 
     EXPECT_CALL(mock_Winsock, recv)
-        .WillOnce(Return(SOCKET_ERROR));
+        .WillOnce(DoAll(InvokeWithoutArgs([] { SetLastError(WSAECONNRESET); }),
+                        Return(SOCKET_ERROR)));
 
     // Verify behavior when recv() fails:
-    EXPECT_THROW(Read(mock_hSocket, Buffers[mock_hEvent]), std::runtime_error);
+    auto test_Result = Read(mock_hSocket, Buffers[mock_hEvent]);
+    EXPECT_FALSE(test_Result);
+    EXPECT_EQ(test_Result.Error(), WSAECONNRESET);
+    EXPECT_EQ(Buffers[mock_hEvent].Size(), 0);
 }
 
-TEST_F(ServerTest, CloseEvent)
+TEST_F(ServerTest, ReadEventReset)
 {
-    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_CLOSE };
+    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_READ };
     auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
     EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
     SetUpBuffer(mock_hMem);
 
-    EXPECT_CALL(mock_Windows, OpenClipboard);
-    EXPECT_CALL(mock_Windows, EmptyClipboard);
-    EXPECT_CALL(mock_Windows, GlobalUnlock(mock_hMem));
-    EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hMem));
-    EXPECT_CALL(mock_Windows, CloseClipboard);
+    EXPECT_CALL(mock_Winsock, recv)
+        .WillOnce(DoAll(InvokeWithoutArgs([] { SetLastError(WSAECONNRESET); }),
+                        Return(SOCKET_ERROR)));
 
+    EXPECT_CALL(mock_Windows, ReportEventA);
     EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
     EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
 
-    // Verify behavior when an FD_CLOSE network event occurs:
-    Buffers[mock_hEvent]++;
+    // Verify behavior when a client resets the connection while reading:
     ThreadProc(nullptr);
+
+    EXPECT_FALSE(States.contains(mock_hEvent));
 }
 
-TEST_F(ServerTest, CloseEventError)
+TEST_F(ServerTest, ExpireIdle)
 {
-    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_CLOSE };
-    mock_NetworkEvents.iErrorCode[FD_CLOSE_BIT] = WSAENETDOWN;
-    auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto test_Now = 1'000'000ull;
+    States[mock_hEvent].ullAccepted = test_Now;
+    ScheduleTimeout(mock_hEvent, test_Now);
 
-    EXPECT_CALL(mock_Windows, ReportEventA);
     EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
     EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
 
-    // Verify behavior when an FD_CLOSE network event fails:
+    // Verify behavior when a connection remains idle:
+    ExpireTimeouts(test_Now + CONNECTION_IDLE_TIMEOUT - 1);
+    EXPECT_TRUE(Timers.Contains(mock_hEvent));
+
+    ExpireTimeouts(test_Now + CONNECTION_IDLE_TIMEOUT);
+    EXPECT_FALSE(Timers.Contains(mock_hEvent));
+    EXPECT_EQ(Counters.cIdleTimeouts, 1);
+    EXPECT_EQ(Counters.cDurationTimeouts, 0);
+}
+
+TEST_F(ServerTest, ExpireDuration)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto test_Now = 1'000'000ull;
+    States[mock_hEvent].ullAccepted = test_Now;
+    ScheduleTimeout(mock_hEvent, test_Now);
+
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior when a connection remains active for too long:
+    auto ullNow = test_Now;
+    while (Timers.Contains(mock_hEvent)) {
+        ullNow += CONNECTION_IDLE_TIMEOUT / 2;
+        ExpireTimeouts(ullNow);
+        if (Timers.Contains(mock_hEvent)) {
+            ScheduleTimeout(mock_hEvent, ullNow);
+        }
+    }
+    EXPECT_EQ(ullNow, test_Now + CONNECTION_DURATION_TIMEOUT);
+    EXPECT_EQ(Counters.cIdleTimeouts, 0);
+    EXPECT_EQ(Counters.cDurationTimeouts, 1);
+}
+
+TEST_F(ServerTest, WaitTimeout)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto test_Now = GetTickCount64();
+    States[mock_hEvent].ullAccepted = test_Now;
+    ScheduleTimeout(mock_hEvent, test_Now);
+
+    bStopRequested = FALSE;
+    EXPECT_CALL(mock_Winsock, WSAWaitForMultipleEvents(_, _, _, Le(CONNECTION_IDLE_TIMEOUT), _))
+        .WillOnce(Return(WSA_WAIT_TIMEOUT))
+        .WillOnce(DoAll(Assign(&bStopRequested, TRUE),
+                        Return(WSA_WAIT_IO_COMPLETION)));
+
+    EXPECT_CALL(mock_Winsock, WSAEnumNetworkEvents).Times(0);
+    EXPECT_CALL(mock_Winsock, closesocket).Times(0);
+
+    // Verify behavior when waiting for a connection with a pending timeout:
     ThreadProc(nullptr);
 }
 
-TEST_F(ServerTest, CloseEmpty)
+TEST_F(ServerTest, WaitMemoryPastIdle)
 {
     auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto test_Now = GetTickCount64();
+    States[mock_hEvent].ullAccepted = test_Now;
+    ScheduleTimeout(mock_hEvent, test_Now);
 
-    EXPECT_CALL(mock_Windows, OpenClipboard).Times(0);
-    EXPECT_CALL(mock_Windows, EmptyClipboard).Times(0);
-    EXPECT_CALL(mock_Windows, SetClipboardData).Times(0);
-    EXPECT_CALL(mock_Windows, CloseClipboard).Times(0);
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket, mock_hEvent, 0))
+        .WillOnce(Return(0));
+    EXPECT_CALL(mock_Winsock, closesocket).Times(0);
+
+    // Verify behavior when a connection waits for memory for longer than
+    // the idle timeout:
+    Wait(mock_hEvent, 1024);
+    ExpireTimeouts(test_Now + CONNECTION_IDLE_TIMEOUT);
+    ExpireTimeouts(test_Now + CONNECTION_IDLE_TIMEOUT * 2);
+    EXPECT_TRUE(States.contains(mock_hEvent));
+    EXPECT_TRUE(Timers.Contains(mock_hEvent));
+    EXPECT_EQ(Counters.cIdleTimeouts, 0);
+    Mock::VerifyAndClearExpectations(&mock_Winsock);
 
     EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
     EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
 
-    // Verify behavior closing with an empty buffer:
-    Close(mock_hEvent);
+    // Verify behavior when the connection is still waiting once the
+    // duration deadline passes:
+    ExpireTimeouts(test_Now + CONNECTION_DURATION_TIMEOUT);
+    EXPECT_FALSE(States.contains(mock_hEvent));
+    EXPECT_EQ(Counters.cDurationTimeouts, 1);
+}
+
+TEST_F(ServerTest, ReadThrottled)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto test_Now = 1'000'000ull;
+    SetUpPeer(mock_hEvent);
+    States[mock_hEvent].ullAccepted = test_Now;
+    ScheduleTimeout(mock_hEvent, test_Now);
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket, mock_hEvent, 0))
+        .WillOnce(Return(0));
+
+    // Verify behavior when a peer sends faster than permitted:
+    Throttle(mock_hEvent, PEER_BYTE_BURST + PEER_BYTE_RATE, test_Now);
+    EXPECT_EQ(States[mock_hEvent].ullResumeRead, test_Now + 1000);
+    EXPECT_EQ(Counters.cThrottledReads, 1);
+
+    long expect_lNetworkEvents{FD_READ | FD_CLOSE};
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket, mock_hEvent,
+                                             HasFlags(expect_lNetworkEvents)))
+        .WillOnce(Return(0));
+    EXPECT_CALL(mock_Winsock, closesocket).Times(0);
+
+    ExpireTimeouts(test_Now + 999);
+    ExpireTimeouts(test_Now + 1000);
+    EXPECT_EQ(States[mock_hEvent].ullResumeRead, 0);
+    EXPECT_TRUE(Timers.Contains(mock_hEvent));
+    EXPECT_EQ(Counters.cIdleTimeouts, 0);
+}
+
+TEST_F(ServerTest, ReadUnthrottled)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    SetUpPeer(mock_hEvent);
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect).Times(0);
+
+    // Verify behavior when a peer sends within its burst:
+    Throttle(mock_hEvent, PEER_BYTE_BURST, 1'000'000);
+    EXPECT_EQ(States[mock_hEvent].ullResumeRead, 0);
+    EXPECT_EQ(Counters.cThrottledReads, 0);
+}
+
+TEST_F(ServerTest, BufferCharged)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto test_Address = SetUpPeer(mock_hEvent);
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    // Verify behavior when buffer memory is charged to a peer:
+    GetBuffer(mock_hEvent);
+    EXPECT_EQ(Peers[test_Address].cbBuffered, MAXIMUM_BUFFER_SIZE);
+    EXPECT_EQ(States[mock_hEvent].cbCharged, MAXIMUM_BUFFER_SIZE);
+
+    CleanupEvent(mock_hEvent);
+    EXPECT_EQ(Peers[test_Address].cbBuffered, 0);
+}
+
+TEST_F(ServerTest, BufferSized)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+    for (auto i = 0; i < BUFFER_SIZE_SAMPLES; i++) {
+        BufferSizes.Add(6000);
+    }
+
+    SIZE_T expect_Size = 8192;
+    EXPECT_CALL(mock_Windows, GlobalAlloc(_, expect_Size + 1));
+
+    // Verify behavior when buffers are sized from observed payloads:
+    EXPECT_EQ(GetInitialBufferSize(), expect_Size);
+    GetBuffer(mock_hEvent);
+    EXPECT_EQ(Buffers[mock_hEvent].Capacity(), expect_Size);
+    EXPECT_EQ(States[mock_hEvent].cbCharged, expect_Size);
+}
+
+TEST_F(ServerTest, BufferSizedMinimum)
+{
+    // Verify behavior when observed payloads are smaller than the minimum:
+    EXPECT_EQ(GetInitialBufferSize(), MAXIMUM_BUFFER_SIZE);
+    for (auto i = 0; i < BUFFER_SIZE_SAMPLES; i++) {
+        BufferSizes.Add(10);
+    }
+    EXPECT_EQ(GetInitialBufferSize(), MINIMUM_BUFFER_SIZE);
+}
+
+TEST_F(ServerTest, BufferGrows)
+{
+    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_READ };
+    auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
+    EventBuffer::ValueType mock_hMem[MINIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hGrownMem[MAXIMUM_BUFFER_SIZE+1]{};
+    for (auto i = 0; i < BUFFER_SIZE_SAMPLES; i++) {
+        BufferSizes.Add(10);
+    }
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc)
+        .WillOnce(Return(mock_hMem))
+        .WillOnce(Return(mock_hGrownMem));
+    ON_CALL(mock_Windows, GlobalLock(mock_hMem))
+        .WillByDefault(Return(mock_hMem));
+    ON_CALL(mock_Windows, GlobalLock(mock_hGrownMem))
+        .WillByDefault(Return(mock_hGrownMem));
+
+    auto expect_Fill = 'X';
+    auto expect_Length = MINIMUM_BUFFER_SIZE;
+    EXPECT_CALL(mock_Winsock, recv(mock_hSocket, mock_hMem, MINIMUM_BUFFER_SIZE, _))
+        .WillOnce(DoAll(WithArg<1>(FillPointer(expect_Fill, expect_Length)),
+                        Return(expect_Length)));
+
+    EXPECT_CALL(mock_Windows, GlobalFree).Times(AnyNumber());
+    EXPECT_CALL(mock_Windows, GlobalFree(mock_hMem));
+    EXPECT_CALL(mock_Winsock, closesocket).Times(0);
+
+    // Verify behavior when a buffer is filled before the maximum size:
+    ThreadProc(nullptr);
+    EXPECT_EQ(Buffers[mock_hEvent].Capacity(), MAXIMUM_BUFFER_SIZE);
+    EXPECT_EQ(Buffers[mock_hEvent].Size(), expect_Length);
+    EXPECT_EQ(States[mock_hEvent].cbCharged, MAXIMUM_BUFFER_SIZE);
+    EXPECT_EQ(Counters.cBufferGrowths, 1);
+    EXPECT_THAT(mock_hGrownMem, Contains(expect_Fill).Times(expect_Length));
+}
+
+TEST_F(ServerTest, BufferGrowWaits)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+    for (auto i = 0; i < BUFFER_SIZE_SAMPLES; i++) {
+        BufferSizes.Add(10);
+    }
+    Budget.SetLimit(MAXIMUM_BUFFER_SIZE);
+    Budget.TryReserve(0, MAXIMUM_BUFFER_SIZE - MINIMUM_BUFFER_SIZE);
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket, mock_hEvent, 0))
+        .WillOnce(Return(0));
+    EXPECT_CALL(mock_Winsock, closesocket).Times(0);
+
+    // Verify behavior when a buffer cannot grow within the budget:
+    GetBuffer(mock_hEvent);
+    Buffers[mock_hEvent] += MINIMUM_BUFFER_SIZE;
+    EXPECT_FALSE(Process(mock_hSocket, mock_hEvent));
+    EXPECT_EQ(Buffers[mock_hEvent].Capacity(), MINIMUM_BUFFER_SIZE);
+    EXPECT_THAT(Waiters, ElementsAre(mock_hEvent));
+}
+
+TEST_F(ServerTest, BufferSizeRecorded)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    // Verify behavior when a completed payload is recorded:
+    Buffers[mock_hEvent] += 100;
+    Close(mock_hEvent);
+    EXPECT_EQ(BufferSizes.Count(), 1);
+    EXPECT_EQ(BufferSizes.Counts()[7], 1);
+}
+
+TEST_F(ServerTest, BufferQuotaExceeded)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto test_Address = SetUpPeer(mock_hEvent);
+    Peers[test_Address].cbBuffered = MAXIMUM_PEER_BUFFER_SIZE;
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc).Times(0);
+
+    // Verify behavior when a peer exceeds its buffer quota:
+    EXPECT_THROW(GetBuffer(mock_hEvent), std::runtime_error);
+    EXPECT_FALSE(Buffers.contains(mock_hEvent));
+    EXPECT_EQ(Counters.cQuotaExceeded, 1);
+}
+
+TEST_F(ServerTest, BufferWaits)
+{
+    auto [mock_hEvent1, mock_hSocket1] = SetUpSocket();
+    auto [mock_hEvent2, mock_hSocket2] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+    Budget.SetLimit(MAXIMUM_BUFFER_SIZE);
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket2, mock_hEvent2, 0))
+        .WillOnce(Return(0));
+
+    // Verify behavior when the memory budget is exhausted:
+    EXPECT_NE(GetBuffer(mock_hEvent1), nullptr);
+    EXPECT_EQ(GetBuffer(mock_hEvent2), nullptr);
+    EXPECT_FALSE(Buffers.contains(mock_hEvent2));
+    EXPECT_THAT(Waiters, ElementsAre(mock_hEvent2));
+    EXPECT_EQ(Counters.cBudgetWaits, 1);
+
+    ResumeWaiters();
+    EXPECT_THAT(Waiters, ElementsAre(mock_hEvent2));
+
+    long expect_lNetworkEvents{FD_READ | FD_CLOSE};
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket2, mock_hEvent2,
+                                             HasFlags(expect_lNetworkEvents)))
+        .WillOnce(Return(0));
+
+    // Verify behavior when memory is released to a waiting connection:
+    CleanupEvent(mock_hEvent1);
+    ResumeWaiters();
+    EXPECT_THAT(Waiters, IsEmpty());
+    EXPECT_EQ(States[mock_hEvent2].cbWanted, 0);
+    EXPECT_NE(GetBuffer(mock_hEvent2), nullptr);
+    EXPECT_EQ(Budget.Reserved(), MAXIMUM_BUFFER_SIZE);
+    EXPECT_EQ(Budget.HighWater(), MAXIMUM_BUFFER_SIZE);
+}
+
+TEST_F(ServerTest, BufferWaitsCleanup)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    Budget.SetLimit(MAXIMUM_BUFFER_SIZE);
+    Budget.TryReserve(0, MAXIMUM_BUFFER_SIZE);
+
+    // Verify behavior when a waiting connection is cleaned up:
+    EXPECT_EQ(GetBuffer(mock_hEvent), nullptr);
+    CleanupEvent(mock_hEvent);
+    EXPECT_THAT(Waiters, IsEmpty());
+}
+
+TEST_F(ServerTest, BufferExceedsBudget)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    Budget.SetLimit(MAXIMUM_BUFFER_SIZE - 1);
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect).Times(0);
+
+    // Verify behavior when a buffer can never fit within the budget:
+    EXPECT_THROW(GetBuffer(mock_hEvent), std::runtime_error);
+    EXPECT_THAT(Waiters, IsEmpty());
+}
+
+TEST_F(ServerTest, MemoryLow)
+{
+    auto mock_hLowMemory = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    auto mock_hHighMemory = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    ON_CALL(mock_Windows, CreateMemoryResourceNotification(LowMemoryResourceNotification))
+        .WillByDefault(Return(mock_hLowMemory));
+    ON_CALL(mock_Windows, CreateMemoryResourceNotification(HighMemoryResourceNotification))
+        .WillByDefault(Return(mock_hHighMemory));
+    ON_CALL(mock_Windows, QueryMemoryResourceNotification)
+        .WillByDefault(DoAll(SetArgPointee<1>(TRUE), Return(TRUE)));
+    Monitor.Open();
+
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpSnapshot("base text");
+    Transfers.Insert(42, {}, 1024, GetTickCount64());
+
+    EXPECT_CALL(mock_Windows, ReportEventA).Times(2);
+
+    // Verify behavior when system memory becomes low:
+    UpdateMemoryCondition();
+    EXPECT_EQ(Monitor.GetCondition(), MemoryMonitor::Condition::Low);
+    EXPECT_EQ(Transfers.Count(), 0);
+    EXPECT_FALSE(spSnapshot);
+    EXPECT_EQ(Budget.Limit(), cbBudgetLimit / LOW_MEMORY_BUDGET_DIVISOR);
+    EXPECT_FALSE(Transfers.Insert(43, {}, 1024, GetTickCount64()));
+
+    // Verify behavior when system memory becomes available again:
+    UpdateMemoryCondition();
+    EXPECT_EQ(Monitor.GetCondition(), MemoryMonitor::Condition::Normal);
+    EXPECT_EQ(Budget.Limit(), cbBudgetLimit);
+    EXPECT_TRUE(Transfers.Insert(43, {}, 1024, GetTickCount64()));
+}
+
+TEST_F(ServerTest, StartupOrdering)
+{
+    auto mock_hLowMemory = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    auto mock_hHighMemory = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    ON_CALL(mock_Windows, CreateMemoryResourceNotification(LowMemoryResourceNotification))
+        .WillByDefault(Return(mock_hLowMemory));
+    ON_CALL(mock_Windows, CreateMemoryResourceNotification(HighMemoryResourceNotification))
+        .WillByDefault(Return(mock_hHighMemory));
+    ON_CALL(mock_Winsock, WSACreateEvent())
+        .WillByDefault(Return(UniqueEvent()));
+    ON_CALL(mock_Winsock, socket)
+        .WillByDefault(Return(UniqueSocket()));
+    ON_CALL(mock_Winsock, WSAWaitForMultipleEvents)
+        .WillByDefault(InvokeWithoutArgs([] {
+            Sleep(1);
+            return static_cast<DWORD>(WSA_WAIT_TIMEOUT);
+        }));
+
+    EXPECT_CALL(mock_Winsock, listen(_, SOMAXCONN));
+
+    // Verify behavior when started in the same order as WinMain; the server
+    // listens before returning, so it is listening before the tray icon is
+    // created. Settings are loaded from the registry, then reset to a
+    // numeric address so that listening does not depend on resolution:
+    Startup::Reset();
+    Startup::Init();
+    Settings::Load();
+    Settings::bShowPending = FALSE;
+    wcscpy_s(Settings::szListenAddress, Settings::DEFAULT_LISTEN_ADDRESS);
+    wcscpy_s(Settings::szAccessList, Settings::DEFAULT_ACCESS_LIST);
+    Settings::dwMemoryBudget = Settings::DEFAULT_MEMORY_BUDGET;
+    EXPECT_TRUE(Startup::IsMarked(Startup::Phase::SettingsLoaded));
+
+    Start();
+    EXPECT_TRUE(Startup::IsMarked(Startup::Phase::Listening));
+    EXPECT_FALSE(Startup::IsMarked(Startup::Phase::TrayCreated));
+
+    // The tray icon marks its phase once the notification window is
+    // created, which requires the shell:
+    Startup::Mark(Startup::Phase::TrayCreated);
+    EXPECT_LE(Startup::GetElapsed(Startup::Phase::SettingsLoaded),
+              Startup::GetElapsed(Startup::Phase::Listening));
+    EXPECT_LE(Startup::GetElapsed(Startup::Phase::Listening),
+              Startup::GetElapsed(Startup::Phase::TrayCreated));
+
+    Stop();
+    Startup::Reset();
+}
+
+TEST_F(ServerTest, WaitMemory)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    auto mock_hLowMemory = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    auto mock_hHighMemory = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    ON_CALL(mock_Windows, CreateMemoryResourceNotification(LowMemoryResourceNotification))
+        .WillByDefault(Return(mock_hLowMemory));
+    ON_CALL(mock_Windows, CreateMemoryResourceNotification(HighMemoryResourceNotification))
+        .WillByDefault(Return(mock_hHighMemory));
+    Monitor.Open();
+
+    bStopRequested = FALSE;
+    EXPECT_CALL(mock_Winsock, WSAWaitForMultipleEvents(2, _, _, _, _))
+        .WillOnce(WithArg<1>([&](auto pEvents) {
+            EXPECT_EQ(pEvents[0], mock_hEvent);
+            EXPECT_EQ(pEvents[1], mock_hLowMemory);
+            return WSA_WAIT_EVENT_0 + 1;
+        }))
+        .WillOnce(DoAll(Assign(&bStopRequested, TRUE),
+                        Return(WSA_WAIT_IO_COMPLETION)));
+
+    EXPECT_CALL(mock_Windows, QueryMemoryResourceNotification(mock_hLowMemory, _))
+        .WillOnce(DoAll(SetArgPointee<1>(FALSE), Return(TRUE)));
+    EXPECT_CALL(mock_Winsock, WSAEnumNetworkEvents).Times(0);
+
+    // Verify behavior when the memory monitor is signaled:
+    ThreadProc(nullptr);
+    EXPECT_EQ(Monitor.GetCondition(), MemoryMonitor::Condition::Normal);
+}
+
+TEST_F(ServerTest, CloseLatency)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    auto test_llNow = GetTimestamp();
+    auto& test_Times = States[mock_hEvent].Times;
+    test_Times.llAccepted = test_llNow;
+    test_Times.llFirstByte = test_llNow;
+
+    // Verify behavior when a connection is timed from accept to commit:
+    Buffers[mock_hEvent]++;
+    Close(mock_hEvent);
+    for (auto& test_Histogram : Latencies) {
+        EXPECT_EQ(test_Histogram.Count(), 1);
+    }
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::LatencyTotalP99),
+              Latencies[static_cast<SIZE_T>(Stage::Total)].GetPercentile(99));
+}
+
+TEST_F(ServerTest, CloseLatencyUncommitted)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    // Verify behavior when a connection closes without committing data:
+    Buffers[mock_hEvent];
+    Close(mock_hEvent);
+    for (auto& test_Histogram : Latencies) {
+        EXPECT_EQ(test_Histogram.Count(), 0);
+    }
+}
+
+TEST_F(ServerTest, CloseEvent)
+{
+    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_CLOSE };
+    auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    EXPECT_CALL(mock_Windows, OpenClipboard);
+    EXPECT_CALL(mock_Windows, EmptyClipboard);
+    EXPECT_CALL(mock_Windows, GlobalUnlock(mock_hMem));
+    EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hMem));
+    EXPECT_CALL(mock_Windows, CloseClipboard);
+
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior when an FD_CLOSE network event occurs:
+    Buffers[mock_hEvent]++;
+    ThreadProc(nullptr);
+}
+
+TEST_F(ServerTest, CloseEventError)
+{
+    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_CLOSE };
+    mock_NetworkEvents.iErrorCode[FD_CLOSE_BIT] = WSAENETDOWN;
+    auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
+
+    EXPECT_CALL(mock_Windows, ReportEventA);
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior when an FD_CLOSE network event fails:
+    ThreadProc(nullptr);
+}
+
+TEST_F(ServerTest, CloseEmpty)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+
+    EXPECT_CALL(mock_Windows, OpenClipboard).Times(0);
+    EXPECT_CALL(mock_Windows, EmptyClipboard).Times(0);
+    EXPECT_CALL(mock_Windows, SetClipboardData).Times(0);
+    EXPECT_CALL(mock_Windows, CloseClipboard).Times(0);
+
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior closing with an empty buffer:
+    Close(mock_hEvent);
+}
+
+TEST_F(ServerTest, CloseTransform)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    auto test_Text = "\x1B[1mbold\x1B[0m text  ";
+    SetUpFrame(mock_hEvent, test_Text);
+    dwTransformFlags = Transform::STRIP_ESCAPES | Transform::STRIP_TRAILING_WHITESPACE;
+
+    EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hMem));
+
+    // Verify behavior when closing with transforms enabled:
+    Close(mock_hEvent);
+
+    EXPECT_STREQ(mock_hMem, "bold text");
+    EXPECT_EQ(spSnapshot->sText, test_Text);
+}
+
+TEST_F(ServerTest, CloseTransformEmpty)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    SetUpFrame(mock_hEvent, "\x1B[0m");
+    dwTransformFlags = Transform::STRIP_ESCAPES;
+
+    EXPECT_CALL(mock_Windows, SetClipboardData).Times(0);
+
+    // Verify behavior when closing with transforms that remove all data:
+    Close(mock_hEvent);
+}
+
+TEST_F(ServerTest, CloseWorkers)
+{
+    auto [mock_hFirstEvent, mock_hFirstSocket] = SetUpSocket();
+    auto [mock_hSecondEvent, mock_hSecondSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hFirstMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hSecondMem[MAXIMUM_BUFFER_SIZE+1]{};
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc)
+        .WillOnce(Return(mock_hFirstMem))
+        .WillOnce(Return(mock_hSecondMem));
+    ON_CALL(mock_Windows, GlobalLock)
+        .WillByDefault(ReturnArg<0>());
+
+    SetUpFrame(mock_hFirstEvent, "first");
+    SetUpFrame(mock_hSecondEvent, "second");
+
+    {
+        InSequence s;
+        EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hFirstMem));
+        EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hSecondMem));
+    }
+
+    // Verify behavior when payloads are committed by workers in the order
+    // their connections completed:
+    Workers.Start(2);
+    Close(mock_hFirstEvent);
+    Close(mock_hSecondEvent);
+    Workers.Stop();
+
+    EXPECT_STREQ(mock_hFirstMem, "first");
+    EXPECT_STREQ(mock_hSecondMem, "second");
+    EXPECT_EQ(spSnapshot->sText, "second");
+}
+
+TEST_F(ServerTest, NegotiateRaw)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    EXPECT_CALL(mock_Winsock, send).Times(0);
+
+    // Verify behavior when negotiating a plain text connection:
+    SetUpFrame(mock_hEvent, "plain text");
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    EXPECT_EQ(States[mock_hEvent].Mode, Protocol::Mode::Raw);
+}
+
+TEST_F(ServerTest, NegotiateDelta)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpSnapshot("base text");
+
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, Pointee(Protocol::STATUS_ACCEPTED), 1, _))
+        .WillOnce(Return(1));
+
+    // Verify behavior when the delta base matches the last published text:
+    SetUpFrame(mock_hEvent, Delta::Encode("base text", "base text, edited"));
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    EXPECT_EQ(States[mock_hEvent].Mode, Protocol::Mode::Delta);
+    EXPECT_EQ(States[mock_hEvent].spBase, spSnapshot);
+}
+
+TEST_F(ServerTest, NegotiateDeltaMissingBase)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpSnapshot("other text");
+
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, Pointee(Protocol::STATUS_REJECTED), 1, _))
+        .WillOnce(Return(1));
+
+    // Verify behavior when the delta base is no longer held by the server:
+    SetUpFrame(mock_hEvent, Delta::Encode("base text", "base text, edited"));
+    EXPECT_FALSE(Negotiate(mock_hSocket, mock_hEvent));
+}
+
+TEST_F(ServerTest, NegotiateDeltaPartialHeader)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    EXPECT_CALL(mock_Winsock, send).Times(0);
+
+    // Verify behavior when the delta header has not been fully received:
+    auto test_Frame = Delta::Encode("base text", "base text, edited");
+    SetUpFrame(mock_hEvent, std::string_view{test_Frame}.substr(0, Delta::HEADER_SIZE - 1));
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+}
+
+TEST_F(ServerTest, CloseDelta)
+{
+    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_CLOSE };
+    auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hTargetMem[MAXIMUM_BUFFER_SIZE+1]{};
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc)
+        .WillOnce(Return(mock_hMem))
+        .WillOnce(Return(mock_hTargetMem));
+
+    ON_CALL(mock_Windows, GlobalLock)
+        .WillByDefault(ReturnArg<0>());
+
+    std::string expect_Base(1000, 'x');
+    std::string expect_Text = expect_Base + " appended";
+    SetUpSnapshot(expect_Base);
+    SetUpFrame(mock_hEvent, Delta::Encode(expect_Base, expect_Text));
+    States[mock_hEvent] = {.Mode = Protocol::Mode::Delta, .bNegotiated = TRUE, .spBase = spSnapshot};
+
+    EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hTargetMem));
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, Pointee(Protocol::STATUS_ACCEPTED), 1, _))
+        .WillOnce(Return(1));
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior when an FD_CLOSE network event completes a delta:
+    ThreadProc(nullptr);
+
+    EXPECT_EQ(std::string_view{mock_hTargetMem}, expect_Text);
+    EXPECT_EQ(spSnapshot->sText, expect_Text);
+    EXPECT_FALSE(Sockets.contains(mock_hEvent));
+}
+
+TEST_F(ServerTest, CloseDeltaMismatch)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hTargetMem[MAXIMUM_BUFFER_SIZE+1]{};
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc)
+        .WillOnce(Return(mock_hMem))
+        .WillOnce(Return(mock_hTargetMem));
+
+    ON_CALL(mock_Windows, GlobalLock)
+        .WillByDefault(ReturnArg<0>());
+
+    std::string test_Base(1000, 'x');
+    SetUpSnapshot(test_Base);
+    auto test_Frame = Delta::Encode(test_Base, test_Base + " appended");
+    test_Frame[Protocol::FRAME_PREFIX_SIZE + sizeof(UINT64)] ^= 1;
+    SetUpFrame(mock_hEvent, test_Frame);
+    States[mock_hEvent] = {.Mode = Protocol::Mode::Delta, .bNegotiated = TRUE, .spBase = spSnapshot};
+
+    EXPECT_CALL(mock_Windows, SetClipboardData).Times(0);
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, Pointee(Protocol::STATUS_REJECTED), 1, _))
+        .WillOnce(Return(1));
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior when the reconstructed text does not match the
+    // target hash:
+    Close(mock_hEvent);
+    EXPECT_EQ(spSnapshot->sText, test_Base);
+}
+
+TEST_F(ServerTest, DecodeOsc52)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    // Verify behavior when an OSC 52 sequence is decoded as chunks arrive:
+    SetUpFrame(mock_hEvent, "\x1B]52;c;aGVsbG8s");
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    Decode(mock_hEvent);
+    EXPECT_EQ(States[mock_hEvent].Mode, Protocol::Mode::Osc52);
+    EXPECT_EQ(Buffers[mock_hEvent].Size(), 6);
+
+    SetUpFrame(mock_hEvent, "IHdvcmxk\x07");
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    Decode(mock_hEvent);
+    EXPECT_TRUE(States[mock_hEvent].Decoder.IsComplete());
+
+    EXPECT_STREQ(mock_hMem, "hello, world");
+}
+
+TEST_F(ServerTest, ReadEventOsc52)
+{
+    WSANETWORKEVENTS mock_NetworkEvents{ .lNetworkEvents = FD_READ };
+    auto [mock_hEvent, mock_hSocket] = SetUpNetworkEvent(mock_NetworkEvents);
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    std::string_view test_Sequence = "\x1B]52;c;aGVsbG8sIHdvcmxk\x1B\\";
+    EXPECT_CALL(mock_Winsock, recv(mock_hSocket, mock_hMem, MAXIMUM_BUFFER_SIZE, _))
+        .WillOnce(DoAll(SetArrayArgument<1>(test_Sequence.begin(), test_Sequence.end()),
+                        Return(static_cast<int>(test_Sequence.size()))));
+
+    EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hMem));
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior when an FD_READ network event completes an OSC 52 sequence:
+    ThreadProc(nullptr);
+
+    EXPECT_STREQ(mock_hMem, "hello, world");
+    EXPECT_EQ(spSnapshot->sText, "hello, world");
+}
+
+TEST_F(ServerTest, NegotiateResume)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hTransferMem[1024+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpFrame(mock_hEvent, MakeResumeFrame(42, 1024));
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc(_, sizeof(mock_hTransferMem)))
+        .WillOnce(Return(mock_hTransferMem));
+
+    ON_CALL(mock_Windows, GlobalLock(mock_hTransferMem))
+        .WillByDefault(Return(mock_hTransferMem));
+
+    std::string expect_Status{Protocol::STATUS_ACCEPTED};
+    Protocol::PutUInt64(expect_Status, 0);
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, _, 9, _))
+        .WillOnce(DoAll(WithArgs<1, 2>([&](const char* buf, int len) {
+                            EXPECT_EQ(std::string_view(buf, len), expect_Status);
+                        }),
+                        Return(9)));
+
+    // Verify behavior when a new resumable transfer is negotiated:
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    EXPECT_EQ(States[mock_hEvent].ullTransferId, 42);
+    EXPECT_EQ(&Buffers[mock_hEvent], mock_hTransferMem);
+    EXPECT_EQ(Buffers[mock_hEvent].Length(), 1024);
+}
+
+TEST_F(ServerTest, NegotiateResumeWaits)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hTransferMem[1024+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpFrame(mock_hEvent, MakeResumeFrame(42, 1024));
+    Budget.SetLimit(1024);
+    Budget.TryReserve(0, 1);
+
+    ON_CALL(mock_Windows, GlobalAlloc(_, sizeof(mock_hTransferMem)))
+        .WillByDefault(Return(mock_hTransferMem));
+
+    ON_CALL(mock_Windows, GlobalLock(mock_hTransferMem))
+        .WillByDefault(Return(mock_hTransferMem));
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket, mock_hEvent, 0))
+        .WillOnce(Return(0));
+    EXPECT_CALL(mock_Winsock, send).Times(0);
+
+    // Verify behavior when a transfer waits for memory:
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    EXPECT_FALSE(States[mock_hEvent].bNegotiated);
+    EXPECT_THAT(Waiters, ElementsAre(mock_hEvent));
+    Mock::VerifyAndClearExpectations(&mock_Winsock);
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect(mock_hSocket, mock_hEvent, Ne(0)))
+        .WillOnce(Return(0));
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, _, 9, _))
+        .WillOnce(Return(9));
+
+    // Verify behavior when the transfer is negotiated once memory is
+    // released:
+    Budget.Release(1);
+    ResumeWaiters();
+    EXPECT_TRUE(States[mock_hEvent].bNegotiated);
+    EXPECT_EQ(States[mock_hEvent].cbCharged, 1024);
+    EXPECT_EQ(&Buffers[mock_hEvent], mock_hTransferMem);
+}
+
+TEST_F(ServerTest, NegotiateResumeParked)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hTransferMem[1024+1]{};
+    SetUpBuffer(mock_hMem);
+
+    SetUpFrame(mock_hEvent, MakeResumeFrame(42, 1024));
+
+    ON_CALL(mock_Windows, GlobalLock(mock_hTransferMem))
+        .WillByDefault(Return(mock_hTransferMem));
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc(_, sizeof(mock_hTransferMem)))
+        .WillOnce(Return(mock_hTransferMem));
+
+    EventBuffer test_Parked{1024};
+    test_Parked += 800;
+    Transfers.Insert(42, {std::nullopt, std::move(test_Parked)}, 1024, GetTickCount64());
+
+    std::string expect_Status{Protocol::STATUS_ACCEPTED};
+    Protocol::PutUInt64(expect_Status, 800);
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, _, 9, _))
+        .WillOnce(DoAll(WithArgs<1, 2>([&](const char* buf, int len) {
+                            EXPECT_EQ(std::string_view(buf, len), expect_Status);
+                        }),
+                        Return(9)));
+
+    // Verify behavior when a parked transfer is resumed:
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    EXPECT_EQ(Transfers.Count(), 0);
+    EXPECT_EQ(Buffers[mock_hEvent].Size(), 800);
+    EXPECT_EQ(&Buffers[mock_hEvent], mock_hTransferMem + 800);
+}
+
+TEST_F(ServerTest, NegotiateResumeParkedBudget)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hTransferMem[1024+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpFrame(mock_hEvent, MakeResumeFrame(42, 1024));
+
+    ON_CALL(mock_Windows, GlobalLock(mock_hTransferMem))
+        .WillByDefault(Return(mock_hTransferMem));
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc(_, sizeof(mock_hTransferMem)))
+        .WillOnce(Return(mock_hTransferMem));
+
+    Budget.SetLimit(1024);
+    EventBuffer test_Parked{1024};
+    test_Parked += 800;
+    Transfers.Insert(42, {std::nullopt, std::move(test_Parked)}, 1024, GetTickCount64());
+    ChargeParked();
+
+    EXPECT_CALL(mock_Winsock, WSAEventSelect).Times(0);
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, _, 9, _))
+        .WillOnce(Return(9));
+
+    // Verify behavior when a parked transfer is resumed while it fills the
+    // memory budget:
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    EXPECT_TRUE(States[mock_hEvent].bNegotiated);
+    EXPECT_EQ(Transfers.Count(), 0);
+    EXPECT_EQ(Buffers[mock_hEvent].Size(), 800);
+    EXPECT_EQ(Budget.Reserved(), 1024);
+}
+
+TEST_F(ServerTest, NegotiateResumeOtherPeer)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    EventBuffer::ValueType mock_hTransferMem[1024+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpPeer(mock_hEvent);
+    SetUpFrame(mock_hEvent, MakeResumeFrame(42, 1024));
+
+    ON_CALL(mock_Windows, GlobalLock(mock_hTransferMem))
+        .WillByDefault(Return(mock_hTransferMem));
+
+    EXPECT_CALL(mock_Windows, GlobalAlloc(_, sizeof(mock_hTransferMem)))
+        .WillOnce(Return(mock_hTransferMem));
+
+    EventBuffer test_Parked{1024};
+    test_Parked += 800;
+    Transfers.Insert(42, {std::nullopt, std::move(test_Parked)}, 1024, GetTickCount64());
+
+    std::string expect_Status{Protocol::STATUS_ACCEPTED};
+    Protocol::PutUInt64(expect_Status, 0);
+    EXPECT_CALL(mock_Winsock, send(mock_hSocket, _, 9, _))
+        .WillOnce(DoAll(WithArgs<1, 2>([&](const char* buf, int len) {
+                            EXPECT_EQ(std::string_view(buf, len), expect_Status);
+                        }),
+                        Return(9)));
+
+    // Verify behavior when a transfer was parked by another peer:
+    EXPECT_TRUE(Negotiate(mock_hSocket, mock_hEvent));
+    EXPECT_TRUE(Transfers.Contains(42));
+    EXPECT_EQ(Buffers[mock_hEvent].Size(), 0);
+    EXPECT_EQ(&Buffers[mock_hEvent], mock_hTransferMem);
+}
+
+TEST_F(ServerTest, NegotiateResumeTooLarge)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+    SetUpFrame(mock_hEvent, MakeResumeFrame(42, MAXIMUM_TRANSFER_SIZE + 1));
+
+    EXPECT_CALL(mock_Winsock, send).Times(0);
+
+    // Verify behavior when a transfer exceeds the maximum size:
+    EXPECT_THROW(Negotiate(mock_hSocket, mock_hEvent), std::runtime_error);
+}
+
+TEST_F(ServerTest, CleanupParksTransfer)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    EXPECT_CALL(mock_Winsock, closesocket(mock_hSocket));
+    EXPECT_CALL(mock_Winsock, WSACloseEvent(mock_hEvent));
+
+    // Verify behavior when a partial resumable transfer is cleaned up:
+    Buffers[mock_hEvent] += 100;
+    States[mock_hEvent] = {.Mode = Protocol::Mode::Resume, .bNegotiated = TRUE, .ullTransferId = 42};
+    CleanupEvent(mock_hEvent);
+
+    EXPECT_FALSE(Buffers.contains(mock_hEvent));
+    EXPECT_TRUE(Transfers.Contains(42));
+    EXPECT_EQ(Transfers.Bytes(), MAXIMUM_BUFFER_SIZE);
+    EXPECT_EQ(Budget.Reserved(), MAXIMUM_BUFFER_SIZE);
+}
+
+TEST_F(ServerTest, ChargeTrimsParked)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    Budget.SetLimit(2048);
+    Transfers.Insert(42, {}, 1024, GetTickCount64());
+    Transfers.Insert(43, {}, 1024, GetTickCount64());
+    ChargeParked();
+
+    // Verify behavior when parked transfers must be evicted to charge a
+    // connection:
+    EXPECT_TRUE(Charge(mock_hEvent, 1024));
+    EXPECT_FALSE(Transfers.Contains(42));
+    EXPECT_TRUE(Transfers.Contains(43));
+    EXPECT_EQ(Budget.Reserved(), 2048);
+}
+
+TEST_F(ServerTest, CloseResumeIncomplete)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    EXPECT_CALL(mock_Windows, SetClipboardData).Times(0);
+
+    // Verify behavior when a resumable transfer closes before completion:
+    Buffers[mock_hEvent] += 100;
+    States[mock_hEvent] = {.Mode = Protocol::Mode::Resume, .bNegotiated = TRUE, .ullTransferId = 42};
+    Close(mock_hEvent);
+
+    EXPECT_TRUE(Transfers.Contains(42));
+}
+
+TEST_F(ServerTest, CloseResumeComplete)
+{
+    auto [mock_hEvent, mock_hSocket] = SetUpSocket();
+    EventBuffer::ValueType mock_hMem[MAXIMUM_BUFFER_SIZE+1]{};
+    SetUpBuffer(mock_hMem);
+
+    EXPECT_CALL(mock_Windows, SetClipboardData(_, mock_hMem));
+
+    // Verify behavior when a resumable transfer closes after completion:
+    Buffers[mock_hEvent] += MAXIMUM_BUFFER_SIZE;
+    States[mock_hEvent] = {.Mode = Protocol::Mode::Resume, .bNegotiated = TRUE, .ullTransferId = 42};
+    Close(mock_hEvent);
+
+    EXPECT_FALSE(Transfers.Contains(42));
 }
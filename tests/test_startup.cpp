@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "metrics.h"
+#include "startup.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ClipSock;
+using namespace testing;
+
+class StartupTest : public Test {
+protected:
+    void SetUp() override
+    {
+        Startup::Reset();
+    }
+
+    void TearDown() override
+    {
+        Startup::Reset();
+    }
+};
+
+TEST_F(StartupTest, Empty)
+{
+    // Verify behavior when no phases have been reached:
+    for (SIZE_T i = 0; i < Startup::PHASE_COUNT; i++) {
+        EXPECT_FALSE(Startup::IsMarked(static_cast<Startup::Phase>(i)));
+        EXPECT_EQ(Startup::GetElapsed(static_cast<Startup::Phase>(i)), 0);
+    }
+    EXPECT_EQ(Startup::Format(), "");
+}
+
+TEST_F(StartupTest, Init)
+{
+    // Verify behavior when process start is taken from the creation time,
+    // which precedes initialization:
+    auto llBefore = GetTimestamp();
+    Startup::Init();
+    auto llAfter = GetTimestamp();
+    Startup::Mark(Startup::Phase::SettingsLoaded, llAfter);
+    EXPECT_TRUE(Startup::IsMarked(Startup::Phase::ProcessStart));
+    EXPECT_GE(Startup::GetElapsed(Startup::Phase::SettingsLoaded), GetElapsedMicroseconds(llBefore, llAfter));
+}
+
+TEST_F(StartupTest, Format)
+{
+    // Verify behavior when every phase is reached:
+    Startup::Init();
+    Startup::Mark(Startup::Phase::SettingsLoaded);
+    Startup::Mark(Startup::Phase::Listening);
+    Startup::Mark(Startup::Phase::TrayCreated);
+    Startup::Mark(Startup::Phase::FirstAccept);
+
+    auto ullListening = Startup::GetElapsed(Startup::Phase::Listening);
+    EXPECT_EQ(Metrics::Get(Metrics::Metric::StartupListening), static_cast<LONGLONG>(ullListening));
+    EXPECT_THAT(Startup::Format(), StartsWith("settings loaded "));
+    EXPECT_THAT(Startup::Format(), HasSubstr(", first accept "));
+}
+
+TEST_F(StartupTest, MarkOnce)
+{
+    // Verify behavior when a phase is reached more than once:
+    Startup::Mark(Startup::Phase::ProcessStart, 1000);
+    EXPECT_TRUE(Startup::Mark(Startup::Phase::Listening, 2000));
+    EXPECT_FALSE(Startup::Mark(Startup::Phase::Listening, 3000));
+    EXPECT_EQ(Startup::GetElapsed(Startup::Phase::Listening),
+              GetElapsedMicroseconds(1000, 2000));
+}
+
+TEST_F(StartupTest, Unreached)
+{
+    // Verify behavior when phases are omitted from the timeline:
+    Startup::Mark(Startup::Phase::ProcessStart, 1000);
+    Startup::Mark(Startup::Phase::Listening, 2000);
+    EXPECT_EQ(Startup::GetElapsed(Startup::Phase::TrayCreated), 0);
+    EXPECT_THAT(Startup::Format(), Not(HasSubstr("tray created")));
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "timer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+using namespace ClipSock;
+using namespace testing;
+
+class TimerTest : public Test {
+protected:
+    static constexpr auto TEST_RESOLUTION = 100;
+    static constexpr auto TEST_START = 1'000'000'000ull;
+
+    TimerWheel<int> test_Timers{TEST_RESOLUTION};
+};
+
+TEST_F(TimerTest, Schedule)
+{
+    // Verify behavior when scheduling a single timer:
+    test_Timers.Schedule(1, TEST_START + 250, TEST_START);
+    EXPECT_TRUE(test_Timers.Contains(1));
+    EXPECT_THAT(test_Timers.Advance(TEST_START + 200), IsEmpty());
+    EXPECT_THAT(test_Timers.Advance(TEST_START + 299), IsEmpty());
+    EXPECT_THAT(test_Timers.Advance(TEST_START + 300), ElementsAre(1));
+    EXPECT_FALSE(test_Timers.Contains(1));
+    EXPECT_EQ(test_Timers.Count(), 0);
+}
+
+TEST_F(TimerTest, ScheduleElapsed)
+{
+    // Verify behavior when scheduling a deadline that has already passed:
+    test_Timers.Schedule(1, TEST_START, TEST_START);
+    test_Timers.Advance(TEST_START + 1000);
+    test_Timers.Schedule(2, TEST_START, TEST_START + 1000);
+    EXPECT_THAT(test_Timers.Advance(TEST_START + 1100), ElementsAre(2));
+}
+
+TEST_F(TimerTest, Reschedule)
+{
+    // Verify behavior when rescheduling an existing timer:
+    test_Timers.Schedule(1, TEST_START + 1000, TEST_START);
+    test_Timers.Schedule(1, TEST_START + 100'000, TEST_START);
+    EXPECT_EQ(test_Timers.Count(), 1);
+    EXPECT_THAT(test_Timers.Advance(TEST_START + 99'900), IsEmpty());
+    EXPECT_THAT(test_Timers.Advance(TEST_START + 100'000), ElementsAre(1));
+}
+
+TEST_F(TimerTest, Cancel)
+{
+    // Verify behavior when cancelling timers:
+    test_Timers.Schedule(1, TEST_START + 1000, TEST_START);
+    test_Timers.Schedule(2, TEST_START + 1000, TEST_START);
+    test_Timers.Cancel(1);
+    test_Timers.Cancel(3);
+    EXPECT_THAT(test_Timers.Advance(TEST_START + 1000), ElementsAre(2));
+}
+
+TEST_F(TimerTest, GetTimeout)
+{
+    // Verify behavior when deriving wait timeouts:
+    EXPECT_EQ(test_Timers.GetTimeout(TEST_START), INFINITE);
+
+    test_Timers.Schedule(1, TEST_START + 500, TEST_START);
+    EXPECT_EQ(test_Timers.GetTimeout(TEST_START), 500);
+    EXPECT_EQ(test_Timers.GetTimeout(TEST_START + 600), 0);
+
+    // Coarser levels require advancing at boundaries of the finest level:
+    test_Timers.Cancel(1);
+    test_Timers.Schedule(1, TEST_START + 3'600'000, TEST_START);
+    EXPECT_LE(test_Timers.GetTimeout(TEST_START), TEST_RESOLUTION * TimerWheel<int>::SLOT_COUNT);
+}
+
+TEST_F(TimerTest, Clamp)
+{
+    // Verify behavior when scheduling beyond the range of the wheel:
+    auto ullMaximum = TimerWheel<int>::MAXIMUM_TICKS * TEST_RESOLUTION;
+    test_Timers.Schedule(1, TEST_START + ullMaximum * 2, TEST_START);
+    EXPECT_THAT(test_Timers.Advance(TEST_START + ullMaximum - TEST_RESOLUTION), IsEmpty());
+    EXPECT_THAT(test_Timers.Advance(TEST_START + ullMaximum), ElementsAre(1));
+}
+
+TEST_F(TimerTest, Random)
+{
+    std::mt19937_64 test_Random{42};
+    std::uniform_int_distribution<ULONGLONG> test_Deadline{0, 10'000'000};
+    std::uniform_int_distribution<ULONGLONG> test_Step{1, 50'000};
+
+    std::map<int, ULONGLONG> expect_Deadlines;
+    for (auto i = 0; i < 1000; i++) {
+        auto ullDeadline = TEST_START + test_Deadline(test_Random);
+        test_Timers.Schedule(i, ullDeadline, TEST_START);
+        expect_Deadlines[i] = ullDeadline;
+    }
+
+    // Verify behavior when timers expire across all levels of the wheel:
+    auto ullNow = TEST_START;
+    while (!expect_Deadlines.empty()) {
+        ullNow += test_Step(test_Random);
+        auto Expired = test_Timers.Advance(ullNow);
+        for (auto Key : Expired) {
+            ASSERT_TRUE(expect_Deadlines.contains(Key));
+            EXPECT_LE(expect_Deadlines[Key], ullNow);
+            expect_Deadlines.erase(Key);
+        }
+        for (const auto& [Key, ullDeadline] : expect_Deadlines) {
+            ASSERT_GT(ullDeadline, ullNow - ullNow % TEST_RESOLUTION) << "Key = " << Key;
+        }
+    }
+    EXPECT_EQ(test_Timers.Count(), 0);
+}
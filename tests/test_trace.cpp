@@ -0,0 +1,116 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "trace.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace ClipSock;
+using namespace testing;
+
+class TraceTest : public Test {
+protected:
+    static constexpr auto TEST_CAPACITY = 4;
+
+    void TearDown() override
+    {
+        Trace::EventRing.Clear();
+    }
+
+    Trace::Ring<TEST_CAPACITY> test_Ring;
+};
+
+TEST_F(TraceTest, Empty)
+{
+    // Verify behavior when no events have been recorded:
+    EXPECT_THAT(test_Ring.Snapshot(), IsEmpty());
+}
+
+TEST_F(TraceTest, Record)
+{
+    // Verify behavior when events are recorded:
+    test_Ring.Record({"First", 1, 2, 100});
+    test_Ring.Record({"Second", 3, 4, 100});
+
+    auto test_Events = test_Ring.Snapshot();
+    ASSERT_THAT(test_Events, SizeIs(2));
+    EXPECT_STREQ(test_Events[0].szName, "First");
+    EXPECT_EQ(test_Events[0].llStart, 1);
+    EXPECT_EQ(test_Events[0].llEnd, 2);
+    EXPECT_EQ(test_Events[0].dwThreadId, 100);
+    EXPECT_STREQ(test_Events[1].szName, "Second");
+}
+
+TEST_F(TraceTest, Wrap)
+{
+    // Verify behavior when the ring wraps around:
+    for (LONGLONG i = 0; i < TEST_CAPACITY + 2; i++) {
+        test_Ring.Record({"Zone", i, i + 1, 0});
+    }
+
+    auto test_Events = test_Ring.Snapshot();
+    ASSERT_THAT(test_Events, SizeIs(TEST_CAPACITY));
+    EXPECT_EQ(test_Events.front().llStart, 2);
+    EXPECT_EQ(test_Events.back().llStart, TEST_CAPACITY + 1);
+
+    test_Ring.Clear();
+    EXPECT_THAT(test_Ring.Snapshot(), IsEmpty());
+}
+
+TEST_F(TraceTest, Zone)
+{
+    // Verify behavior when a zone goes out of scope:
+    {
+        Trace::Zone test_Zone{"Scope"};
+    }
+
+    auto test_Events = Trace::EventRing.Snapshot();
+    ASSERT_THAT(test_Events, SizeIs(1));
+    EXPECT_STREQ(test_Events[0].szName, "Scope");
+    EXPECT_LE(test_Events[0].llStart, test_Events[0].llEnd);
+    EXPECT_EQ(test_Events[0].dwThreadId, GetCurrentThreadId());
+}
+
+TEST_F(TraceTest, Format)
+{
+    LARGE_INTEGER test_Frequency;
+    QueryPerformanceFrequency(&test_Frequency);
+    std::vector<Trace::Event> test_Events{
+        {"Accept", test_Frequency.QuadPart, test_Frequency.QuadPart * 2, 7},
+        {"Read", 0, 0, 7}
+    };
+
+    // Verify behavior when events are formatted as a Chrome trace:
+    EXPECT_EQ(Trace::Format(test_Events, 42),
+              "{\"traceEvents\":["
+              "{\"name\":\"Accept\",\"ph\":\"X\",\"ts\":1000000,\"dur\":1000000,\"pid\":42,\"tid\":7},"
+              "{\"name\":\"Read\",\"ph\":\"X\",\"ts\":0,\"dur\":0,\"pid\":42,\"tid\":7}"
+              "],\"displayTimeUnit\":\"ms\"}");
+    EXPECT_EQ(Trace::Format({}, 42), "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+}
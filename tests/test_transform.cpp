@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "simd.h"
+#include "transform.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+using namespace ClipSock;
+using namespace testing;
+
+class TransformTest : public Test {
+protected:
+    std::string Apply(DWORD dwFlags, std::string sData)
+    {
+        sData.resize(Transform::Apply(dwFlags, sData.data(), sData.size()));
+        return sData;
+    }
+
+    std::string StripEscapes(std::string sData)
+    {
+        return Apply(Transform::STRIP_ESCAPES, std::move(sData));
+    }
+
+    std::string StripTrailingWhitespace(std::string sData)
+    {
+        return Apply(Transform::STRIP_TRAILING_WHITESPACE, std::move(sData));
+    }
+};
+
+TEST_F(TransformTest, FindEscape)
+{
+    // Verify behavior when locating an escape at each offset:
+    for (size_t i = 0; i <= 100; i++) {
+        std::string test_data(100, 'x');
+        if (i < test_data.size()) {
+            test_data[i] = Transform::ESC;
+        }
+        EXPECT_EQ(Transform::FindEscapeScalar(test_data.data(), test_data.size()), i);
+        if (Simd::HasSSE2()) {
+            EXPECT_EQ(Transform::FindEscapeSSE2(test_data.data(), test_data.size()), i);
+        }
+    }
+}
+
+TEST_F(TransformTest, StripCSI)
+{
+    // Verify behavior when stripping control sequences:
+    EXPECT_EQ(StripEscapes("\x1B[1;31mred\x1B[0m text"), "red text");
+    EXPECT_EQ(StripEscapes("\x1B[?25hcursor"), "cursor");
+    EXPECT_EQ(StripEscapes("\x1B[2 qsteady"), "steady");
+    EXPECT_EQ(StripEscapes("plain text"), "plain text");
+}
+
+TEST_F(TransformTest, StripOSC)
+{
+    // Verify behavior when stripping control strings:
+    EXPECT_EQ(StripEscapes("\x1B]0;title\x07text"), "text");
+    EXPECT_EQ(StripEscapes("\x1B]8;;https://example.com\x1B\\link\x1B]8;;\x1B\\"), "link");
+    EXPECT_EQ(StripEscapes("\x1BPdata\x1B\\text"), "text");
+}
+
+TEST_F(TransformTest, StripOther)
+{
+    // Verify behavior when stripping other escape sequences:
+    EXPECT_EQ(StripEscapes("\x1B(Bcharset"), "charset");
+    EXPECT_EQ(StripEscapes("\x1B" "7saved\x1B" "8"), "saved");
+    EXPECT_EQ(StripEscapes("lone\x1B\n"), "lone\n");
+}
+
+TEST_F(TransformTest, StripTruncated)
+{
+    // Verify behavior when stripping truncated sequences:
+    EXPECT_EQ(StripEscapes("text\x1B"), "text");
+    EXPECT_EQ(StripEscapes("text\x1B[1;3"), "text");
+    EXPECT_EQ(StripEscapes("text\x1B]0;unterminated"), "text");
+    EXPECT_EQ(StripEscapes("\x1B]0;nested\x1B[31mred"), "red");
+}
+
+TEST_F(TransformTest, StripTrailingWhitespace)
+{
+    // Verify behavior when stripping trailing whitespace:
+    EXPECT_EQ(StripTrailingWhitespace("a b  \nc\t\r\n  d  "), "a b\nc\r\n  d");
+    EXPECT_EQ(StripTrailingWhitespace("   "), "");
+    EXPECT_EQ(StripTrailingWhitespace("no change"), "no change");
+}
+
+TEST_F(TransformTest, Apply)
+{
+    // Verify behavior when applying multiple transforms:
+    auto test_data = "\x1B[32mok\x1B[0m   \n";
+    EXPECT_EQ(Apply(0, test_data), test_data);
+    EXPECT_EQ(Apply(Transform::STRIP_ESCAPES, test_data), "ok   \n");
+    EXPECT_EQ(Apply(Transform::STRIP_ESCAPES | Transform::STRIP_TRAILING_WHITESPACE, test_data), "ok\n");
+}
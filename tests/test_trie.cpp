@@ -0,0 +1,174 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "peer.h"
+#include "trie.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+using namespace ClipSock;
+using namespace testing;
+
+class PrefixTrieTest : public Test {
+protected:
+    static Peer::Address MakeAddress(std::initializer_list<BYTE> Bytes)
+    {
+        Peer::Address Address{};
+        std::copy(Bytes.begin(), Bytes.end(), Address.begin());
+        return Address;
+    }
+
+    PrefixTrie<int> test_Trie;
+};
+
+TEST_F(PrefixTrieTest, Empty)
+{
+    // Verify behavior when the trie is empty:
+    EXPECT_EQ(test_Trie.Find(MakeAddress({10})), nullptr);
+    EXPECT_EQ(test_Trie.Count(), 0);
+}
+
+TEST_F(PrefixTrieTest, LongestMatch)
+{
+    test_Trie.Insert(MakeAddress({10}), 8, 1);
+    test_Trie.Insert(MakeAddress({10, 1}), 16, 2);
+    test_Trie.Insert(MakeAddress({10, 1, 2, 3}), 32, 3);
+
+    // Verify behavior when prefixes are nested:
+    EXPECT_THAT(test_Trie.Find(MakeAddress({10, 2})), Pointee(1));
+    EXPECT_THAT(test_Trie.Find(MakeAddress({10, 1, 9})), Pointee(2));
+    EXPECT_THAT(test_Trie.Find(MakeAddress({10, 1, 2, 3})), Pointee(3));
+    EXPECT_EQ(test_Trie.Find(MakeAddress({11})), nullptr);
+    EXPECT_EQ(test_Trie.Count(), 3);
+}
+
+TEST_F(PrefixTrieTest, Split)
+{
+    test_Trie.Insert(MakeAddress({10, 1, 2, 3}), 32, 1);
+    test_Trie.Insert(MakeAddress({10, 1, 3}), 24, 2);
+    test_Trie.Insert(MakeAddress({10}), 8, 3);
+
+    // Verify behavior when inserting prefixes that diverge from or cover an
+    // existing node:
+    EXPECT_THAT(test_Trie.Find(MakeAddress({10, 1, 2, 3})), Pointee(1));
+    EXPECT_THAT(test_Trie.Find(MakeAddress({10, 1, 3, 7})), Pointee(2));
+    EXPECT_THAT(test_Trie.Find(MakeAddress({10, 1, 2, 4})), Pointee(3));
+    EXPECT_EQ(test_Trie.Count(), 3);
+}
+
+TEST_F(PrefixTrieTest, Replace)
+{
+    test_Trie.Insert(MakeAddress({10}), 8, 1);
+    test_Trie.Insert(MakeAddress({10, 99}), 8, 2);
+
+    // Verify behavior when inserting an existing prefix:
+    EXPECT_THAT(test_Trie.Find(MakeAddress({10})), Pointee(2));
+    EXPECT_EQ(test_Trie.Count(), 1);
+}
+
+TEST_F(PrefixTrieTest, Default)
+{
+    test_Trie.Insert(MakeAddress({}), 0, 1);
+    test_Trie.Insert(MakeAddress({0x80}), 1, 2);
+
+    // Verify behavior when a zero-length prefix is present:
+    EXPECT_THAT(test_Trie.Find(MakeAddress({0x7F})), Pointee(1));
+    EXPECT_THAT(test_Trie.Find(MakeAddress({0xFF})), Pointee(2));
+}
+
+TEST_F(PrefixTrieTest, Clear)
+{
+    test_Trie.Insert(MakeAddress({10}), 8, 1);
+
+    // Verify behavior when the trie is cleared:
+    test_Trie.Clear();
+    EXPECT_EQ(test_Trie.Find(MakeAddress({10})), nullptr);
+    EXPECT_EQ(test_Trie.Count(), 0);
+}
+
+TEST_F(PrefixTrieTest, Random)
+{
+    struct Entry {
+        Peer::Address Prefix;
+        BYTE cBits;
+    };
+
+    std::mt19937 test_Engine{1};
+    std::uniform_int_distribution<int> test_Byte{0, 3};
+    std::uniform_int_distribution<int> test_Bits{0, 24};
+
+    auto RandomAddress = [&] {
+        return MakeAddress({static_cast<BYTE>(test_Byte(test_Engine) << 6),
+                            static_cast<BYTE>(test_Byte(test_Engine) << 6),
+                            static_cast<BYTE>(test_Byte(test_Engine) << 6)});
+    };
+
+    std::vector<Entry> test_Entries;
+    for (auto i = 0; i < 64; ++i) {
+        Entry test_Entry{RandomAddress(), static_cast<BYTE>(test_Bits(test_Engine))};
+        test_Trie.Insert(test_Entry.Prefix, test_Entry.cBits, i);
+        test_Entries.push_back(test_Entry);
+    }
+
+    auto Matches = [](const Entry& test_Entry, const Peer::Address& test_Address) {
+        for (BYTE uBit = 0; uBit < test_Entry.cBits; ++uBit) {
+            auto uMask = 0x80 >> (uBit % 8);
+            if ((test_Entry.Prefix[uBit / 8] & uMask) != (test_Address[uBit / 8] & uMask)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Verify behavior against a linear search for the most recently inserted
+    // longest matching prefix:
+    for (auto i = 0; i < 256; ++i) {
+        auto test_Address = RandomAddress();
+        const Entry* pExpect = nullptr;
+        auto nExpect = -1;
+        for (auto j = 0; j < static_cast<int>(test_Entries.size()); ++j) {
+            auto& test_Entry = test_Entries[j];
+            if (Matches(test_Entry, test_Address) &&
+                (!pExpect || test_Entry.cBits >= pExpect->cBits)) {
+                pExpect = &test_Entry;
+                nExpect = j;
+            }
+        }
+
+        auto pValue = test_Trie.Find(test_Address);
+        if (!pExpect) {
+            EXPECT_EQ(pValue, nullptr);
+        } else {
+            ASSERT_NE(pValue, nullptr);
+            EXPECT_EQ(*pValue, nExpect);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "util.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <windows.h>
+#include <winsock2.h>
+
+using namespace ClipSock;
+using namespace testing;
+
+namespace {
+
+Win32Result<int> TryValue(BOOL bSucceed)
+{
+    SetLastError(WSAECONNRESET);
+    TRY_WIN32(bSucceed);
+    return 42;
+}
+
+Win32Result<> TryCode(DWORD dwResult)
+{
+    TRY_WIN32_RESULT(dwResult);
+    return {};
+}
+
+Win32Result<> TryPropagate(BOOL bSucceed)
+{
+    TRY_RESULT(TryValue(bSucceed));
+    return {};
+}
+
+} // namespace
+
+TEST(UtilTest, TryWin32)
+{
+    // Verify behavior when a call succeeds:
+    auto test_Value = TryValue(TRUE);
+    ASSERT_TRUE(test_Value);
+    EXPECT_EQ(test_Value.Value(), 42);
+
+    // Verify behavior when a call fails:
+    auto test_Error = TryValue(FALSE);
+    ASSERT_FALSE(test_Error);
+    EXPECT_EQ(test_Error.Error(), WSAECONNRESET);
+}
+
+TEST(UtilTest, TryWin32Result)
+{
+    // Verify behavior when an error code is returned:
+    EXPECT_TRUE(TryCode(ERROR_SUCCESS));
+    auto test_Error = TryCode(WSAECONNABORTED);
+    ASSERT_FALSE(test_Error);
+    EXPECT_EQ(test_Error.Error(), WSAECONNABORTED);
+}
+
+TEST(UtilTest, TryResult)
+{
+    // Verify behavior when a result is propagated:
+    EXPECT_TRUE(TryPropagate(TRUE));
+    auto test_Error = TryPropagate(FALSE);
+    ASSERT_FALSE(test_Error);
+    EXPECT_EQ(test_Error.Error(), WSAECONNRESET);
+}
+
+TEST(UtilTest, ErrorSuccess)
+{
+    // Verify behavior when a failed call does not set an error code:
+    Win32Result<> test_Result{Win32Error{ERROR_SUCCESS}};
+    EXPECT_FALSE(test_Result);
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "workers.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace ClipSock;
+using namespace testing;
+
+namespace {
+
+std::atomic<ULONGLONG> test_cProcessed;
+std::atomic<ULONGLONG> test_ullTotal;
+std::vector<ULONGLONG> test_Committed;
+
+void Process(ULONGLONG& ullEntry)
+{
+    test_cProcessed.fetch_add(1, std::memory_order_relaxed);
+    test_ullTotal.fetch_add(ullEntry, std::memory_order_relaxed);
+}
+
+void Record(ULONGLONG& ullEntry)
+{
+    test_Committed.push_back(ullEntry);
+}
+
+Sequencer<ULONGLONG>* test_pSequencer;
+ULONGLONG test_ullNested;
+
+void RecordNested(ULONGLONG& ullEntry)
+{
+    test_Committed.push_back(ullEntry);
+    if (ullEntry == 1) {
+        test_pSequencer->Complete(test_ullNested, 2);
+    }
+}
+
+} // namespace
+
+class WorkerPoolTest : public Test {
+protected:
+    void TearDown() override
+    {
+        test_Pool.Stop();
+        test_cProcessed = 0;
+        test_ullTotal = 0;
+    }
+
+    WorkerPool<ULONGLONG> test_Pool{Process};
+};
+
+TEST_F(WorkerPoolTest, Inline)
+{
+    // Verify behavior when entries are submitted while stopped:
+    test_Pool.Submit(42);
+    EXPECT_FALSE(test_Pool.IsRunning());
+    EXPECT_EQ(test_cProcessed, 1);
+    EXPECT_EQ(test_ullTotal, 42);
+}
+
+TEST_F(WorkerPoolTest, Drain)
+{
+    // Verify behavior when entries outstanding at stop are processed before
+    // the workers exit:
+    constexpr ULONGLONG ENTRIES = 10000;
+
+    test_Pool.Start(4);
+    EXPECT_TRUE(test_Pool.IsRunning());
+    EXPECT_EQ(test_Pool.Workers(), 4);
+    for (ULONGLONG i = 1; i <= ENTRIES; i++) {
+        test_Pool.Submit(ULONGLONG{i});
+    }
+    test_Pool.Stop();
+    EXPECT_FALSE(test_Pool.IsRunning());
+    EXPECT_EQ(test_Pool.Pending(), 0);
+    EXPECT_EQ(test_cProcessed, ENTRIES);
+    EXPECT_EQ(test_ullTotal, ENTRIES * (ENTRIES + 1) / 2);
+}
+
+TEST_F(WorkerPoolTest, Restart)
+{
+    // Verify behavior when the pool is started again after stopping:
+    test_Pool.Start(2);
+    test_Pool.Stop();
+    test_Pool.Start(1);
+    test_Pool.Submit(1);
+    test_Pool.Stop();
+    EXPECT_EQ(test_cProcessed, 1);
+}
+
+TEST_F(WorkerPoolTest, InvalidWorkers)
+{
+    // Verify behavior when no workers are requested:
+    EXPECT_THROW(test_Pool.Start(0), std::runtime_error);
+    EXPECT_FALSE(test_Pool.IsRunning());
+}
+
+class SequencerTest : public Test {
+protected:
+    void TearDown() override
+    {
+        test_Committed.clear();
+    }
+
+    Sequencer<ULONGLONG> test_Sequencer{Record};
+};
+
+TEST_F(SequencerTest, InOrder)
+{
+    // Verify behavior when entries complete in the order they were numbered:
+    for (ULONGLONG i = 0; i < 3; i++) {
+        auto ullSequence = test_Sequencer.Next();
+        test_Sequencer.Complete(ullSequence, ULONGLONG{i});
+        EXPECT_EQ(test_Committed.size(), i + 1);
+    }
+    EXPECT_THAT(test_Committed, ElementsAre(0, 1, 2));
+}
+
+TEST_F(SequencerTest, OutOfOrder)
+{
+    // Verify behavior when later entries complete first; they are held
+    // until every earlier entry has been committed:
+    auto ullFirst = test_Sequencer.Next();
+    auto ullSecond = test_Sequencer.Next();
+    auto ullThird = test_Sequencer.Next();
+
+    test_Sequencer.Complete(ullThird, 3);
+    test_Sequencer.Complete(ullSecond, 2);
+    EXPECT_TRUE(test_Committed.empty());
+    EXPECT_EQ(test_Sequencer.Pending(), 2);
+
+    test_Sequencer.Complete(ullFirst, 1);
+    EXPECT_THAT(test_Committed, ElementsAre(1, 2, 3));
+    EXPECT_EQ(test_Sequencer.Pending(), 0);
+}
+
+TEST_F(SequencerTest, CompleteDuringCommit)
+{
+    // Verify behavior when an entry completes while another is being
+    // committed; the lock is not held during commits, and the committing
+    // thread picks up the entry once the current commit returns:
+    Sequencer<ULONGLONG> test_Nested{RecordNested};
+    test_pSequencer = &test_Nested;
+
+    auto ullFirst = test_Nested.Next();
+    test_ullNested = test_Nested.Next();
+
+    test_Nested.Complete(ullFirst, 1);
+    EXPECT_THAT(test_Committed, ElementsAre(1, 2));
+    EXPECT_EQ(test_Nested.Pending(), 0);
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2024 Steven Stallion
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "metrics.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <format>
+
+using namespace ClipSock;
+
+// Dumps metrics published by a running instance of ClipSock. The mapping is
+// only read, so monitoring never involves the server thread.
+int wmain()
+{
+    auto hMapping = OpenFileMapping(FILE_MAP_READ, FALSE, Metrics::MAPPING_NAME);
+    if (!hMapping) {
+        std::fputs(std::format("ClipSock is not running (error {})\n", GetLastError()).c_str(), stderr);
+        return 1;
+    }
+
+    auto pLayout = static_cast<const Metrics::Layout*>(
+        MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, sizeof(Metrics::Layout)));
+    if (!pLayout) {
+        std::fputs(std::format("Unable to map metrics (error {})\n", GetLastError()).c_str(), stderr);
+        CloseHandle(hMapping);
+        return 1;
+    }
+
+    auto nStatus = 0;
+    auto dwVersion = pLayout->dwVersion.load(std::memory_order_acquire);
+    if (dwVersion != Metrics::LAYOUT_VERSION) {
+        std::fputs(std::format("Unsupported metrics version: {}\n", dwVersion).c_str(), stderr);
+        nStatus = 1;
+    } else {
+        std::fputs(std::format("process_id {}\n", pLayout->dwProcessId).c_str(), stdout);
+        auto cMetrics = std::min<SIZE_T>(pLayout->cMetrics, Metrics::METRIC_COUNT);
+        for (SIZE_T i = 0; i < cMetrics; i++) {
+            auto& Descriptor = Metrics::DESCRIPTORS[i];
+            std::fputs(std::format("{} {} ({})\n", Descriptor.szName,
+                                   pLayout->Slots[i].llValue.load(std::memory_order_relaxed),
+                                   Descriptor.MetricKind == Metrics::Kind::Counter ? "counter" : "gauge").c_str(),
+                       stdout);
+        }
+    }
+
+    UnmapViewOfFile(pLayout);
+    CloseHandle(hMapping);
+    return nStatus;
+}